@@ -6,3 +6,6 @@
 #include "R/Defn.h"
 #include "rcc_prot.h"
 #include "rcc_lib.h"
+#include "rcc_profile.h"
+#include "rcc_region.h"
+#include "rcc_stats.h"
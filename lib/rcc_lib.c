@@ -24,6 +24,7 @@
  */
 
 #include <stdarg.h>
+#include <string.h>
 #include <assert.h>
 
 #include <IOStuff.h>
@@ -171,6 +172,14 @@ Rboolean my_asLogicalNoNA(SEXP s) {
     return cond;
 }
 
+int rcc_relop_cond(SEXP op, SEXP x, SEXP y) {
+  return asLogical(do_relop_dflt(R_NilValue, op, x, y));
+}
+
+void rcc_condition_na(void) {
+  errorcall(R_NilValue, "missing value where logical needed");
+}
+
 /* for a single subscript */
 SEXP rcc_subset_1(SEXP x, SEXP s, SEXP rho) {
 }
@@ -183,6 +192,45 @@ SEXP rcc_subset(SEXP call, SEXP op, SEXP args, SEXP rho) {
   }
 }
 
+Rboolean rcc_is_plain_vector(SEXP x) {
+  return ((TYPEOF(x) == LGLSXP || TYPEOF(x) == INTSXP || TYPEOF(x) == REALSXP) &&
+	  ATTRIB(x) == R_NilValue);
+}
+
+/* The value of sym in frame rho if it is a plain vector, otherwise
+   R_NilValue. Never forces a promise, so it is safe to call before a
+   loop whose body might not evaluate sym at all. */
+SEXP rcc_plain_vector_in_frame(SEXP sym, SEXP rho) {
+  SEXP value = findVarInFrame(rho, sym);
+  if (TYPEOF(value) == PROMSXP) {
+    value = PRVALUE(value);
+  }
+  return (rcc_is_plain_vector(value) ? value : R_NilValue);
+}
+
+/* Store scalar y into element i (zero-based) of x in place, as
+   x[i+1] <- y would, if that needs no copy or coercion. Returns FALSE
+   without doing anything otherwise. */
+Rboolean rcc_set_vector_elt(SEXP x, int i, SEXP y) {
+  if (TYPEOF(x) != TYPEOF(y) || NAMED(x) == 2 || OBJECT(x) ||
+      i < 0 || i >= length(x) || length(y) != 1) {
+    return FALSE;
+  }
+  switch(TYPEOF(x)) {
+  case LGLSXP:
+    LOGICAL(x)[i] = LOGICAL(y)[0];
+    return TRUE;
+  case INTSXP:
+    INTEGER(x)[i] = INTEGER(y)[0];
+    return TRUE;
+  case REALSXP:
+    REAL(x)[i] = REAL(y)[0];
+    return TRUE;
+  default:
+    return FALSE;
+  }
+}
+
 /* rcc_subassign functions                            */
 /* All modified from do_subassign_dflt in subassign.c */
 
@@ -396,6 +444,177 @@ SEXP make_thunked_promise(SEXP value) {
   return promise;
 }
 
+/* The names vectors of the field caches, one slot per site. Holding
+   them here keeps a cached names vector alive, so no other vector
+   can appear at its address while a site's cache refers to it. Names
+   vectors are never modified in place (getAttrib marks them NAMED),
+   so the index found in one stays right. The table doubles when
+   every slot is taken; slots are never shared, since a site whose
+   names vector was dropped could then see a new vector at its
+   address. */
+#define RCC_FIELD_CACHE_SLOTS 16
+static SEXP field_cache_names = NULL;
+static int field_cache_sites = 0;
+
+static int new_field_cache_slot(void) {
+  SEXP table;
+  int i, n;
+  if (field_cache_names == NULL) {
+    field_cache_names = allocVector(VECSXP, RCC_FIELD_CACHE_SLOTS);
+    R_PreserveObject(field_cache_names);
+  } else if (field_cache_sites == LENGTH(field_cache_names)) {
+    n = LENGTH(field_cache_names);
+    table = allocVector(VECSXP, 2 * n);
+    for (i = 0; i < n; i++) {
+      SET_VECTOR_ELT(table, i, VECTOR_ELT(field_cache_names, i));
+    }
+    R_PreserveObject(table);
+    R_ReleaseObject(field_cache_names);
+    field_cache_names = table;
+  }
+  return field_cache_sites++;
+}
+
+SEXP rcc_field(SEXP x, SEXP name, rcc_field_cache * cache) {
+  SEXP names, y;
+  int i, n;
+
+  if (TYPEOF(x) != VECSXP || OBJECT(x)) {
+    return NULL;
+  }
+  names = getAttrib(x, R_NamesSymbol);
+  if (TYPEOF(names) != STRSXP) {
+    return NULL;
+  }
+  if (cache->names != names) {
+    n = LENGTH(names);
+    for (i = 0; i < n; i++) {
+      if (STRING_ELT(names, i) == name ||
+	  strcmp(CHAR(STRING_ELT(names, i)), CHAR(name)) == 0) break;
+    }
+    if (i == n) {
+      return NULL;  /* partial matching is left to do_subset3 */
+    }
+    if (cache->slot < 0) {
+      cache->slot = new_field_cache_slot();
+    }
+    SET_VECTOR_ELT(field_cache_names, cache->slot, names);
+    cache->names = names;
+    cache->index = i;
+  }
+  if (cache->index >= LENGTH(x)) {
+    return NULL;
+  }
+  y = VECTOR_ELT(x, cache->index);
+  /* as R_subset3_dflt does */
+  if (NAMED(x) > NAMED(y)) {
+    SET_NAMED(y, NAMED(x));
+  }
+  return y;
+}
+
+SEXP rcc_subset3(SEXP call, SEXP op, SEXP x, SEXP name, SEXP rho) {
+  SEXP args, ans;
+  /* x is already evaluated, so pass it as a forced promise */
+  PROTECT(args = CONS(ScalarString(name), R_NilValue));
+  PROTECT(args = CONS(make_thunked_promise(x), args));
+  ans = do_subset3(call, op, args, rho);
+  UNPROTECT(2);
+  return ans;
+}
+
 R_varloc_t get_R_location(SEXP arg_c) {
   return (R_varloc_t)arg_c;
 }
+
+/* Reading the constant pool. The format is described in the
+   compiler's ConstantPool.h. */
+
+static int read_pool_int(const unsigned char ** p) {
+  unsigned int u = (*p)[0] | ((*p)[1] << 8) | ((*p)[2] << 16) | ((unsigned int)(*p)[3] << 24);
+  *p += 4;
+  return (int)u;
+}
+
+static SEXP read_pool_string(const unsigned char ** p) {
+  SEXP s;
+  int n = read_pool_int(p);
+  if (n < 0) {
+    return NA_STRING;
+  }
+  s = allocString(n);
+  memcpy(CHAR(s), *p, n);
+  CHAR(s)[n] = '\0';
+  *p += n;
+  return s;
+}
+
+static SEXP read_pool_object(const unsigned char ** p) {
+  SEXP s, cell;
+  int i, n;
+  char code = *(*p)++;
+  switch(code) {
+  case 'N':
+    return R_NilValue;
+  case 'M':
+    return R_MissingArg;
+  case 'S':
+    PROTECT(s = read_pool_string(p));
+    cell = install(CHAR(s));
+    UNPROTECT(1);
+    return cell;
+  case 'L':
+    n = read_pool_int(p);
+    PROTECT(s = allocList(n));
+    for (cell = s; cell != R_NilValue; cell = CDR(cell)) {
+      if (*(*p)++ == 'G') SET_TYPEOF(cell, LANGSXP);
+      SET_TAG(cell, read_pool_object(p));
+      SETCAR(cell, read_pool_object(p));
+    }
+    UNPROTECT(1);
+    return s;
+  case 'B':
+  case 'I':
+    n = read_pool_int(p);
+    s = allocVector(code == 'B' ? LGLSXP : INTSXP, n);
+    for (i = 0; i < n; i++) {
+      INTEGER(s)[i] = read_pool_int(p);
+    }
+    return s;
+  case 'R':
+    n = read_pool_int(p);
+    s = allocVector(REALSXP, n);
+    memcpy(REAL(s), *p, n * sizeof(double));
+    *p += n * sizeof(double);
+    return s;
+  case 'C':
+    n = read_pool_int(p);
+    s = allocVector(CPLXSXP, n);
+    memcpy(COMPLEX(s), *p, n * sizeof(Rcomplex));
+    *p += n * sizeof(Rcomplex);
+    return s;
+  case 'T':
+    n = read_pool_int(p);
+    PROTECT(s = allocVector(STRSXP, n));
+    for (i = 0; i < n; i++) {
+      SET_STRING_ELT(s, i, read_pool_string(p));
+    }
+    UNPROTECT(1);
+    return s;
+  default:
+    error("corrupt constant pool");
+    return R_NilValue;
+  }
+}
+
+SEXP rcc_read_constants(const unsigned char * bytes, int n) {
+  int i;
+  const unsigned char * p = bytes;
+  SEXP pool = PROTECT(allocVector(VECSXP, n));
+  for (i = 0; i < n; i++) {
+    SET_VECTOR_ELT(pool, i, read_pool_object(&p));
+  }
+  R_PreserveObject(pool);
+  UNPROTECT(1);
+  return pool;
+}
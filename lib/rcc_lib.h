@@ -42,6 +42,60 @@ SEXP rcc_subassign_cons(SEXP x, SEXP subs, SEXP y);
 SEXP rcc_subassign_varargs(SEXP x, SEXP y, int nsubs, ...);
 SEXP rcc_promise_args(SEXP args, SEXP rho);
 
+/*  Direct vector access for subscripts of loop indices that the
+    compiler has checked against the loop's range. A plain vector is
+    a logical, integer or real vector without attributes. */
+Rboolean rcc_is_plain_vector(SEXP x);
+SEXP rcc_plain_vector_in_frame(SEXP sym, SEXP rho);
+Rboolean rcc_set_vector_elt(SEXP x, int i, SEXP y);
+
+/*  Conditions compiled to C truth values: TRUE, FALSE or
+    NA_LOGICAL. A comparison of two numeric scalars without
+    attributes is done in C on their values as doubles; any other
+    comparison is done by rcc_relop_cond, which goes through
+    do_relop_dflt and takes the first element of the result.
+    rcc_condition_na is the error for a condition that is NA. */
+#define RCC_IS_SCALAR_NUM(x) \
+  ((TYPEOF(x) == REALSXP || TYPEOF(x) == INTSXP || TYPEOF(x) == LGLSXP) && \
+   LENGTH(x) == 1 && ATTRIB(x) == R_NilValue)
+#define RCC_SCALAR_NUM(x) \
+  (TYPEOF(x) == REALSXP ? REAL(x)[0] : \
+   INTEGER(x)[0] == NA_INTEGER ? NA_REAL : (double)INTEGER(x)[0])
+int rcc_relop_cond(SEXP op, SEXP x, SEXP y);
+void rcc_condition_na(void);
+
+/*  Truth value of an operand of && or ||, and of the condition of an
+    if or while, reading a logical directly. RCC_AS_TRUTH may give
+    NA_LOGICAL; RCC_CONDITION signals an error instead. */
+#define RCC_AS_TRUTH(x) \
+  (TYPEOF(x) == LGLSXP && LENGTH(x) >= 1 ? LOGICAL(x)[0] : asLogical(x))
+#define RCC_CONDITION(x) \
+  (TYPEOF(x) == LGLSXP && LENGTH(x) >= 1 && LOGICAL(x)[0] != NA_LOGICAL ? \
+   LOGICAL(x)[0] : my_asLogicalNoNA(x))
+
+/*  Element i (zero-based) of plain vector x as a new scalar */
+#define RCC_VECTOR_ELT(x, i) \
+  (TYPEOF(x) == REALSXP ? ScalarReal(REAL(x)[i]) : \
+   TYPEOF(x) == INTSXP ? ScalarInteger(INTEGER(x)[i]) : \
+   ScalarLogical(LOGICAL(x)[i]))
+
+/*  Field access x$name with a per-site cache of name's position.
+    rcc_field returns the element of list x named exactly name (a
+    CHARSXP), or NULL if x$name needs the general operator because x
+    is not a plain list or has no such element. The cache holds the
+    last names vector seen at the site and the index found in it;
+    while lists with that same names vector come by, the lookup is
+    one pointer comparison. rcc_subset3 is the general x$name on an
+    already evaluated x. */
+typedef struct rcc_field_cache {
+  int slot;     /* this site's slot in the table keeping names alive */
+  SEXP names;
+  int index;
+} rcc_field_cache;
+#define RCC_FIELD_CACHE_INIT { -1, NULL, 0 }
+SEXP rcc_field(SEXP x, SEXP name, rcc_field_cache * cache);
+SEXP rcc_subset3(SEXP call, SEXP op, SEXP x, SEXP name, SEXP rho);
+
 /*  Given a cons cell arg_c containing an actual argument list, return
     an R_varloc_t representing the location of the argument in its
     environment. Currently this is very easy to do, because the R
@@ -50,6 +104,11 @@ SEXP rcc_promise_args(SEXP args, SEXP rho);
     type. Change this function if the R implementation changes. */
 R_varloc_t get_R_location(SEXP arg_c);
 
+/*  Rebuild the n objects of a constant pool written by the compiler
+    (see ConstantPool.h) into a VECSXP that is preserved for the life
+    of the program. */
+SEXP rcc_read_constants(const unsigned char * bytes, int n);
+
 /*  Make a promise in already-evaluated form. The promise's value is
     the given value; body and environment are null */
 SEXP make_thunked_promise(SEXP value);
@@ -0,0 +1,105 @@
+/*  -*- Mode: C -*-
+ *
+ *  Copyright (c) 2009 Rice University
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+ *  File: rcc_profile.c
+ *
+ *  Registration and output of the profile tables of modules compiled
+ *  with -fprofile.
+ *
+ *  Author: John Garvin (garvin@cs.rice.edu)
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "rcc_profile.h"
+
+#define RCC_PROFILE_DEFAULT_FILE "rcc.prof"
+
+typedef struct rcc_profile_module {
+  const char * name;
+  rcc_profile_entry * table;
+  const char * const * info;
+  int n;
+  struct rcc_profile_module * next;
+} rcc_profile_module;
+
+static rcc_profile_module * modules = NULL;
+
+void rcc_output_file_name(const char * env_var, const char * default_name,
+			  char * buf, size_t size)
+{
+  const char * name = getenv(env_var);
+  const char * pid;
+  if (name == NULL || *name == '\0') {
+    name = default_name;
+  }
+  pid = strstr(name, "%p");
+  if (pid == NULL) {
+    snprintf(buf, size, "%s", name);
+  } else {
+    snprintf(buf, size, "%.*s%ld%s", (int)(pid - name), name, (long)getpid(), pid + 2);
+  }
+}
+
+static void rcc_profile_dump(void) {
+  char file_name[1024];
+  FILE * out;
+  rcc_profile_module * m;
+  int i;
+
+  rcc_output_file_name("RCC_PROFILE_FILE", RCC_PROFILE_DEFAULT_FILE, file_name, sizeof(file_name));
+  out = fopen(file_name, "w");
+  if (out == NULL) {
+    fprintf(stderr, "rcc: could not write profile to %s\n", file_name);
+    return;
+  }
+  fprintf(out, "# rcc profile; ticks are %s\n", RCC_PROFILE_TICK_UNIT);
+  fprintf(out, "# kind\tmodule\tname\tcaller\tcount\tticks\n");
+  for (m = modules; m != NULL; m = m->next) {
+    for (i = 0; i < m->n; i++) {
+      if (m->table[i].count == 0) continue;
+      fprintf(out, "%s\t%s\t%s\t%s\t%lu\t%llu\n",
+	      m->info[3 * i], m->name, m->info[3 * i + 1], m->info[3 * i + 2],
+	      m->table[i].count, m->table[i].ticks);
+    }
+  }
+  fclose(out);
+}
+
+void rcc_profile_register(const char * module, rcc_profile_entry * table,
+			  const char * const * info, int n)
+{
+  rcc_profile_module * m;
+  for (m = modules; m != NULL; m = m->next) {
+    if (m->table == table) return;
+  }
+  m = (rcc_profile_module *)malloc(sizeof(rcc_profile_module));
+  if (m == NULL) return;
+  m->name = module;
+  m->table = table;
+  m->info = info;
+  m->n = n;
+  if (modules == NULL) {
+    atexit(rcc_profile_dump);
+  }
+  m->next = modules;
+  modules = m;
+}
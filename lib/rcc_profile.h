@@ -0,0 +1,88 @@
+/*  -*- Mode: C -*-
+ *
+ *  Copyright (c) 2009 Rice University
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+ *  File: rcc_profile.h
+ *
+ *  Counters and timers for code compiled with -fprofile. Each module
+ *  has a static table with one entry per compiled function (and,
+ *  with -fprofile-sites, per call site and per loop). Generated code
+ *  bumps an entry's count on entry and adds the elapsed ticks on
+ *  exit; the module registers its table in finish() and all tables
+ *  are written out when the process exits.
+ *
+ *  Author: John Garvin (garvin@cs.rice.edu)
+ */
+
+#ifndef RCC_PROFILE_H
+#define RCC_PROFILE_H
+
+#include <stddef.h>
+#include <time.h>
+
+typedef unsigned long long rcc_profile_ticks;
+
+typedef struct rcc_profile_entry {
+  unsigned long count;
+  rcc_profile_ticks ticks;     /* inclusive of everything called */
+} rcc_profile_entry;
+
+/*  Cycle counter where there is a cheap one, otherwise nanoseconds
+    from the monotonic clock. */
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define RCC_PROFILE_TICK_UNIT "cycles"
+static __inline__ rcc_profile_ticks rcc_profile_now(void) {
+  unsigned int lo, hi;
+  __asm__ __volatile__ ("rdtsc" : "=a" (lo), "=d" (hi));
+  return ((rcc_profile_ticks)hi << 32) | lo;
+}
+#else
+#define RCC_PROFILE_TICK_UNIT "ns"
+static rcc_profile_ticks rcc_profile_now(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (rcc_profile_ticks)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+#endif
+
+#define RCC_PROFILE_COUNT(entry) ((entry).count++)
+#define RCC_PROFILE_ADD(entry, start) ((entry).ticks += rcc_profile_now() - (start))
+
+/*  Register a module's table. info holds three strings per entry:
+    its kind ("function", "call" or "loop"), its name, and for a call
+    site the calling function. Registering the same table again (when
+    a library is reloaded) has no effect.
+
+    The profile is written at exit to the file named by the
+    RCC_PROFILE_FILE environment variable ("rcc.prof" by default); a
+    "%p" in the name is replaced by the process ID. Each line is one
+    entry, tab-separated:
+
+      kind  module  name  caller  count  ticks
+
+    Time spent in an activation that is left by an error (a longjmp)
+    is not counted. A library must not be unloaded before exit once
+    its table is registered. */
+void rcc_profile_register(const char * module, rcc_profile_entry * table,
+			  const char * const * info, int n);
+
+/*  The file named by environment variable env_var, or default_name if
+    it is unset, with "%p" replaced by the process ID */
+void rcc_output_file_name(const char * env_var, const char * default_name,
+			  char * buf, size_t size);
+
+#endif
@@ -0,0 +1,231 @@
+/* -*- Mode: C -*-
+ *
+ * Copyright (c) 2008 Rice University
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+
+ * File: rcc_region.c
+ *
+ * Region (arena) allocator for non-escaping objects. See rcc_region.h.
+ *
+ * The arena is a list of chunks, each a preserved VECSXP "anchor"
+ * holding up to RCC_REGION_CHUNK_NODES cons cells. Allocation bumps
+ * a counter in the current chunk and hands out the cell at that
+ * position; releasing a region moves the counter back and clears the
+ * released cells. Cells are made with cons() the first time their
+ * position is reached and are reused from then on, and chunks are
+ * never freed, so a program that reaches a given call depth once
+ * pays for its cells once.
+ *
+ * Every cell is an ordinary heap node that the anchor keeps alive.
+ * The collector sees it like any other node: it ages into the old
+ * generations, and stores into it go through SETCAR, SETCDR and
+ * SET_TAG, whose write barrier records old-to-new references. The
+ * region never touches the collector's lists or counts. Clearing a
+ * released cell drops its references, so its former contents can be
+ * collected. The invariant that makes reuse safe is the one escape
+ * analysis provides: nothing refers to a region cell after its
+ * region is released.
+ *
+ * Author: John Garvin (garvin@cs.rice.edu)
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+
+#include <IOStuff.h>
+#include <Defn.h>
+
+#include "rcc_prot.h"
+#include "rcc_region.h"
+
+#define RCC_REGION_CHUNK_NODES 1024
+#define RCC_REGION_INITIAL_OPEN 64
+
+/* find_stack_dir compares the addresses of locals in two frames, so
+   it must not be inlined into its caller */
+#if defined(__GNUC__)
+#define RCC_NOINLINE __attribute__((noinline))
+#else
+#define RCC_NOINLINE
+#endif
+
+typedef struct rcc_region_chunk {
+  struct rcc_region_chunk * prev;
+  struct rcc_region_chunk * next;
+  int index;                    /* position in the chunk list */
+  int n_used;
+  SEXP anchor;
+} rcc_region_chunk;
+
+/* an activation that has entered a region and not yet left it */
+typedef struct {
+  void * addr;                  /* address of the activation's mark */
+  rcc_region_mark pos;
+} open_region;
+
+static rcc_region_chunk * current_chunk = NULL;
+static open_region * open_regions = NULL;
+static int n_open = 0;
+static int max_open = 0;
+static int stack_dir = 0;       /* -1 if the C stack grows down, 1 if up */
+
+static rcc_region_chunk * new_chunk(rcc_region_chunk * prev) {
+  rcc_region_chunk * c = (rcc_region_chunk *)malloc(sizeof(rcc_region_chunk));
+  if (c == NULL) {
+    error("rcc_region: out of memory");
+  }
+  c->prev = prev;
+  c->next = NULL;
+  c->index = (prev == NULL ? 0 : prev->index + 1);
+  c->n_used = 0;
+  c->anchor = allocVector(VECSXP, RCC_REGION_CHUNK_NODES);
+  R_PreserveObject(c->anchor);
+  if (prev != NULL) prev->next = c;
+  return c;
+}
+
+static int mark_before(rcc_region_mark a, rcc_region_mark b) {
+  if (a.chunk->index != b.chunk->index) return a.chunk->index < b.chunk->index;
+  return a.n_used < b.n_used;
+}
+
+/* clear a released cell so that it holds on to nothing and looks
+   freshly made when it is handed out again */
+static void release_node(rcc_region_chunk * c, int i) {
+  SEXP s = VECTOR_ELT(c->anchor, i);
+  SET_TYPEOF(s, LISTSXP);
+  SETCAR(s, R_NilValue);
+  SETCDR(s, R_NilValue);
+  SET_TAG(s, R_NilValue);
+  SET_ATTRIB(s, R_NilValue);
+  SETLEVELS(s, 0);              /* e.g. MISSING bits set by matchArgs */
+  SET_NAMED(s, 0);
+}
+
+/* release every node allocated after position m */
+static void release_to(rcc_region_mark m) {
+  rcc_region_mark top;
+  if (current_chunk == NULL) return;
+  top.chunk = current_chunk;
+  top.n_used = current_chunk->n_used;
+  if (!mark_before(m, top)) return;
+  while (current_chunk != m.chunk) {
+    while (current_chunk->n_used > 0) {
+      release_node(current_chunk, --current_chunk->n_used);
+    }
+    current_chunk = current_chunk->prev;
+  }
+  while (current_chunk->n_used > m.n_used) {
+    release_node(current_chunk, --current_chunk->n_used);
+  }
+}
+
+static RCC_NOINLINE void find_stack_dir(int * outer) {
+  int inner;
+  stack_dir = (&inner < outer ? -1 : 1);
+}
+
+/* true if an activation whose mark is at address a cannot still be
+   live, given that an activation with its mark at b is starting */
+static int is_dead(void * a, void * b) {
+  return (stack_dir < 0 ? (char *)a <= (char *)b : (char *)a >= (char *)b);
+}
+
+/* The next cell of the arena. May allocate the first time a position
+   is reached, so the caller must protect what it will store. */
+static SEXP alloc_node(void) {
+  SEXP s;
+  if (current_chunk->n_used == RCC_REGION_CHUNK_NODES) {
+    current_chunk = (current_chunk->next != NULL
+		     ? current_chunk->next
+		     : new_chunk(current_chunk));
+  }
+  s = VECTOR_ELT(current_chunk->anchor, current_chunk->n_used);
+  if (s == R_NilValue) {
+    s = cons(R_NilValue, R_NilValue);
+    SET_VECTOR_ELT(current_chunk->anchor, current_chunk->n_used, s);
+  }
+  current_chunk->n_used++;
+  return s;
+}
+
+void rcc_region_enter(rcc_region_mark * m) {
+  if (stack_dir == 0) {
+    int outer;
+    find_stack_dir(&outer);
+  }
+  if (current_chunk == NULL) {
+    current_chunk = new_chunk(NULL);
+  }
+  /* regions of activations that were unwound by a longjmp */
+  while (n_open > 0 && is_dead(open_regions[n_open - 1].addr, m)) {
+    release_to(open_regions[n_open - 1].pos);
+    n_open--;
+  }
+  if (n_open == max_open) {
+    max_open = (max_open == 0 ? RCC_REGION_INITIAL_OPEN : 2 * max_open);
+    open_regions = (open_region *)realloc(open_regions, max_open * sizeof(open_region));
+    if (open_regions == NULL) {
+      error("rcc_region: out of memory");
+    }
+  }
+  m->chunk = current_chunk;
+  m->n_used = current_chunk->n_used;
+  open_regions[n_open].addr = m;
+  open_regions[n_open].pos = *m;
+  n_open++;
+}
+
+void rcc_region_leave(rcc_region_mark * m) {
+  release_to(*m);
+  while (n_open > 0 && open_regions[n_open - 1].addr != m) {
+    n_open--;
+  }
+  if (n_open > 0) n_open--;
+}
+
+rcc_region_mark rcc_region_save(void) {
+  rcc_region_mark m;
+  m.chunk = current_chunk;
+  m.n_used = (current_chunk == NULL ? 0 : current_chunk->n_used);
+  return m;
+}
+
+void rcc_region_restore(rcc_region_mark m) {
+  if (m.chunk != NULL) release_to(m);
+}
+
+SEXP rcc_region_cons(SEXP car, SEXP cdr) {
+  SEXP s;
+  if (n_open == 0) return cons(car, cdr);
+  PROTECT(car);
+  PROTECT(cdr);
+  s = alloc_node();
+  SETCAR(s, car);
+  SETCDR(s, cdr);
+  UNPROTECT(2);
+  return s;
+}
+
+SEXP rcc_region_tagged_cons(SEXP car, SEXP tag, SEXP cdr) {
+  SEXP s;
+  PROTECT(tag);
+  s = rcc_region_cons(car, cdr);
+  SET_TAG(s, tag);
+  UNPROTECT(1);
+  return s;
+}
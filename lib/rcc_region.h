@@ -0,0 +1,60 @@
+/*  -*- Mode: C -*-
+ *
+ *  Copyright (c) 2008 Rice University
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+ *  File: rcc_region.h
+ *
+ *  Region (arena) allocator for objects that escape analysis has
+ *  shown do not outlive the activation that creates them. Cons cells
+ *  come from a bump-pointer arena of recycled heap nodes and are
+ *  released all at once; a cell requested while no region is open
+ *  comes from the ordinary GC heap instead. Compiled code uses it for
+ *  the argument lists of calls to procedures whose environment and
+ *  result do not escape; environments themselves are made by R's
+ *  applyClosure, which takes no allocator.
+ *
+ *  Author: John Garvin (garvin@cs.rice.edu)
+ */
+
+#ifndef RCC_REGION_H
+#define RCC_REGION_H
+
+struct rcc_region_chunk;
+
+/*  A position in the arena. Generated code keeps one of these per
+    activation (rcc_region_enter/rcc_region_leave) and one per call
+    site whose argument list lives in the region
+    (rcc_region_save/rcc_region_restore). */
+typedef struct rcc_region_mark {
+  struct rcc_region_chunk * chunk;
+  int n_used;
+} rcc_region_mark;
+
+/*  Open a region for the current activation. Regions left open by a
+    longjmp out of a deeper activation are released here. */
+void rcc_region_enter(rcc_region_mark * m);
+
+/*  Release everything allocated since the matching rcc_region_enter. */
+void rcc_region_leave(rcc_region_mark * m);
+
+rcc_region_mark rcc_region_save(void);
+void rcc_region_restore(rcc_region_mark m);
+
+SEXP rcc_region_cons(SEXP car, SEXP cdr);
+SEXP rcc_region_tagged_cons(SEXP car, SEXP tag, SEXP cdr);
+
+#endif
@@ -0,0 +1,224 @@
+/*  -*- Mode: C -*-
+ *
+ *  Copyright (c) 2009 Rice University
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+ *  File: rcc_stats.c
+ *
+ *  Counters behind the allocation wrappers used by code compiled with
+ *  -falloc-stats, and their output at exit.
+ *
+ *  Author: John Garvin (garvin@cs.rice.edu)
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <IOStuff.h>
+#include <Defn.h>
+
+#include "rcc_profile.h"
+#include "rcc_stats.h"
+
+#define RCC_STATS_DEFAULT_FILE "rcc_stats.csv"
+#define N_TYPES 32
+#define N_SIZE_CLASSES 7
+#define N_SITES 8192             /* power of two */
+
+static const char * const size_class_names[N_SIZE_CLASSES] = {
+  "0", "<=8", "<=16", "<=32", "<=64", "<=128", "large"
+};
+
+typedef struct site {
+  const char * file;             /* NULL if the slot is free */
+  int line;
+  SEXPTYPE type;
+  unsigned long count;
+} site;
+
+static Rboolean registered = FALSE;
+static unsigned long allocs[N_TYPES][N_SIZE_CLASSES];
+static site sites[N_SITES];
+static unsigned long other_sites;  /* allocations at sites that didn't fit */
+static unsigned long escapes[2];
+static unsigned long fallback_on, fallback_off;
+static unsigned long stack_envs, heap_envs;
+
+static void rcc_stats_dump(void);
+
+static void ensure_registered(void) {
+  if (!registered) {
+    registered = TRUE;
+    atexit(rcc_stats_dump);
+  }
+}
+
+/*  Bytes of data in a vector of the given type and length */
+static size_t data_size(SEXPTYPE type, int length) {
+  switch (type) {
+  case LGLSXP:
+  case INTSXP:
+    return length * sizeof(int);
+  case REALSXP:
+    return length * sizeof(double);
+  case CPLXSXP:
+    return length * sizeof(Rcomplex);
+  case CHARSXP:
+    return length + 1;
+  case STRSXP:
+  case EXPRSXP:
+  case VECSXP:
+    return length * sizeof(SEXP);
+  default:
+    return 0;
+  }
+}
+
+static int size_class(size_t bytes) {
+  int c;
+  size_t limit;
+  if (bytes == 0) return 0;
+  for (c = 1, limit = 8; c < N_SIZE_CLASSES - 1; c++, limit *= 2) {
+    if (bytes <= limit) return c;
+  }
+  return N_SIZE_CLASSES - 1;
+}
+
+static void count_site(SEXPTYPE type, const char * file, int line) {
+  unsigned long h = ((unsigned long)file * 31 + line * 17 + type) & (N_SITES - 1);
+  int probes;
+  for (probes = 0; probes < N_SITES; probes++) {
+    site * s = &sites[(h + probes) & (N_SITES - 1)];
+    if (s->file == NULL) {
+      s->file = file;
+      s->line = line;
+      s->type = type;
+    }
+    if (s->file == file && s->line == line && s->type == type) {
+      s->count++;
+      return;
+    }
+  }
+  other_sites++;
+}
+
+static void count_alloc(SEXPTYPE type, size_t bytes, const char * file, int line) {
+  ensure_registered();
+  allocs[type % N_TYPES][size_class(bytes)]++;
+  count_site(type, file, line);
+}
+
+SEXP rcc_stats_allocVector(SEXPTYPE type, int length, const char * file, int line) {
+  count_alloc(type, data_size(type, length), file, line);
+  return Rf_allocVector(type, length);
+}
+
+SEXP rcc_stats_cons(SEXP car, SEXP cdr, const char * file, int line) {
+  count_alloc(LISTSXP, 0, file, line);
+  return Rf_cons(car, cdr);
+}
+
+SEXP rcc_stats_lcons(SEXP car, SEXP cdr, const char * file, int line) {
+  count_alloc(LANGSXP, 0, file, line);
+  return Rf_lcons(car, cdr);
+}
+
+SEXP rcc_stats_mkPROMISE(SEXP expr, SEXP rho, const char * file, int line) {
+  count_alloc(PROMSXP, 0, file, line);
+  return Rf_mkPROMISE(expr, rho);
+}
+
+void rcc_stats_set_fallback(Rboolean x) {
+  ensure_registered();
+  if (x != getFallbackAlloc()) {
+    if (x) fallback_on++; else fallback_off++;
+  }
+  setFallbackAlloc(x);
+}
+
+void rcc_stats_closure_call(int options) {
+  ensure_registered();
+  if (options & AC_STACK_CLOSURE) {
+    stack_envs++;
+  } else {
+    heap_envs++;
+  }
+}
+
+void rcc_stats_escape(rcc_escape_kind kind) {
+  ensure_registered();
+  escapes[kind]++;
+}
+
+/*  Names of the types that compiled code allocates; others by number */
+static const char * type_name(int type, char * buf, size_t size) {
+  switch (type) {
+  case LISTSXP: return "LISTSXP";
+  case CLOSXP:  return "CLOSXP";
+  case ENVSXP:  return "ENVSXP";
+  case PROMSXP: return "PROMSXP";
+  case LANGSXP: return "LANGSXP";
+  case CHARSXP: return "CHARSXP";
+  case LGLSXP:  return "LGLSXP";
+  case INTSXP:  return "INTSXP";
+  case REALSXP: return "REALSXP";
+  case CPLXSXP: return "CPLXSXP";
+  case STRSXP:  return "STRSXP";
+  case VECSXP:  return "VECSXP";
+  case EXPRSXP: return "EXPRSXP";
+  default:
+    snprintf(buf, size, "type%d", type);
+    return buf;
+  }
+}
+
+static void rcc_stats_dump(void) {
+  char file_name[1024];
+  char buf[32];
+  FILE * out;
+  int t, c;
+
+  rcc_output_file_name("RCC_STATS_FILE", RCC_STATS_DEFAULT_FILE, file_name, sizeof(file_name));
+  out = fopen(file_name, "w");
+  if (out == NULL) {
+    fprintf(stderr, "rcc: could not write allocation statistics to %s\n", file_name);
+    return;
+  }
+  fprintf(out, "category,key,detail,count\n");
+  for (t = 0; t < N_TYPES; t++) {
+    for (c = 0; c < N_SIZE_CLASSES; c++) {
+      if (allocs[t][c] == 0) continue;
+      fprintf(out, "alloc,%s,%s,%lu\n", type_name(t, buf, sizeof(buf)),
+	      size_class_names[c], allocs[t][c]);
+    }
+  }
+  for (t = 0; t < N_SITES; t++) {
+    if (sites[t].file == NULL) continue;
+    fprintf(out, "site,%s:%d,%s,%lu\n", sites[t].file, sites[t].line,
+	    type_name(sites[t].type, buf, sizeof(buf)), sites[t].count);
+  }
+  if (other_sites > 0) {
+    fprintf(out, "site,other,,%lu\n", other_sites);
+  }
+  fprintf(out, "escape,return,,%lu\n", escapes[RCC_ESCAPE_RETURN]);
+  fprintf(out, "escape,assign,,%lu\n", escapes[RCC_ESCAPE_ASSIGN]);
+  fprintf(out, "fallback,on,,%lu\n", fallback_on);
+  fprintf(out, "fallback,off,,%lu\n", fallback_off);
+  fprintf(out, "environment,stack,,%lu\n", stack_envs);
+  fprintf(out, "environment,heap,,%lu\n", heap_envs);
+  fclose(out);
+}
@@ -0,0 +1,87 @@
+/*  -*- Mode: C -*-
+ *
+ *  Copyright (c) 2009 Rice University
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+ *  File: rcc_stats.h
+ *
+ *  Allocation statistics for code compiled with -falloc-stats. The
+ *  generated file defines RCC_ALLOC_STATS before including
+ *  rcc_generated_header.h, which turns the allocation functions it
+ *  calls into counting wrappers. The counters are written at exit.
+ *  This replaces the R_DUMP_STATS output of the instrumented
+ *  interpreter (and tests/scripts/analyze.pl) for allocations made
+ *  by compiled code; allocations inside the interpreter are not seen.
+ *
+ *  Author: John Garvin (garvin@cs.rice.edu)
+ */
+
+#ifndef RCC_STATS_H
+#define RCC_STATS_H
+
+typedef enum {
+  RCC_ESCAPE_RETURN,           /* value returned by a compiled function */
+  RCC_ESCAPE_ASSIGN            /* value assigned by <<- */
+} rcc_escape_kind;
+
+SEXP rcc_stats_allocVector(SEXPTYPE type, int length, const char * file, int line);
+SEXP rcc_stats_cons(SEXP car, SEXP cdr, const char * file, int line);
+SEXP rcc_stats_lcons(SEXP car, SEXP cdr, const char * file, int line);
+SEXP rcc_stats_mkPROMISE(SEXP expr, SEXP rho, const char * file, int line);
+void rcc_stats_set_fallback(Rboolean x);
+void rcc_stats_closure_call(int options);
+void rcc_stats_escape(rcc_escape_kind kind);
+
+/*  Counters are written as CSV to the file named by the
+    RCC_STATS_FILE environment variable ("rcc_stats.csv" by default;
+    "%p" is replaced by the process ID). Each line is
+
+      category,key,detail,count
+
+    where the categories are
+      alloc        key = type, detail = size class of the data in
+                   bytes (0, <=8, <=16, <=32, <=64, <=128, large)
+      site         key = file:line of the allocation, detail = type
+      escape       key = return or assign
+      fallback     key = on or off, counting setFallbackAlloc calls
+                   that change the setting
+      environment  key = stack or heap, counting closure calls by
+                   whether the callee's environment is stack allocated */
+
+#ifdef RCC_ALLOC_STATS
+
+#define RCC_STATS_SITE __FILE__, __LINE__
+
+#undef allocVector
+#define allocVector(type, length) rcc_stats_allocVector((type), (length), RCC_STATS_SITE)
+#undef cons
+#define cons(car, cdr) rcc_stats_cons((car), (cdr), RCC_STATS_SITE)
+#undef lcons
+#define lcons(car, cdr) rcc_stats_lcons((car), (cdr), RCC_STATS_SITE)
+#undef mkPROMISE
+#define mkPROMISE(expr, rho) rcc_stats_mkPROMISE((expr), (rho), RCC_STATS_SITE)
+
+#define setFallbackAlloc(x) rcc_stats_set_fallback(x)
+
+/*  A function-like macro is not expanded inside its own expansion, so
+    this still calls the real applyClosureOpt. */
+#define applyClosureOpt(call, op, args, rho, supplied, options, name) \
+  (rcc_stats_closure_call(options),				      \
+   applyClosureOpt((call), (op), (args), (rho), (supplied), (options), (name)))
+
+#endif
+
+#endif
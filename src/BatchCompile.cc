@@ -0,0 +1,173 @@
+// -*- Mode: C++ -*-
+//
+// Copyright (c) 2009 Rice University
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation; either version 2 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+
+
+// File: BatchCompile.cc
+//
+// Compilation of several input files by one rcc, several at a time.
+//
+// Author: John Garvin (garvin@cs.rice.edu)
+
+#include <cerrno>
+#include <cstdio>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+extern "C" {
+
+#include <unistd.h>
+#include <sys/time.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+
+} //extern "C"
+
+#include <support/Parser.h>
+#include <support/RccError.h>
+#include <support/StringUtils.h>
+
+#include <BatchCompile.h>
+#include <CommandLineArgs.h>
+#include <CompileReport.h>
+
+using namespace std;
+
+static double now() {
+  struct timeval tv;
+  gettimeofday(&tv, 0);
+  return tv.tv_sec + tv.tv_usec / 1e6;
+}
+
+static void flush_all() {
+  cout.flush();
+  cerr.flush();
+  fflush(stdout);
+  fflush(stderr);
+}
+
+/// The name of the C file made from 'fullname', as in rcc_compile
+static string output_name(const string & fullname) {
+  int pos = filename_pos(fullname);
+  string filename = fullname.substr(pos, fullname.size() - pos);
+  return make_c_id(strip_suffix(filename)) + ".c";
+}
+
+int compile_batch(CommandLineArgs * args, CompileFunction compile) {
+  const vector<string> inputs = args->get_input_files();
+  const string report = args->get_report_filename();
+  const unsigned int jobs = args->get_jobs();
+  string out_dir;
+  if (args->get_out_file_exists()) {
+    out_dir = args->get_out_filename();
+    if (!out_dir.empty() && out_dir[out_dir.size() - 1] != '/') {
+      out_dir += "/";
+    }
+  }
+
+  // the children inherit the started R
+  init_R();
+
+  // every input counts as failed until its child exits with 0, so
+  // one that cannot be started or waited for is reported as well
+  vector<CompileReport::BatchEntry> entries(inputs.size());
+  for (unsigned int k = 0; k < inputs.size(); k++) {
+    entries[k].input = inputs[k];
+    entries[k].status = 1;
+    entries[k].seconds = 0;
+    entries[k].report_file = (report.empty() ? "" : report + "." + i_to_s(k));
+  }
+  vector<double> start(inputs.size());
+  map<pid_t, unsigned int> running;
+  unsigned int next = 0;
+
+  while (next < inputs.size() || !running.empty()) {
+    if (next < inputs.size() && running.size() < jobs) {
+      // start the next input
+      unsigned int k = next++;
+      CompileReport::BatchEntry & e = entries[k];
+      string out_filename;
+      if (!out_dir.empty()) {
+	// with --split-units, -o names the directory in any case
+	out_filename = out_dir + (args->get_split_units() > 1 ? "" : output_name(inputs[k]));
+      }
+
+      flush_all();
+      start[k] = now();
+      pid_t pid = fork();
+      if (pid < 0) {
+	perror(("rcc: fork for " + e.input).c_str());
+	continue;
+      }
+      if (pid == 0) {
+	args->select_input(inputs[k], out_filename, e.report_file);
+	int status;
+	try {
+	  status = compile(args);
+	}
+	catch (RccExit & x) {
+	  status = x.status();
+	}
+	flush_all();
+	_exit(status);
+      }
+      running[pid] = k;
+    } else {
+      // wait for one to finish
+      int wstatus;
+      pid_t pid = waitpid(-1, &wstatus, 0);
+      if (pid < 0) {
+	if (errno == EINTR) continue;
+	perror("rcc: waitpid");
+	break;
+      }
+      map<pid_t, unsigned int>::iterator it = running.find(pid);
+      if (it == running.end()) continue;
+      CompileReport::BatchEntry & e = entries[it->second];
+      e.seconds = now() - start[it->second];
+      running.erase(it);
+      if (WIFEXITED(wstatus)) {
+	e.status = WEXITSTATUS(wstatus);
+      } else {
+	e.status = 128 + WTERMSIG(wstatus);
+	cerr << "rcc: compilation of " << e.input << " killed by signal "
+	     << WTERMSIG(wstatus) << endl;
+      }
+    }
+  }
+
+  int failures = 0;
+  for (unsigned int k = 0; k < entries.size(); k++) {
+    if (entries[k].status != 0) failures++;
+  }
+
+  if (!report.empty()) {
+    CompileReport::write_batch(report, entries);
+    for (unsigned int k = 0; k < entries.size(); k++) {
+      if (!entries[k].report_file.empty()) {
+	unlink(entries[k].report_file.c_str());
+      }
+    }
+  }
+  if (failures > 0) {
+    cerr << "rcc: " << failures << " of " << inputs.size()
+	 << " inputs failed to compile" << endl;
+  }
+  return (failures > 0 ? 1 : 0);
+}
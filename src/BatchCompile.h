@@ -0,0 +1,49 @@
+// -*- Mode: C++ -*-
+//
+// Copyright (c) 2009 Rice University
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation; either version 2 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+
+
+// File: BatchCompile.h
+//
+// Compilation of several input files by one rcc, several at a time.
+//
+// Author: John Garvin (garvin@cs.rice.edu)
+
+#ifndef BATCH_COMPILE_H
+#define BATCH_COMPILE_H
+
+class CommandLineArgs;
+
+/// Compiles the input selected in the command line; returns the exit
+/// status
+typedef int (*CompileFunction)(CommandLineArgs * args);
+
+/// Compile each input file of 'args' on its own with 'compile'.
+///
+/// The analyses and code generation keep their state in process-wide
+/// singletons, and the embedded R is not reentrant, so each input is
+/// compiled in a child process forked after R has started, with up
+/// to args->get_jobs() children at a time. Starting R, the costly
+/// part of a small compilation, is done once.
+///
+/// Each output goes where a compilation of that input alone would
+/// put it, or into the directory named by -o. With --report the
+/// children's reports are combined into one, with the exit status and
+/// time of each input. Returns 0 if every input compiled, 1 if not.
+int compile_batch(CommandLineArgs * args, CompileFunction compile);
+
+#endif
@@ -33,4 +33,8 @@ const std::string CScope::new_label() const {
   return m_prefix + "_" + i_to_s(s_id++);
 }
 
+void CScope::reset() {
+  s_id = 0;
+}
+
 unsigned int CScope::s_id = 0;
@@ -31,6 +31,9 @@ class CScope {
 public:
   explicit CScope(std::string _prefix);
   const std::string new_label() const;
+
+  /// start numbering labels from zero again
+  static void reset();
 private:
   const std::string m_prefix;
   static unsigned int s_id;
@@ -22,6 +22,7 @@
 //
 // Author: John Garvin (garvin@cs.rice.edu)
 
+#include <stdlib.h>
 #include <string>
 #include <iostream>
 #include <getopt.h>
@@ -41,21 +42,36 @@ CommandLineArgs::CommandLineArgs(int argc, char * argv[])
     m_out_file_exists(false),
     m_out_filename(""),
     m_in_file_exists(false),
-    m_fullname("")
+    m_fullname(""),
+    m_split_units(1),
+    m_cache_dir(""),
+    m_report_filename(""),
+    m_profile_use_filename(""),
+    m_jobs(1)
 {
   int c;
+  int option_index;
   extern char * optarg;
   extern int optind;
 
+  // scan from the start even if getopt has run before, as it does
+  // for every compilation in the compile server
+  optind = 0;
+
     // get options
   while(1) {
     static const struct option long_options[] = {
       {"debug",                           no_argument, 0, 'd'},
       {"no-output-main-program",          no_argument, 0, 'm'},
       {"isolemnlyswearthatiamuptonogood", no_argument, 0, 'i'},
+      {"split-units",                     required_argument, 0, 's'},
+      {"cache-dir",                       required_argument, 0, 'C'},
+      {"report",                          required_argument, 0, 'R'},
+      {"profile-use",                     required_argument, 0, 'P'},
+      {"jobs",                            required_argument, 0, 'j'},
       {0,0,0,0}
     };
-    c = getopt_long(argc, argv, "df:mo:", long_options, &optind);
+    c = getopt_long(argc, argv, "df:j:mo:", long_options, &option_index);
     if (c == -1) {
       break;
     }
@@ -72,6 +88,13 @@ CommandLineArgs::CommandLineArgs(int argc, char * argv[])
       add_f_option("assume-correct-program");
       add_f_option("aggressive-CBV");
       break;
+    case 'j':
+      // compile up to this many inputs of a batch at once
+      m_jobs = atoi(optarg);
+      if (m_jobs < 1) {
+	arg_err();
+      }
+      break;
     case 'm':
       // don't output a main program
       m_output_main_program = false;
@@ -81,6 +104,25 @@ CommandLineArgs::CommandLineArgs(int argc, char * argv[])
       m_out_file_exists = true;
       m_out_filename = std::string(optarg);
       break;
+    case 's':
+      // partition the output into this many C files
+      m_split_units = atoi(optarg);
+      if (m_split_units < 1) {
+	arg_err();
+      }
+      break;
+    case 'C':
+      // reuse output from earlier compilations kept in this directory
+      m_cache_dir = std::string(optarg);
+      break;
+    case 'R':
+      // write a JSON report of the compilation
+      m_report_filename = std::string(optarg);
+      break;
+    case 'P':
+      // guide compilation by a profile written by -fprofile code
+      m_profile_use_filename = std::string(optarg);
+      break;
     case '?':
       arg_err();
       break;
@@ -93,17 +135,13 @@ CommandLineArgs::CommandLineArgs(int argc, char * argv[])
     }
   }
 
-  // get filename, if it exists
-  if (optind < argc) {
+  // get input files; with more than one, each is compiled on its own
+  while (optind < argc) {
+    m_input_files.push_back(std::string(argv[optind++]));
+  }
+  if (!m_input_files.empty()) {
     m_in_file_exists = true;
-    m_fullname = std::string(argv[optind++]);
-    if (optind < argc) {
-      std::cerr << "Warning: ignoring extra arguments: ";
-      while (optind < argc) {
-	std::cerr << argv[optind++] << " ";
-      }
-      std::cerr << std::endl;
-    }
+    m_fullname = m_input_files[0];
   } else {  // no filename specified
     m_in_file_exists = false;
   }
@@ -116,6 +154,23 @@ bool CommandLineArgs::get_out_file_exists() { return m_out_file_exists; }
 std::string CommandLineArgs::get_out_filename() { return m_out_filename; }
 bool CommandLineArgs::get_in_file_exists() { return m_in_file_exists; }
 std::string CommandLineArgs::get_fullname() { return m_fullname; }
+int CommandLineArgs::get_split_units() { return m_split_units; }
+std::string CommandLineArgs::get_cache_dir() { return m_cache_dir; }
+std::string CommandLineArgs::get_report_filename() { return m_report_filename; }
+std::string CommandLineArgs::get_profile_use_filename() { return m_profile_use_filename; }
+const std::vector<std::string> & CommandLineArgs::get_input_files() { return m_input_files; }
+int CommandLineArgs::get_jobs() { return m_jobs; }
+
+void CommandLineArgs::select_input(const std::string & fullname,
+				   const std::string & out_filename,
+				   const std::string & report_filename)
+{
+  m_in_file_exists = true;
+  m_fullname = fullname;
+  m_out_file_exists = !out_filename.empty();
+  m_out_filename = out_filename;
+  m_report_filename = report_filename;
+}
 
 void CommandLineArgs::add_f_option(std::string option) {
   Settings * settings = Settings::instance();
@@ -147,6 +202,34 @@ void CommandLineArgs::add_f_option(std::string option) {
     settings->set_stack_alloc_obj(flag);
   } else if (option == "stack_debug") {
     settings->set_stack_debug(flag);
+  } else if (option == "region-alloc") {
+    settings->set_region_alloc(flag);
+  } else if (option == "protect-elision") {
+    settings->set_protect_elision(flag);
+  } else if (option == "constant-folding") {
+    settings->set_constant_folding(flag);
+  } else if (option == "sparse-constants") {
+    settings->set_sparse_constants(flag);
+  } else if (option == "dead-store-elimination") {
+    settings->set_dead_store_elimination(flag);
+  } else if (option == "bounds-check-elimination") {
+    settings->set_bounds_check_elimination(flag);
+  } else if (option == "loop-box-reuse") {
+    settings->set_loop_box_reuse(flag);
+  } else if (option == "field-cache") {
+    settings->set_field_cache(flag);
+  } else if (option == "native-conditions") {
+    settings->set_native_conditions(flag);
+  } else if (option == "serialized-constants") {
+    settings->set_serialized_constants(flag);
+  } else if (option == "lazy-constants") {
+    settings->set_lazy_constants(flag);
+  } else if (option == "profile") {
+    settings->set_profile(flag);
+  } else if (option == "profile-sites") {
+    settings->set_profile_sites(flag);
+  } else if (option == "alloc-stats") {
+    settings->set_alloc_stats(flag);
   } else if (option == "assume-correct-program") {
     settings->set_assume_correct_program(flag);
   } else if (option == "aggressive-CBV") {
@@ -159,6 +242,9 @@ void CommandLineArgs::add_f_option(std::string option) {
 }
 
 static void arg_err() {
-  std::cerr << "Usage: rcc [input-file] [-a] [-c] [-d] [-f option...] [-l] [-m] [-o output-file]\n";
-  exit(1);
+  std::cerr << "Usage: rcc [input-file] [-a] [-c] [-d] [-f option...] [-l] [-m] [-o output-file] [--split-units=N] [--cache-dir=dir] [--report=file] [--profile-use=file]\n"
+	    << "       rcc input-file... [-j jobs] [-o output-dir] [options...]\n"
+	    << "       rcc --server=socket\n"
+	    << "       rcc --connect=socket [compiler arguments...]\n";
+  rcc_exit(1);
 }
@@ -26,6 +26,7 @@
 #define COMMAND_LINE_ARGS_H
 
 #include <string>
+#include <vector>
 
 class CommandLineArgs {
 public:
@@ -37,6 +38,19 @@ public:
   std::string get_out_filename();
   bool get_in_file_exists();
   std::string get_fullname();
+  int get_split_units();
+  std::string get_cache_dir();
+  std::string get_report_filename();
+  std::string get_profile_use_filename();
+  const std::vector<std::string> & get_input_files();
+  int get_jobs();
+
+  /// Make this the command line of one input of a batch: compile
+  /// 'fullname' to 'out_filename' (the default name if empty) and
+  /// write the report, if any, to 'report_filename'.
+  void select_input(const std::string & fullname,
+		    const std::string & out_filename,
+		    const std::string & report_filename);
 
 private:
   void add_f_option(std::string option);
@@ -47,6 +61,12 @@ private:
   std::string m_out_filename;
   bool m_in_file_exists;
   std::string m_fullname;
+  int m_split_units;
+  std::string m_cache_dir;
+  std::string m_report_filename;
+  std::string m_profile_use_filename;
+  std::vector<std::string> m_input_files;
+  int m_jobs;
 };
 
 #endif
@@ -0,0 +1,184 @@
+// -*- Mode: C++ -*-
+//
+// Copyright (c) 2009 Rice University
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation; either version 2 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+
+
+// File: CompileCache.cc
+//
+// A directory of previously generated output, keyed by a hash of the
+// program and everything else that determines the output.
+//
+// Author: John Garvin (garvin@cs.rice.edu)
+
+#include <errno.h>
+#include <stdio.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+
+#include <sstream>
+
+#include <support/FileUtils.h>
+#include <support/RccError.h>
+
+#include <CompileCache.h>
+
+using namespace std;
+
+static const string MANIFEST = "manifest";
+
+// 64-bit FNV-1a
+static const CompileCache::Hash FNV_OFFSET = 14695981039346656037ULL;
+static const CompileCache::Hash FNV_PRIME = 1099511628211ULL;
+
+static void mix_bytes(CompileCache::Hash & h, const void * p, int n) {
+  const unsigned char * bytes = static_cast<const unsigned char *>(p);
+  for (int i = 0; i < n; i++) {
+    h = (h ^ bytes[i]) * FNV_PRIME;
+  }
+}
+
+static void mix_int(CompileCache::Hash & h, int x) {
+  mix_bytes(h, &x, sizeof(x));
+}
+
+static void mix_string(CompileCache::Hash & h, const string & s) {
+  mix_int(h, s.size());
+  mix_bytes(h, s.data(), s.size());
+}
+
+static void mix_sexp(CompileCache::Hash & h, SEXP e) {
+  int i, n;
+  mix_int(h, TYPEOF(e));
+  switch(TYPEOF(e)) {
+  case NILSXP:
+    break;
+  case SYMSXP:
+    mix_string(h, CHAR(PRINTNAME(e)));
+    break;
+  case LISTSXP:
+  case LANGSXP:
+    for ( ; e != R_NilValue; e = CDR(e)) {
+      mix_int(h, TYPEOF(e));
+      mix_sexp(h, TAG(e));
+      mix_sexp(h, CAR(e));
+    }
+    mix_int(h, NILSXP);
+    break;
+  case CLOSXP:
+    mix_sexp(h, FORMALS(e));
+    mix_sexp(h, BODY(e));
+    break;
+  case LGLSXP:
+  case INTSXP:
+    n = Rf_length(e);
+    mix_int(h, n);
+    mix_bytes(h, INTEGER(e), n * sizeof(int));
+    break;
+  case REALSXP:
+    n = Rf_length(e);
+    mix_int(h, n);
+    mix_bytes(h, REAL(e), n * sizeof(double));
+    break;
+  case CPLXSXP:
+    n = Rf_length(e);
+    mix_int(h, n);
+    mix_bytes(h, COMPLEX(e), n * sizeof(Rcomplex));
+    break;
+  case STRSXP:
+    n = Rf_length(e);
+    mix_int(h, n);
+    for (i = 0; i < n; i++) {
+      if (STRING_ELT(e, i) == NA_STRING) {
+	mix_int(h, -1);
+      } else {
+	mix_string(h, CHAR(STRING_ELT(e, i)));
+      }
+    }
+    break;
+  default:
+    // nothing else appears in a parse tree; hash the address so that
+    // such a program is never found in the cache
+    mix_bytes(h, &e, sizeof(e));
+    break;
+  }
+}
+
+static string to_hex(CompileCache::Hash h) {
+  char buf[17];
+  snprintf(buf, sizeof(buf), "%016llx", h);
+  return string(buf);
+}
+
+static void make_dir(const string & dir) {
+  if (mkdir(dir.c_str(), 0777) != 0 && errno != EEXIST) {
+    rcc_error("Couldn't create cache directory " + dir);
+  }
+}
+
+CompileCache::Hash CompileCache::hash_sexp(SEXP e) {
+  Hash h = FNV_OFFSET;
+  mix_sexp(h, e);
+  return h;
+}
+
+CompileCache::CompileCache(const string & dir, SEXP exprs, const string & config)
+  : m_dir(dir[dir.size() - 1] == '/' ? dir : dir + "/")
+{
+  Hash key = FNV_OFFSET;
+  mix_string(key, config);
+  for (SEXP e = exprs; e != R_NilValue; e = CDR(e)) {
+    Hash h = hash_sexp(CAR(e));
+    mix_bytes(key, &h, sizeof(h));
+  }
+  m_key = to_hex(key);
+}
+
+string CompileCache::entry_dir() const {
+  return m_dir + m_key + "/";
+}
+
+bool CompileCache::hit() const {
+  string manifest;
+  return read_file(entry_dir() + MANIFEST, manifest);
+}
+
+void CompileCache::fetch(const string & name, const string & dest) const {
+  string text;
+  if (!read_file(entry_dir() + name, text)) {
+    rcc_error("Cache entry " + m_key + " has no file " + name);
+  }
+  write_file_if_changed(dest, text);
+}
+
+void CompileCache::store(const string & name, const string & src) {
+  string text;
+  if (!read_file(src, text)) {
+    rcc_error("Couldn't read " + src + " to cache it");
+  }
+  make_dir(m_dir);
+  make_dir(entry_dir());
+  write_file_if_changed(entry_dir() + name, text);
+  m_stored.push_back(name);
+}
+
+void CompileCache::commit() {
+  string manifest;
+  for (unsigned int i = 0; i < m_stored.size(); i++) {
+    manifest += m_stored[i] + "\n";
+  }
+  write_file_if_changed(entry_dir() + MANIFEST, manifest);
+}
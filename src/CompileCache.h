@@ -0,0 +1,80 @@
+// -*- Mode: C++ -*-
+//
+// Copyright (c) 2009 Rice University
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation; either version 2 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+
+
+// File: CompileCache.h
+//
+// A directory of previously generated output, keyed by a hash of the
+// program and everything else that determines the output.
+//
+// Author: John Garvin (garvin@cs.rice.edu)
+
+#ifndef COMPILE_CACHE_H
+#define COMPILE_CACHE_H
+
+#include <string>
+#include <vector>
+
+#include <include/R/R_RInternals.h>
+
+/// Each top-level expression of the program is hashed separately
+/// over its normalized parse tree (types, names and values, not
+/// attributes), and the key combines those hashes with a
+/// configuration string: the compiler version, R_HOME, the settings
+/// and the output options. An entry is a subdirectory named by the
+/// key holding the output files and a manifest listing them; the
+/// manifest is written last, so an interrupted store is a miss.
+///
+/// The analysis is whole-program (a change to any top-level function
+/// can change what the call graph, side effect and binding analyses
+/// say about every other) and generated names are numbered across the
+/// program, so the unit of reuse is the whole output. Finer reuse of
+/// the C compilation comes from the split units, which are rewritten
+/// only when their contents change.
+class CompileCache {
+public:
+  typedef unsigned long long Hash;
+
+  /// exprs is the list of top-level expressions
+  CompileCache(const std::string & dir, SEXP exprs, const std::string & config);
+
+  const std::string & get_key() const { return m_key; }
+
+  /// Whether the cache has an entry for the key
+  bool hit() const;
+
+  /// Copy the file name of the entry to dest
+  void fetch(const std::string & name, const std::string & dest) const;
+
+  /// Store the file src as name in the entry for the key. Call
+  /// commit after storing all the files.
+  void store(const std::string & name, const std::string & src);
+  void commit();
+
+  /// Hash of e's normalized parse tree
+  static Hash hash_sexp(SEXP e);
+
+private:
+  std::string entry_dir() const;
+
+  const std::string m_dir;
+  std::string m_key;
+  std::vector<std::string> m_stored;
+};
+
+#endif
@@ -0,0 +1,302 @@
+// -*- Mode: C++ -*-
+//
+// Copyright (c) 2009 Rice University
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation; either version 2 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+
+
+// File: CompileReport.cc
+//
+// Machine-readable report of a compilation: metrics, the time and
+// memory taken by each phase, and what was decided for each
+// procedure. Written as JSON with --report=file.
+//
+// Author: John Garvin (garvin@cs.rice.edu)
+
+#include <stdio.h>
+#include <sys/resource.h>
+#include <sys/time.h>
+
+#include <sstream>
+
+#include <analysis/FuncInfo.h>
+#include <analysis/LexicalContext.h>
+#include <analysis/Settings.h>
+
+#include <support/FileUtils.h>
+#include <support/StringUtils.h>
+
+#include <CompileReport.h>
+#include <Metrics.h>
+
+using namespace std;
+
+static const string TOP_LEVEL = "<top level>";
+
+static double now() {
+  struct timeval tv;
+  gettimeofday(&tv, 0);
+  return tv.tv_sec + tv.tv_usec / 1e6;
+}
+
+static long peak_rss_kb() {
+  struct rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+  return usage.ru_maxrss;
+}
+
+static string json_string(const string & s) {
+  string out = "\"";
+  for (string::size_type i = 0; i < s.size(); i++) {
+    char c = s[i];
+    switch (c) {
+    case '"':  out += "\\\""; break;
+    case '\\': out += "\\\\"; break;
+    case '\n': out += "\\n"; break;
+    case '\t': out += "\\t"; break;
+    default:
+      if ((unsigned char)c < 0x20) {
+	char buf[8];
+	snprintf(buf, sizeof(buf), "\\u%04x", c);
+	out += buf;
+      } else {
+	out += c;
+      }
+    }
+  }
+  return out + "\"";
+}
+
+static string json_double(double x) {
+  ostringstream os;
+  os << x;
+  return os.str();
+}
+
+static string json_count_map(const map<string, int> & m) {
+  string out = "{";
+  map<string, int>::const_iterator it;
+  for (it = m.begin(); it != m.end(); ++it) {
+    if (it != m.begin()) out += ", ";
+    out += json_string(it->first) + ": " + i_to_s(it->second);
+  }
+  return out + "}";
+}
+
+/// The calls of one kind: total and by number of arguments
+#define JSON_CALLS(__a__)						\
+  ("{\"total\": " + i_to_s(m->total_ ## __a__()) + ", \"by_args\": [" + \
+   by_args(m, &Metrics::get_ ## __a__, m->max_key_ ## __a__()) + "]}")
+
+static string by_args(const Metrics * m, int (Metrics::*get)(int) const, int max_key) {
+  string out;
+  for (int i = 0; i <= max_key; i++) {
+    if (i > 0) out += ", ";
+    out += i_to_s((m->*get)(i));
+  }
+  return out;
+}
+
+CompileReport * CompileReport::s_instance = 0;
+
+CompileReport * CompileReport::instance() {
+  if (s_instance == 0) {
+    s_instance = new CompileReport();
+  }
+  return s_instance;
+}
+
+void CompileReport::reset() {
+  delete s_instance;
+  s_instance = 0;
+}
+
+void CompileReport::enable(const string & filename) {
+  m_filename = filename;
+}
+
+void CompileReport::begin_phase(const string & name) {
+  if (!enabled()) return;
+  Frame f;
+  f.name = name;
+  f.start = now();
+  f.children = 0.0;
+  m_frames.push_back(f);
+}
+
+void CompileReport::end_phase() {
+  if (!enabled()) return;
+  Frame f = m_frames.back();
+  m_frames.pop_back();
+  double seconds = now() - f.start;
+  if (!m_frames.empty()) {
+    m_frames.back().children += seconds;
+  }
+
+  vector<Phase>::iterator p;
+  for (p = m_phases.begin(); p != m_phases.end() && p->name != f.name; ++p)
+    ;
+  if (p == m_phases.end()) {
+    Phase phase;
+    phase.name = f.name;
+    phase.calls = 0;
+    phase.seconds = 0.0;
+    phase.self_seconds = 0.0;
+    m_phases.push_back(phase);
+    p = m_phases.end() - 1;
+  }
+  p->calls++;
+  p->seconds += seconds;
+  p->self_seconds += seconds - f.children;
+  p->peak_rss_kb = peak_rss_kb();
+}
+
+CompileReport::Proc & CompileReport::proc(const string & name) {
+  if (m_procs.find(name) == m_procs.end()) {
+    m_proc_order.push_back(name);
+  }
+  return m_procs[name];
+}
+
+CompileReport::Proc & CompileReport::current_proc() {
+  if (lexicalContext.IsEmpty()) {
+    return proc(TOP_LEVEL);
+  }
+  return proc(lexicalContext.Top()->get_c_name());
+}
+
+void CompileReport::set_strictness(const string & name, const string & strictness) {
+  if (!enabled()) return;
+  Proc & p = proc(name);
+  p.has_strictness = true;
+  p.strictness = strictness;
+}
+
+void CompileReport::set_closure_may_escape(const string & name, bool may_escape) {
+  if (!enabled()) return;
+  Proc & p = proc(name);
+  p.has_escape = true;
+  p.may_escape = may_escape;
+}
+
+void CompileReport::note_stack_closure_call(const string & callee) {
+  if (!enabled()) return;
+  current_proc().stack_closure_calls[callee]++;
+}
+
+void CompileReport::note_fast_path(const string & path) {
+  if (!enabled()) return;
+  current_proc().fast_paths[path]++;
+}
+
+void CompileReport::write(const string & input) const {
+  if (!enabled()) return;
+  const Metrics * m = Metrics::instance();
+  string out;
+  out += "{\n";
+  out += "  \"input\": " + json_string(input) + ",\n";
+  out += "  \"peak_rss_kb\": " + i_to_s(peak_rss_kb()) + ",\n";
+
+  // settings, from "name: value" lines
+  out += "  \"settings\": {";
+  istringstream settings(Settings::instance()->get_pp_info());
+  string line;
+  bool first = true;
+  while (getline(settings, line)) {
+    string::size_type colon = line.find(": ");
+    if (colon == string::npos) continue;
+    out += (first ? "" : ", ");
+    out += json_string(line.substr(0, colon)) + ": " + line.substr(colon + 2);
+    first = false;
+  }
+  out += "},\n";
+
+  out += "  \"phases\": [\n";
+  for (unsigned int i = 0; i < m_phases.size(); i++) {
+    const Phase & p = m_phases[i];
+    out += "    {\"name\": " + json_string(p.name) +
+      ", \"calls\": " + i_to_s(p.calls) +
+      ", \"seconds\": " + json_double(p.seconds) +
+      ", \"self_seconds\": " + json_double(p.self_seconds) +
+      ", \"peak_rss_kb\": " + i_to_s(p.peak_rss_kb) + "}";
+    out += (i + 1 < m_phases.size() ? ",\n" : "\n");
+  }
+  out += "  ],\n";
+
+  out += "  \"metrics\": {\n";
+  out += "    \"procedures\": " + i_to_s(m->get_procedures()) + ",\n";
+  out += "    \"builtin_calls\": " + JSON_CALLS(builtin_calls) + ",\n";
+  out += "    \"special_calls\": " + JSON_CALLS(special_calls) + ",\n";
+  out += "    \"library_calls\": " + JSON_CALLS(library_calls) + ",\n";
+  out += "    \"user_calls\": " + JSON_CALLS(user_calls) + ",\n";
+  out += "    \"unknown_symbol_calls\": " + JSON_CALLS(unknown_symbol_calls) + ",\n";
+  out += "    \"non_symbol_calls\": " + JSON_CALLS(non_symbol_calls) + ",\n";
+  out += "    \"local_assignments\": " + i_to_s(m->get_local_assignments()) + ",\n";
+  out += "    \"free_assignments\": " + i_to_s(m->get_free_assignments()) + ",\n";
+  out += "    \"eager_actual_args\": " + i_to_s(m->get_eager_actual_args()) + ",\n";
+  out += "    \"lazy_actual_args\": " + i_to_s(m->get_lazy_actual_args()) + ",\n";
+  out += "    \"strict_formal_args\": " + i_to_s(m->get_strict_formal_args()) + ",\n";
+  out += "    \"nonstrict_formal_args\": " + i_to_s(m->get_nonstrict_formal_args()) + "\n";
+  out += "  },\n";
+
+  out += "  \"procedures\": [\n";
+  for (unsigned int i = 0; i < m_proc_order.size(); i++) {
+    const Proc & p = m_procs.find(m_proc_order[i])->second;
+    out += "    {\"name\": " + json_string(m_proc_order[i]);
+    if (p.has_strictness) {
+      out += ", \"strictness\": " + json_string(p.strictness);
+    }
+    if (p.has_escape) {
+      out += string(", \"closure_may_escape\": ") + (p.may_escape ? "true" : "false");
+    }
+    out += ", \"stack_closure_calls\": " + json_count_map(p.stack_closure_calls);
+    out += ", \"fast_paths\": " + json_count_map(p.fast_paths) + "}";
+    out += (i + 1 < m_proc_order.size() ? ",\n" : "\n");
+  }
+  out += "  ]\n";
+  out += "}\n";
+
+  write_file_if_changed(m_filename, out);
+}
+
+void CompileReport::write_batch(const string & filename,
+				const vector<BatchEntry> & entries)
+{
+  struct rusage children;
+  getrusage(RUSAGE_CHILDREN, &children);
+  string out;
+  out += "{\n";
+  out += "  \"peak_rss_kb\": " + i_to_s(peak_rss_kb()) + ",\n";
+  out += "  \"largest_input_peak_rss_kb\": " + i_to_s(children.ru_maxrss) + ",\n";
+  out += "  \"inputs\": [\n";
+  for (unsigned int i = 0; i < entries.size(); i++) {
+    const BatchEntry & e = entries[i];
+    string report;
+    if (!read_file(e.report_file, report) || report.empty()) {
+      report = "null";
+    } else if (report[report.size() - 1] == '\n') {
+      report.erase(report.size() - 1);
+    }
+    out += "    {\"input\": " + json_string(e.input) +
+      ", \"status\": " + i_to_s(e.status) +
+      ", \"seconds\": " + json_double(e.seconds) +
+      ",\n     \"report\": " + report + "}";
+    out += (i + 1 < entries.size() ? ",\n" : "\n");
+  }
+  out += "  ]\n";
+  out += "}\n";
+
+  write_file_if_changed(filename, out);
+}
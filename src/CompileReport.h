@@ -0,0 +1,130 @@
+// -*- Mode: C++ -*-
+//
+// Copyright (c) 2009 Rice University
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation; either version 2 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+
+
+// File: CompileReport.h
+//
+// Machine-readable report of a compilation: metrics, the time and
+// memory taken by each phase, and what was decided for each
+// procedure. Written as JSON with --report=file.
+//
+// Author: John Garvin (garvin@cs.rice.edu)
+
+#ifndef COMPILE_REPORT_H
+#define COMPILE_REPORT_H
+
+#include <map>
+#include <string>
+#include <vector>
+
+class CompileReport {
+public:
+  static CompileReport * instance();
+  /// Forget the instance, so the next compilation starts afresh
+  static void reset();
+
+  /// Turn on reporting; the report is written to filename
+  void enable(const std::string & filename);
+  bool enabled() const { return !m_filename.empty(); }
+
+  // ----- phases -----
+
+  /// Phases nest: an annotation map computed on demand during code
+  /// generation is its own phase, and its time isn't counted as the
+  /// enclosing phase's own ("self") time. Phases with the same name
+  /// are accumulated.
+  void begin_phase(const std::string & name);
+  void end_phase();
+
+  // ----- procedures, named by their C names -----
+
+  void set_strictness(const std::string & proc, const std::string & strictness);
+  void set_closure_may_escape(const std::string & proc, bool may_escape);
+
+  /// A call in the procedure being compiled was given AC_STACK_CLOSURE
+  void note_stack_closure_call(const std::string & callee);
+
+  /// An optimized code path was taken in the procedure being compiled
+  void note_fast_path(const std::string & path);
+
+  // ----- output -----
+
+  void write(const std::string & input) const;
+
+  /// One input of a batch compilation, compiled in its own process
+  struct BatchEntry {
+    std::string input;
+    int status;
+    double seconds;
+    std::string report_file;  // written by that compilation
+  };
+
+  /// Write a combined report of a batch to filename, embedding the
+  /// report of each entry
+  static void write_batch(const std::string & filename,
+			  const std::vector<BatchEntry> & entries);
+
+private:
+  CompileReport() {}
+  static CompileReport * s_instance;
+
+  struct Phase {
+    std::string name;
+    int calls;
+    double seconds;
+    double self_seconds;
+    long peak_rss_kb;
+  };
+  struct Frame {
+    std::string name;
+    double start;
+    double children;
+  };
+  struct Proc {
+    Proc() : has_strictness(false), has_escape(false), may_escape(true) {}
+    bool has_strictness;
+    std::string strictness;
+    bool has_escape;
+    bool may_escape;
+    std::map<std::string, int> stack_closure_calls;
+    std::map<std::string, int> fast_paths;
+  };
+
+  Proc & proc(const std::string & name);
+  Proc & current_proc();
+
+  std::string m_filename;
+  std::vector<Phase> m_phases;
+  std::vector<Frame> m_frames;
+  std::vector<std::string> m_proc_order;
+  std::map<std::string, Proc> m_procs;
+};
+
+/// Times a phase for the report from construction to destruction,
+/// including when the phase is left by an exception
+class ReportPhase {
+public:
+  explicit ReportPhase(const std::string & name) {
+    CompileReport::instance()->begin_phase(name);
+  }
+  ~ReportPhase() {
+    CompileReport::instance()->end_phase();
+  }
+};
+
+#endif
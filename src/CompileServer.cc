@@ -0,0 +1,287 @@
+// -*- Mode: C++ -*-
+//
+// Copyright (c) 2009 Rice University
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation; either version 2 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+
+
+// File: CompileServer.cc
+//
+// A resident rcc that starts the embedded R once and then compiles
+// one program per connection on a Unix socket, and the client side
+// that sends it a command line.
+//
+// Author: John Garvin (garvin@cs.rice.edu)
+
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <iostream>
+#include <string>
+#include <vector>
+
+extern "C" {
+
+#include <signal.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+} //extern "C"
+
+#include <include/R/R_Defn.h>
+#include <include/R/R_RInternals.h>
+
+#include <support/Parser.h>
+#include <support/RccError.h>
+#include <support/StringUtils.h>
+
+#include <CompileServer.h>
+
+using namespace std;
+
+// forward declarations of internal functions
+
+static bool make_address(const string & path, struct sockaddr_un & addr);
+static bool write_all(int fd, const char * buf, size_t n);
+static bool read_request(int fd, vector<string> & request);
+static int serve(int conn, const vector<string> & request);
+static int search_length();
+static void detach_packages(int keep);
+
+int run_compile_server(const string & path) {
+  struct sockaddr_un addr;
+  if (!make_address(path, addr)) {
+    cerr << "rcc: socket path too long: " << path << endl;
+    return 1;
+  }
+  int listener = socket(AF_UNIX, SOCK_STREAM, 0);
+  if (listener < 0) {
+    perror("rcc: socket");
+    return 1;
+  }
+  unlink(path.c_str());  // left over from a server that was killed
+  if (bind(listener, (struct sockaddr *)&addr, sizeof(addr)) != 0 ||
+      listen(listener, 16) != 0)
+  {
+    perror(("rcc: " + path).c_str());
+    close(listener);
+    return 1;
+  }
+  signal(SIGPIPE, SIG_IGN);  // a client that goes away is not fatal
+
+  init_R();
+  int base_search_length = search_length();
+  set_rcc_exit_throws(true);
+  cerr << "rcc: compile server listening on " << path << endl;
+
+  while (true) {
+    int conn = accept(listener, 0, 0);
+    if (conn < 0) {
+      if (errno == EINTR) continue;
+      perror("rcc: accept");
+      break;
+    }
+    vector<string> request;
+    if (read_request(conn, request) && request.size() >= 2) {
+      int status = serve(conn, request);
+      detach_packages(base_search_length);
+      string answer = string(1, '\0') + i_to_s(status) + "\n";
+      write_all(conn, answer.data(), answer.size());
+    }
+    close(conn);
+  }
+
+  set_rcc_exit_throws(false);
+  close(listener);
+  unlink(path.c_str());
+  return 1;
+}
+
+bool run_compile_client(const string & path, int argc, char * argv[], int & status) {
+  struct sockaddr_un addr;
+  if (!make_address(path, addr)) return false;
+  int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+  if (fd < 0) return false;
+  if (connect(fd, (struct sockaddr *)&addr, sizeof(addr)) != 0) {
+    close(fd);
+    return false;
+  }
+
+  vector<char> cwd(4096);
+  if (getcwd(&cwd[0], cwd.size()) == 0) {
+    close(fd);
+    return false;
+  }
+  string request = string(&cwd[0]) + '\0';
+  for (int i = 0; i < argc; i++) {
+    request += string(argv[i]) + '\0';
+  }
+  request += '\0';
+  if (!write_all(fd, request.data(), request.size())) {
+    close(fd);
+    return false;
+  }
+
+  // output up to the NUL, then the status
+  string answer;
+  bool in_status = false;
+  char buf[4096];
+  ssize_t got;
+  while ((got = read(fd, buf, sizeof(buf))) != 0) {
+    if (got < 0) {
+      if (errno == EINTR) continue;
+      break;
+    }
+    ssize_t start = 0;
+    if (!in_status) {
+      char * nul = (char *)memchr(buf, '\0', got);
+      ssize_t end = (nul == 0 ? got : nul - buf);
+      fwrite(buf, 1, end, stderr);
+      if (nul == 0) continue;
+      in_status = true;
+      start = end + 1;
+    }
+    answer.append(buf + start, got - start);
+  }
+  close(fd);
+  if (!in_status || answer.empty()) {
+    cerr << "rcc: compile server at " << path << " closed the connection" << endl;
+    status = 1;
+  } else {
+    status = atoi(answer.c_str());
+  }
+  return true;
+}
+
+static bool make_address(const string & path, struct sockaddr_un & addr) {
+  memset(&addr, 0, sizeof(addr));
+  addr.sun_family = AF_UNIX;
+  if (path.empty() || path.size() >= sizeof(addr.sun_path)) return false;
+  strcpy(addr.sun_path, path.c_str());
+  return true;
+}
+
+static bool write_all(int fd, const char * buf, size_t n) {
+  while (n > 0) {
+    ssize_t put = write(fd, buf, n);
+    if (put < 0) {
+      if (errno == EINTR) continue;
+      return false;
+    }
+    buf += put;
+    n -= put;
+  }
+  return true;
+}
+
+/// Read NUL-terminated strings up to the empty one that ends the
+/// request. False if the client hangs up first.
+static bool read_request(int fd, vector<string> & request) {
+  string current;
+  char buf[4096];
+  ssize_t got;
+  while ((got = read(fd, buf, sizeof(buf))) != 0) {
+    if (got < 0) {
+      if (errno == EINTR) continue;
+      return false;
+    }
+    for (ssize_t i = 0; i < got; i++) {
+      if (buf[i] != '\0') {
+	current += buf[i];
+      } else if (current.empty()) {
+	return true;
+      } else {
+	request.push_back(current);
+	current.clear();
+      }
+    }
+  }
+  return false;
+}
+
+/// Run one compilation with stdout and stderr sent to 'conn'.
+/// Returns its exit status.
+static int serve(int conn, const vector<string> & request) {
+  if (chdir(request[0].c_str()) != 0) {
+    string msg = "rcc: compile server cannot change to " + request[0] + "\n";
+    write_all(conn, msg.data(), msg.size());
+    return 1;
+  }
+
+  vector<char *> argv;
+  for (unsigned int i = 1; i < request.size(); i++) {
+    argv.push_back(const_cast<char *>(request[i].c_str()));
+  }
+  argv.push_back(0);
+
+  cout.flush();
+  cerr.flush();
+  fflush(stdout);
+  fflush(stderr);
+  int saved_out = dup(1);
+  int saved_err = dup(2);
+  dup2(conn, 1);
+  dup2(conn, 2);
+
+  // The compiler calls R through rcc_call_R, which turns an R
+  // error into an rcc_error, so every failure arrives here as an
+  // exception. Handles it left protected are dropped below.
+  int protect_top = R_PPStackTop;
+  int status;
+  try {
+    status = rcc_compile(argv.size() - 1, &argv[0]);
+  }
+  catch (RccExit & e) {
+    status = e.status();
+  }
+  catch (std::exception & e) {
+    cerr << "rcc: " << e.what() << endl;
+    status = 1;
+  }
+
+  cout.flush();
+  cerr.flush();
+  fflush(stdout);
+  fflush(stderr);
+  dup2(saved_out, 1);
+  dup2(saved_err, 2);
+  close(saved_out);
+  close(saved_err);
+
+  R_PPStackTop = protect_top;
+  rcc_reset();
+  return status;
+}
+
+static int search_length() {
+  int error;
+  SEXP value = R_tryEval(Rf_lang1(Rf_install("search")), R_GlobalEnv, &error);
+  return (error ? 0 : Rf_length(value));
+}
+
+/// Detach whatever library() calls in the last program attached, so
+/// the next one sees only the base search path.
+static void detach_packages(int keep) {
+  int error;
+  SEXP detach = Rf_protect(Rf_lang2(Rf_install("detach"), Rf_ScalarInteger(2)));
+  for (int n = search_length(); n > keep; n--) {
+    R_tryEval(detach, R_GlobalEnv, &error);
+    if (error) break;
+  }
+  Rf_unprotect(1);
+}
@@ -0,0 +1,63 @@
+// -*- Mode: C++ -*-
+//
+// Copyright (c) 2009 Rice University
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation; either version 2 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+
+
+// File: CompileServer.h
+//
+// A resident rcc that starts the embedded R once and then compiles
+// one program per connection on a Unix socket, and the client side
+// that sends it a command line.
+//
+// Author: John Garvin (garvin@cs.rice.edu)
+
+#ifndef COMPILE_SERVER_H
+#define COMPILE_SERVER_H
+
+#include <string>
+
+/// A request is the client's working directory followed by its
+/// argv, each string terminated by a NUL, and ended by an empty
+/// string. The server changes to that directory, compiles with
+/// stdout and stderr sent to the connection, and answers with a NUL
+/// followed by the exit status in decimal and a newline.
+///
+/// Compilations are run one at a time. After each one the server
+/// calls rcc_reset, restores the R protect stack and detaches any
+/// package that library() calls in the program attached. The
+/// client's environment variables are not forwarded.
+
+/// Listen on the socket at 'path' and serve compilations until
+/// killed. Returns only if the socket cannot be set up.
+int run_compile_server(const std::string & path);
+
+/// Send the command line to the server at 'path', copy its output
+/// to stderr and set 'status' to the exit status of the
+/// compilation. Returns false, having sent nothing, if there is no
+/// server to connect to.
+bool run_compile_client(const std::string & path, int argc, char * argv[], int & status);
+
+// defined in Main.cc
+
+/// Compile the program named by the command line.
+int rcc_compile(int argc, char * argv[]);
+
+/// Discard all state left by a compilation, so that the next
+/// rcc_compile in the same process behaves like a fresh rcc.
+void rcc_reset();
+
+#endif
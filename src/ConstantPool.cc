@@ -0,0 +1,183 @@
+// -*- Mode: C++ -*-
+//
+// Copyright (c) 2008 Rice University
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation; either version 2 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+
+// File: ConstantPool.cc
+//
+// Constant R objects serialized into a single byte array in the
+// generated code and rebuilt in one pass when the program is loaded.
+//
+// Author: John Garvin (garvin@cs.rice.edu)
+
+#include <assert.h>
+#include <string.h>
+
+#include <analysis/Utils.h>
+
+#include <support/StringUtils.h>
+
+#include <ConstantPool.h>
+
+using namespace std;
+
+ConstantPool * ConstantPool::s_instance = 0;
+
+ConstantPool * ConstantPool::instance() {
+  if (s_instance == 0) {
+    s_instance = new ConstantPool();
+  }
+  return s_instance;
+}
+
+void ConstantPool::reset() {
+  delete s_instance;
+  s_instance = 0;
+}
+
+bool ConstantPool::can_serialize(SEXP e) {
+  switch(TYPEOF(e)) {
+  case NILSXP:
+    return true;
+  case SYMSXP:
+    return (e != R_UnboundValue);
+  case LISTSXP:
+  case LANGSXP:
+    for ( ; e != R_NilValue; e = CDR(e)) {
+      if (!is_cons(e) || ATTRIB(e) != R_NilValue ||
+	  !can_serialize(TAG(e)) || !can_serialize(CAR(e)))
+      {
+	return false;
+      }
+    }
+    return true;
+  case LGLSXP:
+  case INTSXP:
+  case REALSXP:
+  case CPLXSXP:
+  case STRSXP:
+    return (ATTRIB(e) == R_NilValue);
+  default:
+    return false;
+  }
+}
+
+string ConstantPool::add(SEXP e) {
+  assert(can_serialize(e));
+  write(e);
+  return "RCC_CONSTANT(" + i_to_s(m_count++) + ")";
+}
+
+string ConstantPool::output_decls() const {
+  string out;
+  out += "static SEXP rcc_constants;\n";
+  out += "#define RCC_CONSTANT(i) VECTOR_ELT(rcc_constants, i)\n";
+  return out;
+}
+
+string ConstantPool::output_data() const {
+  string out;
+  out += "static const unsigned char rcc_constant_bytes[] = {";
+  for (string::size_type i = 0; i < m_bytes.size(); i++) {
+    if (i % 16 == 0) out += "\n ";
+    out += " " + i_to_s((unsigned char)m_bytes[i]) + ",";
+  }
+  out += "\n};\n";
+  return out;
+}
+
+string ConstantPool::output_init() const {
+  return "rcc_constants = rcc_read_constants(rcc_constant_bytes, " + i_to_s(m_count) + ");\n";
+}
+
+void ConstantPool::write(SEXP e) {
+  int i, n;
+  switch(TYPEOF(e)) {
+  case NILSXP:
+    m_bytes += 'N';
+    break;
+  case SYMSXP:
+    if (e == R_MissingArg) {
+      m_bytes += 'M';
+    } else {
+      m_bytes += 'S';
+      write_string(PRINTNAME(e));
+    }
+    break;
+  case LISTSXP:
+  case LANGSXP:
+    m_bytes += 'L';
+    write_int(Rf_length(e));
+    for ( ; e != R_NilValue; e = CDR(e)) {
+      m_bytes += (TYPEOF(e) == LANGSXP ? 'G' : 'L');
+      write(TAG(e));
+      write(CAR(e));
+    }
+    break;
+  case LGLSXP:
+  case INTSXP:
+    n = Rf_length(e);
+    m_bytes += (TYPEOF(e) == LGLSXP ? 'B' : 'I');
+    write_int(n);
+    for (i = 0; i < n; i++) {
+      write_int(INTEGER(e)[i]);
+    }
+    break;
+  case REALSXP:
+    n = Rf_length(e);
+    m_bytes += 'R';
+    write_int(n);
+    write_bytes(REAL(e), n * sizeof(double));
+    break;
+  case CPLXSXP:
+    n = Rf_length(e);
+    m_bytes += 'C';
+    write_int(n);
+    write_bytes(COMPLEX(e), n * sizeof(Rcomplex));
+    break;
+  case STRSXP:
+    n = Rf_length(e);
+    m_bytes += 'T';
+    write_int(n);
+    for (i = 0; i < n; i++) {
+      write_string(STRING_ELT(e, i));
+    }
+    break;
+  default:
+    assert(0 && "ConstantPool: can't serialize this type");
+  }
+}
+
+void ConstantPool::write_int(int x) {
+  unsigned int u = (unsigned int)x;
+  for (int i = 0; i < 4; i++) {
+    m_bytes += (char)((u >> (8 * i)) & 0xff);
+  }
+}
+
+void ConstantPool::write_bytes(const void * p, int n) {
+  m_bytes.append((const char *)p, n);
+}
+
+void ConstantPool::write_string(SEXP charsxp) {
+  if (charsxp == NA_STRING) {
+    write_int(-1);
+  } else {
+    int n = strlen(CHAR(charsxp));
+    write_int(n);
+    write_bytes(CHAR(charsxp), n);
+  }
+}
@@ -0,0 +1,93 @@
+// -*- Mode: C++ -*-
+//
+// Copyright (c) 2008 Rice University
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation; either version 2 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+
+// File: ConstantPool.h
+//
+// Constant R objects serialized into a single byte array in the
+// generated code and rebuilt in one pass when the program is loaded.
+//
+// Author: John Garvin (garvin@cs.rice.edu)
+
+#ifndef CONSTANT_POOL_H
+#define CONSTANT_POOL_H
+
+#include <string>
+
+#include <include/R/R_RInternals.h>
+
+/// Building every literal list, string and scalar with its own
+/// generated statements makes the constant initialization functions
+/// the bulk of the output: slow to compile and slow to run. Instead,
+/// constants can be written into the pool, which the generated code
+/// reads back with rcc_read_constants into one preserved VECSXP. A
+/// constant's handle is its index in that vector.
+///
+/// The format is our own, not R's serialize format, so that it
+/// covers exactly what appears in parse trees:
+///
+///   N                 R_NilValue
+///   M                 R_MissingArg
+///   S <str>           symbol
+///   L <n> {G|L tag car}*n
+///                     pairlist of n cells, each LANGSXP (G) or LISTSXP (L)
+///   B|I <n> <int>*n   logical or integer vector
+///   R <n> <double>*n  real vector
+///   C <n> <double>*2n complex vector
+///   T <n> <str>*n     string vector
+///
+/// where <n> and <int> are four bytes, little-endian; <double> is in
+/// the host's native layout; and <str> is a length (-1 for NA)
+/// followed by that many bytes.
+class ConstantPool {
+public:
+  static ConstantPool * instance();
+  /// Forget the instance, so the next compilation starts afresh
+  static void reset();
+
+  /// Whether e is made only of things the pool can represent
+  static bool can_serialize(SEXP e);
+
+  /// Add e to the pool; return the C expression for its handle
+  std::string add(SEXP e);
+
+  bool empty() const { return m_count == 0; }
+
+  /// C declaration of the handle vector
+  std::string output_decls() const;
+
+  /// C definition of the byte array; only output_init uses it
+  std::string output_data() const;
+
+  /// C statement that reads the pool; must run before any code that
+  /// uses a handle
+  std::string output_init() const;
+
+private:
+  ConstantPool() : m_count(0) {}
+  static ConstantPool * s_instance;
+
+  void write(SEXP e);
+  void write_int(int x);
+  void write_bytes(const void * p, int n);
+  void write_string(SEXP charsxp);
+
+  std::string m_bytes;
+  int m_count;
+};
+
+#endif
@@ -0,0 +1,130 @@
+// -*- Mode: C++ -*-
+//
+// Copyright (c) 2008 Rice University
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation; either version 2 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+
+
+// File: LazyConstants.cc
+//
+// Constants owned by a single procedure, built on the procedure's
+// first entry instead of when the library is loaded.
+//
+// Author: John Garvin (garvin@cs.rice.edu)
+
+#include <support/StringUtils.h>
+
+#include <codegen/SubexpBuffer/SubexpBuffer.h>
+#include <codegen/SubexpBuffer/SplitSubexpBuffer.h>
+
+#include <CodeGenUtils.h>
+#include <ParseInfo.h>
+
+#include <LazyConstants.h>
+
+using namespace std;
+
+static string init_name(string c_name) {
+  return "lazy_init_" + c_name;
+}
+
+static string done_name(string c_name) {
+  return "lazy_done_" + c_name;
+}
+
+LazyConstants * LazyConstants::s_instance = 0;
+
+LazyConstants * LazyConstants::instance() {
+  if (s_instance == 0) {
+    s_instance = new LazyConstants();
+  }
+  return s_instance;
+}
+
+void LazyConstants::reset() {
+  delete s_instance;
+  s_instance = 0;
+}
+
+void LazyConstants::enter(string c_name, bool lazy) {
+  Proc p;
+  p.c_name = c_name;
+  p.lazy = lazy;
+  p.constants = new SubexpBuffer("c", true);
+  m_stack.push_back(p);
+}
+
+string LazyConstants::leave() {
+  Proc p = m_stack.back();
+  m_stack.pop_back();
+  if (p.constants->output_defs().empty()) {
+    delete p.constants;
+    return "";
+  }
+  m_done.push_back(p);
+  return emit_logical_if_stmt("!" + done_name(p.c_name),
+			      emit_call0(init_name(p.c_name)) + ";\n");
+}
+
+void LazyConstants::abandon() {
+  while (!m_stack.empty()) {
+    delete m_stack.back().constants;
+    m_stack.pop_back();
+  }
+}
+
+SubexpBuffer * LazyConstants::buffer() {
+  if (m_stack.empty() || !m_stack.back().lazy) {
+    return ParseInfo::global_constants;
+  }
+  return m_stack.back().constants;
+}
+
+void LazyConstants::keep(string handle) {
+  if (m_stack.empty() || !m_stack.back().lazy) {
+    return;  // global constants stay on the protection stack
+  }
+  m_stack.back().handles.push_back(handle);
+}
+
+string LazyConstants::output_decls() const {
+  string decls;
+  list<Proc>::const_iterator p;
+  for (p = m_done.begin(); p != m_done.end(); ++p) {
+    decls += p->constants->output_decls();
+    decls += "static Rboolean " + done_name(p->c_name) + " = FALSE;\n";
+    decls += "static void " + init_name(p->c_name) + "();\n";
+  }
+  return decls;
+}
+
+string LazyConstants::output_defs() const {
+  string defs;
+  list<Proc>::const_iterator p;
+  for (p = m_done.begin(); p != m_done.end(); ++p) {
+    // The init function runs inside the procedure, so it leaves the
+    // protection stack as it found it and preserves its results.
+    string body = "int top = R_PPStackTop;\n";
+    body += p->constants->output_defs();
+    vector<string>::const_iterator h;
+    for (h = p->handles.begin(); h != p->handles.end(); ++h) {
+      body += emit_call1("R_PreserveObject", *h) + ";\n";
+    }
+    body += emit_assign("R_PPStackTop", "top");
+    body += emit_assign(done_name(p->c_name), "TRUE");
+    defs += "\nstatic void " + init_name(p->c_name) + "() " + emit_in_braces(body);
+  }
+  return defs;
+}
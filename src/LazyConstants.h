@@ -0,0 +1,94 @@
+// -*- Mode: C++ -*-
+//
+// Copyright (c) 2008 Rice University
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation; either version 2 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+
+
+// File: LazyConstants.h
+//
+// Constants owned by a single procedure, built on the procedure's
+// first entry instead of when the library is loaded.
+//
+// Author: John Garvin (garvin@cs.rice.edu)
+
+#ifndef LAZY_CONSTANTS_H
+#define LAZY_CONSTANTS_H
+
+#include <list>
+#include <string>
+#include <vector>
+
+class SubexpBuffer;
+
+/// Normally every literal list and closure in the program is built by
+/// the init functions called from R_init_<lib>, so loading a library
+/// costs time in proportion to everything compiled into it. With lazy
+/// constants, the literal lists and closures that appear inside a
+/// procedure's body (including the formals and code of the closures
+/// it defines) go into a buffer belonging to that procedure. The
+/// buffer becomes a static init function that the procedure calls,
+/// guarded by a flag, the first time it is entered. Constants at top
+/// level and memoized constants shared between procedures (symbols,
+/// strings, scalars, primitives) are still built eagerly.
+class LazyConstants {
+public:
+  static LazyConstants * instance();
+  /// Forget the instance, so the next compilation starts afresh
+  static void reset();
+
+  /// Start compiling the body of the procedure named c_name. Its
+  /// constants are lazy if lazy is true (the default being
+  /// -flazy-constants).
+  void enter(std::string c_name, bool lazy);
+
+  /// Finish the current procedure; return the statement that must
+  /// run on its entry, or the empty string if it owns no constants
+  std::string leave();
+
+  /// Forget procedures left unfinished by an exception
+  void abandon();
+
+  /// The buffer that should receive a constant built at this point:
+  /// the current procedure's if its constants are lazy, otherwise the
+  /// global constant buffer.
+  SubexpBuffer * buffer();
+
+  /// Record that handle, assigned in buffer(), must outlive the init
+  /// function that builds it
+  void keep(std::string handle);
+
+  /// C declarations of the constants, flags and init functions of
+  /// all finished procedures
+  std::string output_decls() const;
+
+  /// Definitions of the init functions
+  std::string output_defs() const;
+
+private:
+  LazyConstants() {}
+  static LazyConstants * s_instance;
+
+  struct Proc {
+    std::string c_name;
+    bool lazy;
+    SubexpBuffer * constants;
+    std::vector<std::string> handles;
+  };
+  std::list<Proc> m_stack;
+  std::list<Proc> m_done;
+};
+
+#endif
@@ -35,6 +35,23 @@ LoopContext * LoopContext::Top()
   return top;
 }
 
+void LoopContext::reset()
+{
+  mContextId = 0;
+  top = NULL;
+}
+
+const LoopContext::DirectSubscript * LoopContext::findDirectSubscript(SEXP e)
+{
+  for (LoopContext * c = top; c != NULL; c = c->enclosing) {
+    map<SEXP, DirectSubscript>::const_iterator it = c->mDirectSubscripts.find(e);
+    if (it != c->mDirectSubscripts.end()) {
+      return &it->second;
+    }
+  }
+  return NULL;
+}
+
 LoopContext::LoopContext()
 {
   mContextName = "loop_" + i_to_s(mContextId++);
@@ -58,3 +75,8 @@ string LoopContext::doBreak()
 {
   return "goto " + breakLabel();
 }
+
+void LoopContext::addDirectSubscript(SEXP e, const DirectSubscript & ds)
+{
+  mDirectSubscripts[e] = ds;
+}
@@ -25,20 +25,43 @@
 #ifndef LoopContext_h
 #define LoopContext_h
 
+#include <map>
 #include <string>
 
+#include <include/R/R_RInternals.h>
+
 class LoopContext {
+public:
+  /// C code for a subscript of the loop index that may be accessed
+  /// directly: the guard under which that is safe, the zero-based
+  /// element index, and the array's value fetched before the loop
+  /// (empty if the array must be evaluated at the access).
+  struct DirectSubscript {
+    std::string guard;
+    std::string index;
+    std::string array;
+  };
+
 public:
   static LoopContext *Top();
+
+  /// the direct subscript registered for expression e by this loop
+  /// or an enclosing one, or 0 if none
+  static const DirectSubscript * findDirectSubscript(SEXP e);
+
+  /// start numbering loops from zero again
+  static void reset();
 public:
   explicit LoopContext();
   ~LoopContext();
   std::string breakLabel();
   std::string doBreak();
+  void addDirectSubscript(SEXP e, const DirectSubscript & ds);
 
 private:
   std::string mContextName;
   LoopContext *enclosing;
+  std::map<SEXP, DirectSubscript> mDirectSubscripts;
 
 private:
   static unsigned int mContextId;
@@ -24,6 +24,8 @@
 // Author: John Garvin (garvin@cs.rice.edu)
 
 #include <iostream>
+#include <utility>
+#include <vector>
 
 #include <OpenAnalysis/CallGraph/ManagerCallGraph.hpp>
 #include <OpenAnalysis/DataFlow/CallGraphDFSolver.hpp>
@@ -32,16 +34,24 @@
 #include <OpenAnalysis/SideEffect/ManagerInterSideEffectStandard.hpp>
 #include <OpenAnalysis/Utils/OutputBuilderDOT.hpp>
 
+#include <BatchCompile.h>
 #include <CheckProtect.h>
 #include <include/R/R_Internal.h>
 
 #include <analysis/AnalysisException.h>
 #include <analysis/AnalysisResults.h>
+#include <analysis/ConstantFolder.h>
 #include <analysis/HandleInterface.h>
+#include <analysis/LexicalContext.h>
+#include <analysis/LoweredIR.h>
 #include <analysis/OACallGraphAnnotationMap.h>
+#include <analysis/Settings.h>
+#include <analysis/SpecialProcSymMap.h>
 #include <analysis/SymbolTable.h>
+#include <analysis/VarRefFactory.h>
 
 #include <support/Debug.h>
+#include <support/FileUtils.h>
 #include <support/RccError.h>
 #include <support/StringUtils.h>
 
@@ -52,11 +62,20 @@
 #include <CodeGenUtils.h>
 #include <CodeGen.h>
 #include <CommandLineArgs.h>
+#include <CompileCache.h>
+#include <CompileReport.h>
+#include <CompileServer.h>
+#include <ConstantPool.h>
 #include <CScope.h>
+#include <LazyConstants.h>
 #include <LoopContext.h>
 #include <Main.h>
+#include <Metrics.h>
 #include <Output.h>
+#include <OutputUnits.h>
 #include <ParseInfo.h>
+#include <ProfileData.h>
+#include <ProfileTable.h>
 
 using namespace std;
 using namespace RAnnot;
@@ -66,7 +85,23 @@ static bool output_main_program = true;
 static bool output_default_args = true;
 static bool analysis_debug;
 
-int main(int argc, char * argv[]) {
+// argv[0], for messages
+static string program_path;
+
+static int compile_program(CommandLineArgs * args);
+
+int rcc_compile(int argc, char * argv[]) {
+  program_path = argv[0];
+  CommandLineArgs * args = new CommandLineArgs(argc, argv);
+  ParseInfo::set_command_line_args(args);
+  if (args->get_input_files().size() > 1) {
+    return compile_batch(args, compile_program);
+  }
+  return compile_program(args);
+}
+
+/// Compile the one input selected by args
+static int compile_program(CommandLineArgs * args) {
   RCC_DEBUG("RCC_Main", analysis_debug);
 
   int i;
@@ -74,8 +109,14 @@ int main(int argc, char * argv[]) {
   FILE *in_file;
   int n_exprs;
 
-  CommandLineArgs * args = new CommandLineArgs(argc, argv);
-  ParseInfo::set_command_line_args(args);
+  if (!args->get_report_filename().empty()) {
+    CompileReport::instance()->enable(args->get_report_filename());
+  }
+  if (!args->get_profile_use_filename().empty() &&
+      !ProfileData::instance()->load(args->get_profile_use_filename()))
+  {
+    rcc_error("unable to read profile \"" + args->get_profile_use_filename() + "\"");
+  }
 
   // initialize ParseInfo buffers except global_fundefs.
   // Function definitions initialized after we have the library name.
@@ -90,7 +131,7 @@ int main(int argc, char * argv[]) {
   if (args->get_in_file_exists()) {
     in_file = fopen(fullname.c_str(), "r");
     if (in_file == NULL) {
-      string program = argv[0];
+      string program = program_path;
 
       string::size_type dot = program.rfind(".", program.length());
       if (dot != 0) program = program.substr(0, dot);
@@ -100,7 +141,7 @@ int main(int argc, char * argv[]) {
 
       // TODO: use rcc_error instead
       cerr << program << ": unable to open input file \"" << fullname << "\"" << endl;
-      exit(-1);
+      rcc_exit(-1);
     }
     int pos = filename_pos(fullname);
     path = fullname.substr(0,pos);
@@ -128,14 +169,62 @@ int main(int argc, char * argv[]) {
   // initialize ParseInfo::global_fundefs
   ParseInfo::global_fundefs = new SubexpBuffer(libname + "_f", TRUE);
 
-  ParseInfo::global_constants->decls += "static void exec();\n";
-  ParseInfo::global_constants->decls += "static void finish();\n";
-
   // parse
-  SEXP program = parse_R_as_function(in_file);
+  SEXP program;
+  {
+    ReportPhase phase("parse");
+    program = parse_R_as_function(in_file);
+  }
+  if (in_file != stdin) {
+    fclose(in_file);
+  }
+
+  // The output files, as (name in the cache, destination) pairs.
+  // With --split-units, -o names the output directory.
+  OutputUnits units(args->get_split_units());
+  vector<pair<string, string> > outputs;
+  string out_dir;
+  if (units.get_n() > 1) {
+    out_dir = (args->get_out_file_exists() ? args->get_out_filename() : path);
+    if (!out_dir.empty() && out_dir[out_dir.size() - 1] != '/') {
+      out_dir += "/";
+    }
+    vector<string> names = units.file_names(libname);
+    for (unsigned int k = 0; k < names.size(); k++) {
+      outputs.push_back(make_pair(names[k], out_dir + names[k]));
+    }
+  } else {
+    outputs.push_back(make_pair(libname + ".c", out_filename));
+  }
+
+  // reuse the output of an earlier compilation of the same program
+  CompileCache * cache = 0;
+  if (!args->get_cache_dir().empty()) {
+    string config = string("rcc ") + RCC_VERSION + "\n" + R_HOME + "\n" +
+      Settings::instance()->get_pp_info() +
+      "split_units: " + i_to_s(units.get_n()) + "\n" +
+      "output_main_program: " + i_to_s(output_main_program) + "\n" +
+      "libname: " + libname + "\n" +
+      "profile: " + ProfileData::instance()->get_text() + "\n";
+    cache = new CompileCache(args->get_cache_dir(),
+			     curly_body(CAR(fundef_body_c(CAR(assign_rhs_c(program))))),
+			     config);
+    if (cache->hit()) {
+      {
+	ReportPhase phase("output");
+	for (unsigned int k = 0; k < outputs.size(); k++) {
+	  cache->fetch(outputs[k].first, outputs[k].second);
+	}
+      }
+      CompileReport::instance()->write(fullname);
+      delete cache;
+      return 0;
+    }
+  }
 
   // perform analysis
   try {
+    ReportPhase phase("analysis");
     R_Analyst * an = R_Analyst::instance(program);
     an->perform_analysis();
 
@@ -168,8 +257,11 @@ int main(int argc, char * argv[]) {
   SEXP r_expressions = curly_body(CAR(fundef_body_c(CAR(assign_rhs_c(program)))));
 
   SubexpBuffer sb;
-  string program_str = sb.op_program(r_expressions, "R_GlobalEnv", file_initializer_name,
-				     output_main_program, output_default_args);
+  {
+    ReportPhase phase("codegen");
+    sb.op_program(r_expressions, "R_GlobalEnv", file_initializer_name,
+		  output_main_program, output_default_args, units);
+  }
 
   if (analysis_debug && ParseInfo::analysis_ok()) {
     // output call graph in DOT form
@@ -181,29 +273,104 @@ int main(int argc, char * argv[]) {
     OACallGraphAnnotationMap::instance()->dump(cout);
   }
 
-  if (ParseInfo::get_problem_flag()) {
-    out_filename += ".bad";
-    cerr << "Error: one or more problems compiling R code.\n"
-	 << "Outputting best attempt to " 
-	 << "\'" << out_filename << "\'.\n";
+  CompileReport::instance()->begin_phase("output");
+  if (units.get_n() > 1) {
+    string suffix;
+    if (ParseInfo::get_problem_flag()) {
+      suffix = ".bad";
+      cerr << "Error: one or more problems compiling R code.\n"
+	   << "Outputting best attempt to "
+	   << "\'" << out_dir << libname << "*" << suffix << "\'.\n";
+    }
+    units.write(out_dir, libname, suffix);
+  } else {
+    if (ParseInfo::get_problem_flag()) {
+      out_filename += ".bad";
+      cerr << "Error: one or more problems compiling R code.\n"
+	   << "Outputting best attempt to " 
+	   << "\'" << out_filename << "\'.\n";
+    }
+    write_file_if_changed(out_filename, units.single());
   }
-  ofstream out_file(out_filename.c_str());
-  if (!out_file) {
-    rcc_error("Couldn't open file " + out_filename + " for output");
+  if (cache != 0 && !ParseInfo::get_problem_flag()) {
+    for (unsigned int k = 0; k < outputs.size(); k++) {
+      cache->store(outputs[k].first, outputs[k].second);
+    }
+    cache->commit();
   }
+  delete cache;
+  CompileReport::instance()->end_phase();
 
-  out_file << program_str;
-  
-  if (!out_file) {
-    rcc_error("Couldn't write to file " + out_filename);
-  }
+  CompileReport::instance()->write(fullname);
   return (ParseInfo::get_problem_flag() ? 1 : 0);
 }
 
+void rcc_reset() {
+  analysisResults.reset();
+  R_Analyst::reset();
+  VarRefFactory::reset();
+  LoweredIR::reset();
+  SpecialProcSymMap::reset();
+  Settings::reset();
+  Metrics::reset();
+  CompileReport::reset();
+  ConstantPool::reset();
+  ConstantFolder::reset();
+  LazyConstants::reset();
+  ProfileTable::reset();
+  ProfileData::reset();
+  ParseInfo::reset();
+  LoopContext::reset();
+  CScope::reset();
+  while (!lexicalContext.IsEmpty()) {
+    lexicalContext.Pop();
+  }
+  SubexpBuffer::reset_counters();
+}
+
+int main(int argc, char * argv[]) {
+  // --server and --connect are handled here, before the compiler's
+  // own option parsing; --connect is not passed on to the compiler.
+  string server_path, connect_path;
+  vector<char *> compile_argv;
+  for (int k = 0; k < argc; k++) {
+    string arg = argv[k];
+    if (arg.compare(0, 9, "--server=") == 0) {
+      server_path = arg.substr(9);
+    } else if (arg.compare(0, 10, "--connect=") == 0) {
+      connect_path = arg.substr(10);
+    } else {
+      compile_argv.push_back(argv[k]);
+    }
+  }
+  compile_argv.push_back(0);
+  int compile_argc = compile_argv.size() - 1;
+
+  if (!server_path.empty()) {
+    return run_compile_server(server_path);
+  }
+  if (connect_path.empty() && getenv("RCC_SERVER") != 0) {
+    connect_path = getenv("RCC_SERVER");
+  }
+  if (!connect_path.empty()) {
+    int status;
+    if (run_compile_client(connect_path, compile_argc, &compile_argv[0], status)) {
+      return status;
+    }
+    // no server; compile here
+  }
+  return rcc_compile(compile_argc, &compile_argv[0]);
+}
+
 // initialize statics in SubexpBuffer
 unsigned int SubexpBuffer::n = 0;
 unsigned int SubexpBuffer::global_temps = 0;
 
+void SubexpBuffer::reset_counters() {
+  n = 0;
+  global_temps = 0;
+}
+
 /// Convert an Output into an Expression. Will go away as soon as
 /// everything uses Output instead of Expression.
 const Expression SubexpBuffer::output_to_expression(const Output op) {
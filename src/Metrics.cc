@@ -32,3 +32,8 @@ Metrics * Metrics::instance() {
   }
   return s_instance;
 }
+
+void Metrics::reset() {
+  delete s_instance;
+  s_instance = 0;
+}
@@ -47,6 +47,8 @@ private:								\
 class Metrics {
 public:
   static Metrics * instance();
+  /// Forget the instance, so the next compilation starts afresh
+  static void reset();
 
 public:
   INT_GETTER_INCREMENTER(procedures)
@@ -0,0 +1,194 @@
+// -*- Mode: C++ -*-
+//
+// Copyright (c) 2008 Rice University
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation; either version 2 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+
+
+// File: OutputUnits.cc
+//
+// The generated C program, either as one file or partitioned into
+// several translation units that can be compiled in parallel.
+//
+// Author: John Garvin (garvin@cs.rice.edu)
+
+#include <assert.h>
+#include <sstream>
+
+#include <support/FileUtils.h>
+#include <support/StringUtils.h>
+
+#include <OutputUnits.h>
+
+using namespace std;
+
+static const string STATIC = "static ";
+
+static string strip_static(string def);
+static bool is_prototype(const string & decl);
+
+OutputUnits::OutputUnits(int n)
+  : m_n(n), m_units(n), m_sizes(n, 0)
+{
+  assert(n >= 1);
+}
+
+void OutputUnits::set_prologue(const string & comment, const string & includes) {
+  m_comment = comment;
+  m_includes = includes;
+}
+
+void OutputUnits::add_decls(const string & decls) {
+  if (m_n == 1) {
+    m_decls += decls;
+    return;
+  }
+  istringstream in(decls);
+  string line;
+  while (getline(in, line)) {
+    if (line.compare(0, STATIC.size(), STATIC) != 0) {
+      m_extern_decls += line + "\n";
+      continue;
+    }
+    string decl = line.substr(STATIC.size());
+    if (is_prototype(decl)) {
+      // function prototype; the definition is made extern too
+      m_extern_decls += decl + "\n";
+    } else {
+      m_storage += decl + "\n";
+      string::size_type init = decl.find(" = ");
+      if (init != string::npos) {
+	decl = decl.substr(0, init) + ";";
+      }
+      m_extern_decls += "extern " + decl + "\n";
+    }
+  }
+}
+
+void OutputUnits::add_main(const string & code) {
+  m_main += code;
+  m_sizes[0] += code.size();
+}
+
+void OutputUnits::add_definitions(const string & defs) {
+  if (m_n == 1) {
+    m_defs += defs;
+    return;
+  }
+  const string END = "\n}\n";
+  string::size_type start = 0, end;
+  while (start < defs.size()) {
+    end = defs.find(END, start);
+    end = (end == string::npos ? defs.size() : end + END.size());
+    string def = defs.substr(start, end - start);
+    start = end;
+
+    // put each definition in the smallest unit so far
+    int smallest = 0;
+    for (int i = 1; i < m_n; i++) {
+      if (m_sizes[i] < m_sizes[smallest]) smallest = i;
+    }
+    m_units[smallest] += strip_static(def);
+    m_sizes[smallest] += def.size();
+  }
+}
+
+string OutputUnits::single() const {
+  assert(m_n == 1);
+  return m_comment + m_includes + m_decls + m_main + m_defs;
+}
+
+vector<string> OutputUnits::file_names(const string & libname) const {
+  vector<string> names;
+  names.push_back(libname + ".h");
+  for (int i = 0; i < m_n; i++) {
+    names.push_back(libname + "_" + i_to_s(i) + ".c");
+  }
+  names.push_back(libname + ".mk");
+  return names;
+}
+
+void OutputUnits::write(const string & dir, const string & libname,
+			const string & suffix) const
+{
+  vector<string> names = file_names(libname);
+  const string & header = names.front();
+  vector<string> units(names.begin() + 1, names.end() - 1);
+
+  string guard = "RCC_" + libname + "_H";
+  write_file_if_changed(dir + header + suffix,
+			"#ifndef " + guard + "\n#define " + guard + "\n\n" +
+			m_includes + m_extern_decls +
+			"\n#endif\n");
+
+  for (int i = 0; i < m_n; i++) {
+    string text = "#include \"" + header + "\"\n\n";
+    if (i == 0) {
+      text = m_comment + text + m_storage + m_main;
+    }
+    text += m_units[i];
+    write_file_if_changed(dir + units[i] + suffix, text);
+  }
+
+  write_file_if_changed(dir + names.back() + suffix, makefile(libname, units));
+}
+
+string OutputUnits::makefile(const string & libname,
+			     const vector<string> & units)
+{
+  string objs_var = libname + "_OBJS";
+  string mk;
+  mk += "# Generated by rcc. Compile the units of " + libname + " in parallel:\n";
+  mk += "#   make -j -f " + libname + ".mk\n\n";
+  mk += "RCC_CC ?= rcc-cc\n\n";
+  mk += objs_var + " =";
+  for (unsigned int i = 0; i < units.size(); i++) {
+    mk += " " + strip_suffix(units[i]) + ".o";
+  }
+  mk += "\n\n";
+  mk += libname + ".so: $(" + objs_var + ")\n";
+  mk += "\t$(RCC_CC) -shared -o $@ $(" + objs_var + ")\n";
+  for (unsigned int i = 0; i < units.size(); i++) {
+    string obj = strip_suffix(units[i]) + ".o";
+    mk += "\n" + obj + ": " + units[i] + " " + libname + ".h\n";
+    mk += "\t$(RCC_CC) -fPIC -c -o $@ " + units[i] + "\n";
+  }
+  return mk;
+}
+
+/// Whether a declaration is a function prototype: it ends in ");"
+/// and has no initializer. A variable may have parentheses in its
+/// initializer or declarator, as in "SEXP (*f)(SEXP);".
+static bool is_prototype(const string & decl) {
+  string::size_type end = decl.find_last_not_of(" \t");
+  return end != string::npos && end >= 1 &&
+    decl.compare(end - 1, 2, ");") == 0 &&
+    decl.find('=') == string::npos &&
+    decl.find("(*") == string::npos;
+}
+
+/// Give a definition external linkage by removing "static" from the
+/// lines that start in column 0.
+static string strip_static(string def) {
+  if (def.compare(0, STATIC.size(), STATIC) == 0) {
+    def.erase(0, STATIC.size());
+  }
+  const string NL_STATIC = "\n" + STATIC;
+  string::size_type pos;
+  while ((pos = def.find(NL_STATIC)) != string::npos) {
+    def.erase(pos + 1, STATIC.size());
+  }
+  return def;
+}
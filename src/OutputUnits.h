@@ -0,0 +1,93 @@
+// -*- Mode: C++ -*-
+//
+// Copyright (c) 2008 Rice University
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation; either version 2 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+
+
+// File: OutputUnits.h
+//
+// The generated C program, either as one file or partitioned into
+// several translation units that can be compiled in parallel.
+//
+// Author: John Garvin (garvin@cs.rice.edu)
+
+#ifndef OUTPUT_UNITS_H
+#define OUTPUT_UNITS_H
+
+#include <string>
+#include <vector>
+
+/// A generated program has four parts: a prologue (the metrics
+/// comment and #includes), file-scope declarations, the main code (the
+/// R_init function, exec, finish and main) and the definitions of
+/// constant init functions and procedures.
+///
+/// With one unit, the parts are concatenated as they always have
+/// been. With N units, the output is:
+///
+///   <lib>.h       #includes plus an extern declaration of everything
+///   <lib>_0.c     the metrics comment, storage for the declarations
+///                 and the main code
+///   <lib>_<i>.c   the definitions, balanced by size over all units
+///   <lib>.mk      make rules that compile the units with rcc-cc and
+///                 link them into <lib>.so
+///
+/// Declarations are one per line, as the code generator emits them.
+/// A definition ends with a closing brace in column 0. Everything
+/// file-scope becomes extern so the units can see each other, except
+/// exec and finish, which only the main code uses.
+class OutputUnits {
+public:
+  explicit OutputUnits(int n);
+
+  int get_n() const { return m_n; }
+
+  void set_prologue(const std::string & comment, const std::string & includes);
+  void add_decls(const std::string & decls);
+  void add_main(const std::string & code);
+  void add_definitions(const std::string & defs);
+
+  /// The whole program as a single file; only valid with one unit
+  std::string single() const;
+
+  /// Names of the files written with more than one unit: the
+  /// header, the units in order, then the Makefile fragment
+  std::vector<std::string> file_names(const std::string & libname) const;
+
+  /// Write the header, the units and the Makefile fragment into dir
+  /// (empty or ending in '/'). suffix is appended to each file name.
+  /// Files whose contents are unchanged are left alone, so make only
+  /// recompiles the units that changed.
+  void write(const std::string & dir, const std::string & libname,
+	     const std::string & suffix) const;
+
+private:
+  static std::string makefile(const std::string & libname,
+			      const std::vector<std::string> & units);
+
+  const int m_n;
+  std::string m_comment;
+  std::string m_includes;
+  std::string m_decls;          // single unit: declarations as given
+  std::string m_extern_decls;   // N units: the shared header
+  std::string m_storage;        // N units: storage in unit 0
+  std::string m_main;
+  std::string m_defs;           // single unit: definitions as given
+  std::vector<std::string> m_units;
+  std::vector<std::string::size_type> m_sizes;
+};
+
+#endif
@@ -26,6 +26,9 @@
 #include <set>
 #include <map>
 
+#include <codegen/SubexpBuffer/SubexpBuffer.h>
+#include <codegen/SubexpBuffer/SplitSubexpBuffer.h>
+
 #include "ParseInfo.h"
 
 using namespace std;
@@ -54,6 +57,32 @@ bool ParseInfo::s_allow_special_redef = true;
 bool ParseInfo::s_allow_builtin_redef = true;
 bool ParseInfo::s_allow_library_redef = true;
 
+void ParseInfo::reset() {
+  s_func_map.clear();
+  s_symbol_map.clear();
+  s_string_map.clear();
+  s_real_map.clear();
+  s_logical_map.clear();
+  s_integer_map.clear();
+  s_primsxp_map.clear();
+  s_binding_map.clear();
+  delete global_fundefs;
+  global_fundefs = 0;
+  delete global_constants;
+  global_constants = 0;
+  delete global_labels;
+  global_labels = 0;
+  delete s_cl_args;
+  s_cl_args = 0;
+  s_problem_flag = false;
+  s_analysis_ok = true;
+  s_allow_oo = true;
+  s_allow_envir_manip = true;
+  s_allow_special_redef = true;
+  s_allow_builtin_redef = true;
+  s_allow_library_redef = true;
+}
+
 void ParseInfo::set_command_line_args(CommandLineArgs * x) {
   s_cl_args = x;
 }
@@ -43,6 +43,10 @@ public:
   static SplitSubexpBuffer * global_constants;
   static SubexpBuffer * global_labels;
 
+  /// Forget everything about the last compilation: the constant
+  /// maps, the global buffers, the flags and the command line.
+  static void reset();
+
   static void set_command_line_args(CommandLineArgs * cl_args);
   static CommandLineArgs * get_command_line_args();
 
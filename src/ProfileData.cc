@@ -0,0 +1,134 @@
+// -*- Mode: C++ -*-
+//
+// Copyright (c) 2009 Rice University
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation; either version 2 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+
+
+// File: ProfileData.cc
+//
+// A runtime profile written by code compiled with -fprofile, read
+// back with --profile-use to guide compilation.
+//
+// Author: John Garvin (garvin@cs.rice.edu)
+
+#include <stdlib.h>
+
+#include <algorithm>
+#include <sstream>
+#include <vector>
+
+#include <support/FileUtils.h>
+
+#include <ProfileData.h>
+
+using namespace std;
+
+static const string FUNCTION = "function";
+
+ProfileData * ProfileData::s_instance = 0;
+
+ProfileData * ProfileData::instance() {
+  if (s_instance == 0) {
+    s_instance = new ProfileData();
+  }
+  return s_instance;
+}
+
+void ProfileData::reset() {
+  delete s_instance;
+  s_instance = 0;
+}
+
+static vector<string> split_tabs(const string & line) {
+  vector<string> fields;
+  string::size_type start = 0, tab;
+  while ((tab = line.find('\t', start)) != string::npos) {
+    fields.push_back(line.substr(start, tab - start));
+    start = tab + 1;
+  }
+  fields.push_back(line.substr(start));
+  return fields;
+}
+
+bool ProfileData::load(const string & filename) {
+  if (!read_file(filename, m_text)) {
+    return false;
+  }
+  istringstream in(m_text);
+  string line;
+  while (getline(in, line)) {
+    if (line.empty() || line[0] == '#') continue;
+    // kind, module, name, caller, count, ticks
+    vector<string> f = split_tabs(line);
+    if (f.size() != 6) continue;
+    Counts & c = m_counts[f[0] + "\t" + f[2]];
+    c.count += strtoul(f[4].c_str(), 0, 10);
+    c.ticks += strtoull(f[5].c_str(), 0, 10);
+  }
+  m_loaded = true;
+  return true;
+}
+
+ProfileData::Counts ProfileData::get(const string & kind, const string & name) const {
+  map<string, Counts>::const_iterator it = m_counts.find(kind + "\t" + name);
+  return (it == m_counts.end() ? Counts() : it->second);
+}
+
+bool ProfileData::is_cold(const string & r_name) const {
+  return m_loaded && get(FUNCTION, r_name).count == 0;
+}
+
+void ProfileData::note_proc(const string & c_name, const string & r_name) {
+  m_r_names[c_name] = r_name;
+}
+
+/// Ticks of the function a definition defines, found by the name
+/// before the first parenthesis
+unsigned long long ProfileData::c_ticks(const string & def) const {
+  string::size_type paren = def.find('(');
+  if (paren == string::npos) return 0;
+  string::size_type start = def.find_last_of(" \t\n*", paren);
+  start = (start == string::npos ? 0 : start + 1);
+  map<string, string>::const_iterator r = m_r_names.find(def.substr(start, paren - start));
+  if (r == m_r_names.end()) return 0;
+  return get(FUNCTION, r->second).ticks;
+}
+
+typedef pair<unsigned long long, string> Def;
+
+static bool hotter(const Def & x, const Def & y) {
+  return x.first > y.first;
+}
+
+string ProfileData::order_definitions(const string & defs) const {
+  if (!m_loaded) return defs;
+  const string END = "\n}\n";
+  vector<Def> v;
+  string::size_type start = 0, end;
+  while (start < defs.size()) {
+    end = defs.find(END, start);
+    end = (end == string::npos ? defs.size() : end + END.size());
+    string def = defs.substr(start, end - start);
+    v.push_back(make_pair(c_ticks(def), def));
+    start = end;
+  }
+  stable_sort(v.begin(), v.end(), hotter);
+  string out;
+  for (vector<Def>::const_iterator it = v.begin(); it != v.end(); ++it) {
+    out += it->second;
+  }
+  return out;
+}
@@ -0,0 +1,88 @@
+// -*- Mode: C++ -*-
+//
+// Copyright (c) 2009 Rice University
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation; either version 2 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+
+
+// File: ProfileData.h
+//
+// A runtime profile written by code compiled with -fprofile, read
+// back with --profile-use to guide compilation.
+//
+// Author: John Garvin (garvin@cs.rice.edu)
+
+#ifndef PROFILE_DATA_H
+#define PROFILE_DATA_H
+
+#include <map>
+#include <string>
+
+/// Counts and ticks for the entries of a profile (see rcc_profile.h),
+/// summed over modules and over entries with the same kind and name.
+/// Entries are named by R name; generated C names are recorded as
+/// procedures are compiled so that the output can be ordered.
+///
+/// The profile drives two decisions:
+///  - procedures that never ran get lazy constants (as with
+///    -flazy-constants), so loading the library doesn't pay for them;
+///  - function definitions are output hottest first, keeping the
+///    code that runs together close together.
+class ProfileData {
+public:
+  static ProfileData * instance();
+  /// Forget the instance, so the next compilation starts afresh
+  static void reset();
+
+  /// Read a profile; return false if the file can't be read
+  bool load(const std::string & filename);
+
+  bool loaded() const { return m_loaded; }
+
+  /// The profile as read, or empty if none is loaded
+  const std::string & get_text() const { return m_text; }
+
+  struct Counts {
+    Counts() : count(0), ticks(0) {}
+    unsigned long count;
+    unsigned long long ticks;
+  };
+
+  /// The counts of an entry; zero if it is not in the profile
+  Counts get(const std::string & kind, const std::string & name) const;
+
+  /// Whether a profile is loaded and the function never ran
+  bool is_cold(const std::string & r_name) const;
+
+  /// Record the R name of a generated C function
+  void note_proc(const std::string & c_name, const std::string & r_name);
+
+  /// Reorder a sequence of function definitions, hottest first. The
+  /// order of functions with equal ticks is kept.
+  std::string order_definitions(const std::string & defs) const;
+
+private:
+  ProfileData() : m_loaded(false) {}
+  static ProfileData * s_instance;
+
+  unsigned long long c_ticks(const std::string & def) const;
+
+  bool m_loaded;
+  std::string m_text;
+  std::map<std::string, Counts> m_counts;        // by "kind\tname"
+  std::map<std::string, std::string> m_r_names;  // by C name
+};
+
+#endif
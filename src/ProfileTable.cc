@@ -0,0 +1,179 @@
+// -*- Mode: C++ -*-
+//
+// Copyright (c) 2009 Rice University
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation; either version 2 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+
+
+// File: ProfileTable.cc
+//
+// The table of counters emitted into code compiled with -fprofile.
+//
+// Author: John Garvin (garvin@cs.rice.edu)
+
+#include <cassert>
+
+#include <include/R/R_RInternals.h>
+
+#include <analysis/FuncInfo.h>
+#include <analysis/LexicalContext.h>
+#include <analysis/Settings.h>
+#include <analysis/Utils.h>
+
+#include <support/StringUtils.h>
+
+#include <CodeGenUtils.h>
+
+#include <ProfileTable.h>
+
+using namespace std;
+using namespace RAnnot;
+
+static const string TABLE = "rcc_profile_table";
+static const string INFO = "rcc_profile_info";
+
+ProfileTable * ProfileTable::s_instance = 0;
+
+ProfileTable * ProfileTable::instance() {
+  if (s_instance == 0) {
+    s_instance = new ProfileTable();
+  }
+  return s_instance;
+}
+
+void ProfileTable::reset() {
+  delete s_instance;
+  s_instance = 0;
+}
+
+bool ProfileTable::functions() const {
+  return Settings::instance()->get_profile() || sites();
+}
+
+bool ProfileTable::sites() const {
+  return Settings::instance()->get_profile_sites();
+}
+
+string ProfileTable::add(const string & kind, const string & name, const string & caller) {
+  Entry e;
+  e.kind = kind;
+  e.name = name;
+  e.caller = caller;
+  m_entries.push_back(e);
+  return TABLE + "[" + i_to_s(m_entries.size() - 1) + "]";
+}
+
+string ProfileTable::add_loop(const string & kind) {
+  string proc = current_proc();
+  int n = ++m_loops[proc];
+  return add("loop", proc + ":" + kind + "#" + i_to_s(n));
+}
+
+string ProfileTable::proc_name(FuncInfo * fi) {
+  SEXP name_c = fi->get_first_name_c();
+  if (name_c != 0 && TYPEOF(CAR(name_c)) == SYMSXP) {
+    return var_name(CAR(name_c));
+  } else {
+    return fi->get_c_name();
+  }
+}
+
+string ProfileTable::current_proc() {
+  if (lexicalContext.IsEmpty()) {
+    return "<top level>";
+  } else {
+    return proc_name(lexicalContext.Top());
+  }
+}
+
+string ProfileTable::output_decls() const {
+  return "static rcc_profile_entry " + TABLE + "[" + i_to_s(m_entries.size()) + "];\n";
+}
+
+string ProfileTable::output_data() const {
+  string out = "static const char * const " + INFO + "[] = {\n";
+  vector<Entry>::const_iterator it;
+  for (it = m_entries.begin(); it != m_entries.end(); ++it) {
+    out += indent(quote(escape(it->kind)) + ", " +
+		  quote(escape(it->name)) + ", " +
+		  quote(escape(it->caller)) + ",\n");
+  }
+  return out + "};\n";
+}
+
+string ProfileTable::output_register(const string & module) const {
+  return emit_call4("rcc_profile_register", quote(escape(module)), TABLE, INFO,
+		    i_to_s(m_entries.size())) + ";\n";
+}
+
+string ProfileTable::emit_start_decl(const string & start) {
+  return "rcc_profile_ticks " + start + ";\n";
+}
+
+string ProfileTable::emit_start(const string & entry, const string & start) {
+  return emit_count(entry) + emit_clock(start);
+}
+
+string ProfileTable::emit_stop(const string & entry, const string & start) {
+  return "RCC_PROFILE_ADD(" + entry + ", " + start + ");\n";
+}
+
+string ProfileTable::emit_count(const string & entry) {
+  return "RCC_PROFILE_COUNT(" + entry + ");\n";
+}
+
+string ProfileTable::emit_clock(const string & start) {
+  return emit_assign(start, emit_call0("rcc_profile_now"));
+}
+
+void ProfileTable::enter_proc(const string & entry, const string & start) {
+  Timer t;
+  t.entry = entry;
+  t.start = start;
+  t.proc = true;
+  m_timers.push_back(t);
+}
+
+void ProfileTable::leave_proc() {
+  while (!m_timers.empty()) {
+    bool proc = m_timers.back().proc;
+    m_timers.pop_back();
+    if (proc) break;
+  }
+}
+
+void ProfileTable::push_timer(const string & entry, const string & start) {
+  Timer t;
+  t.entry = entry;
+  t.start = start;
+  t.proc = false;
+  m_timers.push_back(t);
+}
+
+void ProfileTable::pop_timer() {
+  assert(!m_timers.empty() && !m_timers.back().proc);
+  m_timers.pop_back();
+}
+
+string ProfileTable::emit_return_stops() const {
+  string out;
+  for (int i = m_timers.size() - 1; i >= 0; i--) {
+    if (!m_timers[i].entry.empty()) {
+      out += emit_stop(m_timers[i].entry, m_timers[i].start);
+    }
+    if (m_timers[i].proc) break;
+  }
+  return out;
+}
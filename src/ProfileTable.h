@@ -0,0 +1,122 @@
+// -*- Mode: C++ -*-
+//
+// Copyright (c) 2009 Rice University
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation; either version 2 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+
+
+// File: ProfileTable.h
+//
+// The table of counters emitted into code compiled with -fprofile.
+//
+// Author: John Garvin (garvin@cs.rice.edu)
+
+#ifndef PROFILE_TABLE_H
+#define PROFILE_TABLE_H
+
+#include <map>
+#include <string>
+#include <vector>
+
+namespace RAnnot { class FuncInfo; }
+
+/// With -fprofile, every compiled function counts its activations
+/// and the ticks spent in them; -fprofile-sites adds the same for
+/// each call to a closure and each loop. The counters live in one
+/// static array per module, described to the runtime (rcc_profile.h)
+/// by a parallel array of strings, and the module registers both in
+/// finish(). Entries are named by R name, not C name, so that
+/// profiles can be matched against later compilations.
+class ProfileTable {
+public:
+  static ProfileTable * instance();
+  /// Forget the instance, so the next compilation starts afresh
+  static void reset();
+
+  /// Whether to instrument function entry and exit
+  bool functions() const;
+
+  /// Whether to instrument call sites and loops
+  bool sites() const;
+
+  /// Add an entry and return the C lvalue naming it
+  std::string add(const std::string & kind, const std::string & name,
+		  const std::string & caller = "");
+
+  /// Add an entry for a loop of the given kind in the current
+  /// procedure, named <procedure>:<kind>#<n>
+  std::string add_loop(const std::string & kind);
+
+  /// The R name of a procedure, or its C name if it has none
+  static std::string proc_name(RAnnot::FuncInfo * fi);
+
+  /// The R name of the procedure being compiled
+  static std::string current_proc();
+
+  bool empty() const { return m_entries.empty(); }
+
+  /// Declaration of the counter array
+  std::string output_decls() const;
+
+  /// The strings describing each entry
+  std::string output_data() const;
+
+  /// Statement registering the table, for finish()
+  std::string output_register(const std::string & module) const;
+
+  /// Code to count and time a region: the declaration of the start
+  /// time, the statements at the start, and the statements at the end
+  static std::string emit_start_decl(const std::string & start);
+  static std::string emit_start(const std::string & entry, const std::string & start);
+  static std::string emit_stop(const std::string & entry, const std::string & start);
+
+  /// The parts of emit_start, for loops, which count iterations
+  static std::string emit_count(const std::string & entry);
+  static std::string emit_clock(const std::string & start);
+
+  /// The timers running where code is being generated, so that a
+  /// return can stop the ones it leaves. enter_proc and leave_proc
+  /// bracket a procedure's body, with its timer if it has one;
+  /// push_timer and pop_timer bracket a loop's.
+  void enter_proc(const std::string & entry, const std::string & start);
+  void leave_proc();
+  void push_timer(const std::string & entry, const std::string & start);
+  void pop_timer();
+
+  /// Code for a return from the current procedure: stops for its
+  /// running timers, innermost first
+  std::string emit_return_stops() const;
+
+private:
+  ProfileTable() {}
+  static ProfileTable * s_instance;
+
+  struct Entry {
+    std::string kind;
+    std::string name;
+    std::string caller;
+  };
+  std::vector<Entry> m_entries;
+  std::map<std::string, int> m_loops;   // loops so far in each procedure
+
+  struct Timer {
+    std::string entry;   // empty for a procedure without a timer
+    std::string start;
+    bool proc;
+  };
+  std::vector<Timer> m_timers;
+};
+
+#endif
@@ -0,0 +1,489 @@
+// -*- Mode: C++ -*-
+//
+// Copyright (c) 2008 Rice University
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation; either version 2 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+
+// File: ProtectPlanner.cc
+//
+// Post-pass over generated C code that removes unnecessary traffic on
+// the R protect stack.
+//
+// The planner simulates the protect stack over straight-line runs of
+// generated statements, one statement per line. For each handle
+// pushed in the current run it remembers whether any statement since
+// the push may allocate (and therefore trigger a garbage
+// collection). A handle that is popped before anything allocates
+// never needed protecting. A handle popped by UNPROTECT_PTR while it
+// is on top of the simulated stack can be popped by index instead.
+//
+// The planner is off unless -fprotect-elision is given.
+//
+// Handles are matched by name, so code in which a protected variable
+// is assigned more than once is left alone. Any call not known to be
+// an R accessor that cannot allocate is assumed to allocate.
+//
+// Author: John Garvin (garvin@cs.rice.edu)
+
+#include <cctype>
+#include <cstdlib>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+#include <support/StringUtils.h>
+
+#include <CheckProtect.h>
+
+#include "ProtectPlanner.h"
+
+// The planner reads the generated text, not the code generator's
+// handles, so a debug build must check what it does: the assertions
+// on the stack depth it adds and the balance check at each return.
+#if !defined(NDEBUG) && !defined(CHECK_PROTECT)
+#error "the protect planner needs CHECK_PROTECT in a debug build"
+#endif
+
+using namespace std;
+
+typedef enum {
+  BLANK,            // nothing but whitespace and comments
+  BARRIER,          // ends the current run
+  PROTECT_ASSIGN,   // PROTECT(x = ...);
+  PUSH,             // PROTECT(x); or SAFE_PROTECT(x);
+  UNPROTECT_N,      // UNPROTECT(n);
+  UNPROTECT_P,      // UNPROTECT_PTR(x);
+  OTHER             // any other statement
+} LineKind;
+
+struct Line {
+  string text;      // original text, no newline
+  string lead;      // leading whitespace
+  string stmt;      // text without comments or string contents, trimmed
+  LineKind kind;
+  string var;       // handle pushed or popped
+  int count;        // number of handles popped by UNPROTECT_N
+  bool allocates;
+  bool deleted;
+  vector<string> check_vars;  // under CHECK_PROTECT, handles asserted to be
+  vector<int> check_depths;   //   at these depths below the top of the stack
+};
+
+struct Entry {
+  unsigned int line;   // line that pushed the handle
+  string var;
+  bool alloc_since;    // whether anything may have allocated since
+};
+
+static void split_lines(const string & code, vector<Line> & lines);
+static void classify(Line & line);
+static bool may_allocate(const string & stmt);
+static bool reassigns_protected(const vector<Line> & lines);
+static bool parse_call1(const string & stmt, const string & fname, string & arg);
+static bool is_identifier(const string & s);
+static void elide_push(Line & line);
+static void set_unprotect_count(Line & line, int n);
+static void coalesce_unprotects(vector<Line> & lines);
+
+string plan_protection(const string & code) {
+  vector<Line> lines;
+  split_lines(code, lines);
+  if (reassigns_protected(lines)) return code;
+
+  vector<Entry> known;
+  for (unsigned int i = 0; i < lines.size(); i++) {
+    Line & line = lines[i];
+    switch (line.kind) {
+    case BLANK:
+      break;
+    case BARRIER:
+      known.clear();
+      break;
+    case OTHER:
+      if (line.allocates) {
+	for (unsigned int k = 0; k < known.size(); k++) known[k].alloc_since = true;
+      }
+      break;
+    case PROTECT_ASSIGN:
+    case PUSH:
+      {
+	// the right side is evaluated before the push
+	if (line.allocates) {
+	  for (unsigned int k = 0; k < known.size(); k++) known[k].alloc_since = true;
+	}
+	Entry e;
+	e.line = i;
+	e.var = line.var;
+	e.alloc_since = false;
+	known.push_back(e);
+      }
+      break;
+    case UNPROTECT_N:
+      {
+	int remaining = line.count;
+	int n = line.count;
+	while (remaining > 0 && !known.empty()) {
+	  Entry e = known.back();
+	  known.pop_back();
+	  remaining--;
+	  if (!e.alloc_since) {
+	    elide_push(lines[e.line]);
+	    n--;
+	  }
+	}
+	if (remaining > 0) {
+	  // popped past the start of the run
+	  known.clear();
+	}
+	if (n != line.count) set_unprotect_count(line, n);
+      }
+      break;
+    case UNPROTECT_P:
+      {
+	int k;
+	for (k = known.size() - 1; k >= 0; k--) {
+	  if (known[k].var == line.var) break;
+	}
+	if (k < 0) {
+	  // may remove an entry we are tracking under another name
+	  known.clear();
+	  break;
+	}
+	if (!known[k].alloc_since) {
+	  elide_push(lines[known[k].line]);
+	  line.deleted = true;
+	} else if (k == (int)known.size() - 1) {
+#ifdef CHECK_PROTECT
+	  line.check_vars.push_back(line.var);
+	  line.check_depths.push_back(0);
+#endif
+	  line.kind = UNPROTECT_N;
+	  set_unprotect_count(line, 1);
+	}
+	known.erase(known.begin() + k);
+      }
+      break;
+    }
+  }
+
+  coalesce_unprotects(lines);
+
+  string out;
+  for (unsigned int i = 0; i < lines.size(); i++) {
+    if (lines[i].deleted) continue;
+    for (unsigned int c = 0; c < lines[i].check_vars.size(); c++) {
+      out += lines[i].lead + "assert(R_PPStack[R_PPStackTop - " +
+	i_to_s(lines[i].check_depths[c] + 1) + "] == " + lines[i].check_vars[c] + ");\n";
+    }
+    out += lines[i].text + "\n";
+  }
+  if (!code.empty() && code[code.size() - 1] != '\n' && !out.empty()) {
+    out.erase(out.size() - 1);
+  }
+  return out;
+}
+
+// Split code into lines and compute the statement part of each. A
+// comment may continue over several lines.
+static void split_lines(const string & code, vector<Line> & lines) {
+  bool in_comment = false;
+  string::size_type start = 0;
+  while (start < code.size()) {
+    string::size_type end = code.find('\n', start);
+    if (end == string::npos) end = code.size();
+    Line line;
+    line.text = code.substr(start, end - start);
+    line.count = 0;
+    line.allocates = false;
+    line.deleted = false;
+
+    string stmt;
+    const string & t = line.text;
+    for (string::size_type i = 0; i < t.size(); i++) {
+      if (in_comment) {
+	if (t.compare(i, 2, "*/") == 0) {
+	  in_comment = false;
+	  i++;
+	}
+      } else if (t.compare(i, 2, "/*") == 0) {
+	in_comment = true;
+	i++;
+      } else if (t[i] == '"' || t[i] == '\'') {
+	// keep the quotes, drop the contents
+	char q = t[i];
+	stmt += q;
+	for (i++; i < t.size() && t[i] != q; i++) {
+	  if (t[i] == '\\') i++;
+	}
+	stmt += q;
+      } else {
+	stmt += t[i];
+      }
+    }
+    string::size_type first = stmt.find_first_not_of(" \t");
+    string::size_type last = stmt.find_last_not_of(" \t");
+    line.stmt = (first == string::npos ? "" : stmt.substr(first, last - first + 1));
+    line.lead = t.substr(0, t.find_first_not_of(" \t") == string::npos
+			 ? t.size() : t.find_first_not_of(" \t"));
+    classify(line);
+    lines.push_back(line);
+    start = end + 1;
+  }
+}
+
+static void classify(Line & line) {
+  static const char * const keywords[] = {
+    "if", "else", "for", "while", "do", "switch", "case", "default",
+    "goto", "break", "continue", "return", 0
+  };
+  const string & s = line.stmt;
+  string arg;
+
+  if (s.empty()) {
+    line.kind = BLANK;
+    return;
+  }
+  line.kind = BARRIER;
+  if (s[s.size() - 1] != ';') return;    // blocks, multi-line statements
+  if (s.find_first_of("{}") != string::npos) return;
+  for (int i = 0; keywords[i] != 0; i++) {
+    string k = keywords[i];
+    if (s.compare(0, k.size(), k) == 0 &&
+	(s.size() == k.size() || !(isalnum(s[k.size()]) || s[k.size()] == '_'))) {
+      return;
+    }
+  }
+  string::size_type colon = s.find(':');
+  if (colon != string::npos && colon > 0 && is_identifier(s.substr(0, s.find_last_not_of(" \t", colon - 1) + 1))) {
+    return;  // label
+  }
+  // code that reads or changes the stack in ways we don't model
+  if (s.find("R_PPStack") != string::npos ||
+      s.find("rcc_list") != string::npos ||
+      s.find("rcc_tagged_list") != string::npos ||
+      s.find("rcc_cons") != string::npos ||
+      s.find("SETJMP") != string::npos) {
+    return;
+  }
+
+  if (parse_call1(s, "UNPROTECT_PTR", arg)) {
+    if (is_identifier(arg)) {
+      line.kind = UNPROTECT_P;
+      line.var = arg;
+    }
+    return;
+  }
+  if (parse_call1(s, "UNPROTECT", arg)) {
+    if (!arg.empty() && arg.find_first_not_of("0123456789") == string::npos) {
+      line.kind = UNPROTECT_N;
+      line.count = atoi(arg.c_str());
+    }
+    return;
+  }
+  if (parse_call1(s, "SAFE_PROTECT", arg)) {
+    if (is_identifier(arg)) {
+      line.kind = PUSH;
+      line.var = arg;
+    }
+    return;
+  }
+  if (parse_call1(s, "PROTECT", arg)) {
+    string::size_type eq = arg.find('=');
+    if (is_identifier(arg)) {
+      line.kind = PUSH;
+      line.var = arg;
+    } else if (eq != string::npos && eq + 1 < arg.size() && arg[eq + 1] != '=') {
+      string lhs = arg.substr(0, eq);
+      lhs = lhs.substr(0, lhs.find_last_not_of(" \t") + 1);
+      if (is_identifier(lhs)) {
+	line.kind = PROTECT_ASSIGN;
+	line.var = lhs;
+	line.allocates = may_allocate(arg.substr(eq + 1));
+      }
+    }
+    return;
+  }
+  if (s.find("PROTECT") != string::npos) {
+    return;  // PROTECT_WITH_INDEX, REPROTECT, nested PROTECT
+  }
+  line.kind = OTHER;
+  line.allocates = may_allocate(s);
+}
+
+// Whether a statement may allocate: true if it calls anything but a
+// few R accessors known not to. Helpers in the rcc library are not
+// listed; they may change without the planner hearing about it. Nor
+// are the variable location functions, which run active bindings.
+static bool may_allocate(const string & stmt) {
+  static set<string> non_allocating;
+  if (non_allocating.empty()) {
+    const char * const names[] = {
+      "CAR", "CDR", "CADR", "CDDR", "CADDR", "TAG", "TYPEOF", "LENGTH",
+      "Rf_length", "length", "REAL", "INTEGER", "LOGICAL", "COMPLEX",
+      "STRING_ELT", "VECTOR_ELT", "SET_VECTOR_ELT", "SETCAR", "SETCDR",
+      "SET_TAG", "ATTRIB", "NAMED", "SET_NAMED", "PRVALUE", "PRCODE",
+      "PRENV", "assert", "sizeof", "ISNAN", 0
+    };
+    for (int i = 0; names[i] != 0; i++) non_allocating.insert(names[i]);
+  }
+  string::size_type i = 0;
+  while (i < stmt.size()) {
+    if (isalpha(stmt[i]) || stmt[i] == '_') {
+      string::size_type j = i;
+      while (j < stmt.size() && (isalnum(stmt[j]) || stmt[j] == '_')) j++;
+      string::size_type k = j;
+      while (k < stmt.size() && isspace(stmt[k])) k++;
+      if (k < stmt.size() && stmt[k] == '(' &&
+	  non_allocating.find(stmt.substr(i, j - i)) == non_allocating.end()) {
+	return true;
+      }
+      i = j;
+    } else {
+      i++;
+    }
+  }
+  return false;
+}
+
+// Whether any variable pushed or popped by name is assigned more
+// than once in the code, counting assignments inside PROTECT.
+static bool reassigns_protected(const vector<Line> & lines) {
+  set<string> handles;
+  for (unsigned int i = 0; i < lines.size(); i++) {
+    if (lines[i].kind == PROTECT_ASSIGN || lines[i].kind == PUSH ||
+	lines[i].kind == UNPROTECT_P) {
+      handles.insert(lines[i].var);
+    }
+  }
+  if (handles.empty()) return false;
+
+  map<string, int> assignments;
+  for (unsigned int n = 0; n < lines.size(); n++) {
+    const string & s = lines[n].stmt;
+    string::size_type i = 0;
+    while (i < s.size()) {
+      if (isalpha(s[i]) || s[i] == '_') {
+	string::size_type j = i;
+	while (j < s.size() && (isalnum(s[j]) || s[j] == '_')) j++;
+	string::size_type b = s.find_last_not_of(" \t", i == 0 ? 0 : i - 1);
+	bool member = (i > 0 && b != string::npos && (s[b] == '.' || s[b] == '>'));
+	string::size_type k = s.find_first_not_of(" \t", j);
+	if (!member && k != string::npos && s[k] == '=' &&
+	    (k + 1 == s.size() || s[k + 1] != '=') &&
+	    handles.find(s.substr(i, j - i)) != handles.end() &&
+	    ++assignments[s.substr(i, j - i)] > 1) {
+	  return true;
+	}
+	i = j;
+      } else if (isdigit(s[i])) {
+	while (i < s.size() && (isalnum(s[i]) || s[i] == '_' || s[i] == '.')) i++;
+      } else {
+	i++;
+      }
+    }
+  }
+  return false;
+}
+
+// If stmt is exactly "fname(arg);" (with an optional extra ';'), set
+// arg and return true.
+static bool parse_call1(const string & stmt, const string & fname, string & arg) {
+  if (stmt.compare(0, fname.size() + 1, fname + "(") != 0) return false;
+  int depth = 0;
+  string::size_type i;
+  for (i = fname.size(); i < stmt.size(); i++) {
+    if (stmt[i] == '(') depth++;
+    if (stmt[i] == ')' && --depth == 0) break;
+  }
+  if (i >= stmt.size()) return false;
+  string rest = stmt.substr(i + 1);
+  if (rest != ";" && rest != ";;") return false;
+  arg = stmt.substr(fname.size() + 1, i - fname.size() - 1);
+  string::size_type first = arg.find_first_not_of(" \t");
+  string::size_type last = arg.find_last_not_of(" \t");
+  arg = (first == string::npos ? "" : arg.substr(first, last - first + 1));
+  return true;
+}
+
+static bool is_identifier(const string & s) {
+  if (s.empty() || !(isalpha(s[0]) || s[0] == '_')) return false;
+  for (string::size_type i = 1; i < s.size(); i++) {
+    if (!(isalnum(s[i]) || s[i] == '_')) return false;
+  }
+  return true;
+}
+
+// Remove the push performed by a PROTECT_ASSIGN or PUSH line,
+// keeping the assignment.
+static void elide_push(Line & line) {
+  if (line.kind == PUSH) {
+    line.deleted = true;
+  } else {
+    string::size_type open = line.text.find("PROTECT(");
+    int depth = 0;
+    string::size_type i;
+    for (i = open + 7; i < line.text.size(); i++) {
+      char c = line.text[i];
+      if (c == '"' || c == '\'') {
+	for (i++; i < line.text.size() && line.text[i] != c; i++) {
+	  if (line.text[i] == '\\') i++;
+	}
+      } else if (c == '(') {
+	depth++;
+      } else if (c == ')' && --depth == 0) {
+	break;
+      }
+    }
+    line.text = line.text.substr(0, open) +
+      line.text.substr(open + 8, i - open - 8) +
+      line.text.substr(i + 1);
+  }
+  line.kind = OTHER;
+}
+
+static void set_unprotect_count(Line & line, int n) {
+  line.count = n;
+  if (n == 0) {
+    line.deleted = true;
+  } else {
+    line.text = line.lead + "UNPROTECT(" + i_to_s(n) + ");";
+  }
+}
+
+// Merge each UNPROTECT(n) into an UNPROTECT(m) directly before it.
+// Assertions on the later one move up, m entries deeper.
+static void coalesce_unprotects(vector<Line> & lines) {
+  int last = -1;
+  for (unsigned int i = 0; i < lines.size(); i++) {
+    Line & line = lines[i];
+    if (line.deleted || line.kind == BLANK) continue;
+    if (line.kind == UNPROTECT_N) {
+      if (last >= 0) {
+	Line & prev = lines[last];
+	for (unsigned int c = 0; c < line.check_vars.size(); c++) {
+	  prev.check_vars.push_back(line.check_vars[c]);
+	  prev.check_depths.push_back(line.check_depths[c] + prev.count);
+	}
+	set_unprotect_count(prev, prev.count + line.count);
+	line.deleted = true;
+      } else {
+	last = i;
+      }
+    } else {
+      last = -1;
+    }
+  }
+}
@@ -0,0 +1,44 @@
+// -*- Mode: C++ -*-
+//
+// Copyright (c) 2008 Rice University
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation; either version 2 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+
+// File: ProtectPlanner.h
+//
+// Post-pass over generated C code that removes unnecessary traffic on
+// the R protect stack.
+//
+// Author: John Garvin (garvin@cs.rice.edu)
+
+#ifndef PROTECT_PLANNER_H
+#define PROTECT_PLANNER_H
+
+#include <string>
+
+/// Rewrite the body of a generated C function to use the protect
+/// stack less. Within each straight-line run of statements:
+///
+///   - a handle that is protected and unprotected again with no
+///     possible allocation in between is not protected at all;
+///   - UNPROTECT_PTR(x) becomes UNPROTECT(1) when x is known to be on
+///     top of the protect stack;
+///   - adjacent UNPROTECTs are coalesced.
+///
+/// Control flow, labels, and anything else the planner doesn't
+/// recognize end a run, so the rewrite is conservative.
+std::string plan_protection(const std::string & code);
+
+#endif
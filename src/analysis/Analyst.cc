@@ -61,6 +61,11 @@ R_Analyst * R_Analyst::instance() {
   return s_instance;
 }
 
+void R_Analyst::reset() {
+  delete s_instance;
+  s_instance = 0;
+}
+
 // ----- constructor -----
 
 /// construct an R_Analyst by providing an SEXP representing the whole program
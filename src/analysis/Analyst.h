@@ -39,6 +39,8 @@ class R_Analyst {
 public:
   static R_Analyst * instance(SEXP _program); // regular Singleton: construct or return
   static R_Analyst * instance();  // only get the existing instance; error if not instantiated
+  /// Forget the instance, so the next compilation starts afresh
+  static void reset();
 
 public:
   /// Perform analysis.
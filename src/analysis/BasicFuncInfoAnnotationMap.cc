@@ -154,7 +154,7 @@ PropertyHndlT BasicFuncInfoAnnotationMap::s_handle = "BasicFuncInfo";
 
 void BasicFuncInfoAnnotationMap::create() {
   s_instance = new BasicFuncInfoAnnotationMap();
-  analysisResults.add(s_handle, s_instance);
+  analysisResults.add_instance(s_handle, s_instance);
 }
 
 
@@ -84,7 +84,7 @@ PropertyHndlT BasicVarAnnotationMap::handle() {
 
 void BasicVarAnnotationMap::create() {
   s_instance = new BasicVarAnnotationMap();
-  analysisResults.add(s_handle, s_instance);
+  analysisResults.add_instance(s_handle, s_instance);
 }
 
 BasicVarAnnotationMap * BasicVarAnnotationMap::s_instance = 0;
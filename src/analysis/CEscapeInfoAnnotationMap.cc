@@ -175,7 +175,7 @@ PropertyHndlT CEscapeInfoAnnotationMap::handle() {
 // for getProperty
 void CEscapeInfoAnnotationMap::create() {
   s_instance = new CEscapeInfoAnnotationMap();
-  analysisResults.add(s_handle, s_instance);
+  analysisResults.add_instance(s_handle, s_instance);
 }
 
 CEscapeInfoAnnotationMap * CEscapeInfoAnnotationMap::s_instance = 0;
@@ -83,7 +83,7 @@ PropertyHndlT CallByValueInfoAnnotationMap::s_handle = "CallByValueInfo";
 
 void CallByValueInfoAnnotationMap::create() {
   s_instance = new CallByValueInfoAnnotationMap();
-  analysisResults.add(s_handle, s_instance);
+  analysisResults.add_instance(s_handle, s_instance);
 }
 
 void CallByValueInfoAnnotationMap::compute() {
@@ -0,0 +1,172 @@
+// -*- Mode: C++ -*-
+//
+// Copyright (c) 2009 Rice University
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation; either version 2 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+
+// File: ConstantDFSet.cc
+//
+// Data flow set for constant propagation.
+//
+// Author: John Garvin (garvin@cs.rice.edu)
+
+#include <string.h>
+
+#include <analysis/AnalysisException.h>
+
+#include <support/DumpMacros.h>
+
+#include "ConstantDFSet.h"
+
+using namespace OA;
+using namespace OA::DataFlow;
+
+ConstantDFSet::ConstantDFSet()
+{}
+
+ConstantDFSet::~ConstantDFSet()
+{}
+
+OA_ptr<DataFlowSet> ConstantDFSet::clone() const {
+  OA_ptr<ConstantDFSet> clone; clone = new ConstantDFSet();
+  clone->m_map = m_map;
+  return clone.convert<DataFlowSet>();
+}
+
+bool ConstantDFSet::operator==(DataFlowSet & orig_other) const {
+  ConstantDFSet & other = dynamic_cast<ConstantDFSet &>(orig_other);
+  if (m_map.size() != other.m_map.size()) {
+    return false;
+  }
+  MyMap::const_iterator it, other_it;
+  for (it = m_map.begin(); it != m_map.end(); ++it) {
+    other_it = other.m_map.find(it->first);
+    if (other_it == other.m_map.end() || !equal_values(it->second, other_it->second)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool ConstantDFSet::operator!=(DataFlowSet & orig_other) const {
+  return !(*this == orig_other);
+}
+
+void ConstantDFSet::setUniversal() {
+  kill_all();
+}
+
+void ConstantDFSet::clear() {
+  m_map.clear();
+}
+
+int ConstantDFSet::size() const {
+  return m_map.size();
+}
+
+bool ConstantDFSet::isUniversalSet() const {
+  throw new AnalysisException("Not yet implemented");
+}
+
+bool ConstantDFSet::isEmpty() const {
+  return m_map.empty();
+}
+
+void ConstantDFSet::output(IRHandlesIRInterface & ir) const {
+  throw new AnalysisException("Not yet implemented");
+}
+
+void ConstantDFSet::dump(std::ostream & os) {
+  beginObjDump(os, ConstantDFSet);
+  for (MyMap::const_iterator it = m_map.begin(); it != m_map.end(); ++it) {
+    SEXP name = it->first;
+    dumpSEXP(os, name);
+    if (it->second == nac()) {
+      os << "NAC" << std::endl;
+    } else {
+      SEXP value = it->second;
+      dumpSEXP(os, value);
+    }
+  }
+  endObjDump(os, ConstantDFSet);
+}
+
+void ConstantDFSet::dump(std::ostream & os, OA_ptr<IRHandlesIRInterface>) {
+  dump(os);
+}
+
+void ConstantDFSet::dump() {
+  dump(std::cout);
+}
+
+OA_ptr<ConstantDFSet> ConstantDFSet::meet(OA_ptr<ConstantDFSet> other) {
+  OA_ptr<ConstantDFSet> meet; meet = clone().convert<ConstantDFSet>();
+  for (MyMap::const_iterator it = other->m_map.begin(); it != other->m_map.end(); ++it) {
+    MyMap::iterator mine = meet->m_map.find(it->first);
+    if (mine == meet->m_map.end()) {
+      meet->m_map[it->first] = it->second;
+    } else if (!equal_values(mine->second, it->second)) {
+      mine->second = nac();
+    }
+  }
+  return meet;
+}
+
+SEXP ConstantDFSet::lookup(SEXP name) const {
+  MyMap::const_iterator it = m_map.find(name);
+  if (it == m_map.end() || it->second == nac()) {
+    return 0;
+  } else {
+    return it->second;
+  }
+}
+
+void ConstantDFSet::replace(SEXP name, SEXP value) {
+  m_map[name] = value;
+}
+
+void ConstantDFSet::kill_all() {
+  for (MyMap::iterator it = m_map.begin(); it != m_map.end(); ++it) {
+    it->second = nac();
+  }
+}
+
+SEXP ConstantDFSet::nac() {
+  return R_UnboundValue;
+}
+
+bool ConstantDFSet::equal_values(SEXP x, SEXP y) {
+  if (x == y) return true;
+  if (x == nac() || y == nac()) return false;
+  if (TYPEOF(x) != TYPEOF(y) || Rf_length(x) != Rf_length(y)) return false;
+  int n = Rf_length(x);
+  switch (TYPEOF(x)) {
+  case LGLSXP:
+  case INTSXP:
+    return memcmp(INTEGER(x), INTEGER(y), n * sizeof(int)) == 0;
+  case REALSXP:
+    return memcmp(REAL(x), REAL(y), n * sizeof(double)) == 0;
+  case CPLXSXP:
+    return memcmp(COMPLEX(x), COMPLEX(y), n * sizeof(Rcomplex)) == 0;
+  case STRSXP:
+    for (int i = 0; i < n; i++) {
+      if ((STRING_ELT(x, i) == NA_STRING) != (STRING_ELT(y, i) == NA_STRING)) return false;
+      if (strcmp(CHAR(STRING_ELT(x, i)), CHAR(STRING_ELT(y, i))) != 0) return false;
+    }
+    return true;
+  default:
+    return false;
+  }
+}
@@ -0,0 +1,116 @@
+// -*- Mode: C++ -*-
+//
+// Copyright (c) 2009 Rice University
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation; either version 2 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+
+// File: ConstantDFSet.h
+//
+// Data flow set for constant propagation. Maps each local name of a
+// procedure to a lattice value: a constant R value, or NAC (not a
+// constant). A name not in the set is TOP (no information yet).
+//
+// Author: John Garvin (garvin@cs.rice.edu)
+
+#ifndef CONSTANT_DF_SET_H
+#define CONSTANT_DF_SET_H
+
+#include <map>
+
+#include <OpenAnalysis/DataFlow/DataFlowSet.hpp>
+
+#include <include/R/R_RInternals.h>
+
+class ConstantDFSet : public OA::DataFlow::DataFlowSet {
+public:
+  typedef std::map<SEXP, SEXP> MyMap;
+
+  explicit ConstantDFSet();
+  ~ConstantDFSet();
+
+  //! Create a copy of this set
+  OA::OA_ptr<OA::DataFlow::DataFlowSet> clone() const;
+
+  //************************************************************
+  // Comparison Operators
+  //************************************************************
+
+  /*! Return true if both sets map the same names to equal lattice
+    values. */
+  bool operator==(OA::DataFlow::DataFlowSet & other) const;
+
+  //! Return true if the LHS and RHS do not equal each other
+  bool operator!=(OA::DataFlow::DataFlowSet & other) const;
+
+  //************************************************************
+  // Modifier Methods
+  //************************************************************
+
+  //! Set this set to the universal set
+  void setUniversal();
+
+  //! Remove all elements from this set
+  void clear();
+
+  //************************************************************
+  // Information Methods
+  //************************************************************
+
+  //! Return the number of elements contained in this set
+  int size() const;
+
+  //! Return true if this is the universal set
+  bool isUniversalSet() const;
+
+  //! Return true if this set is empty
+  bool isEmpty() const;
+
+  //************************************************************
+  // Output and Debugging Methods
+  //************************************************************
+  void output(OA::IRHandlesIRInterface & ir) const;
+
+  //! Output succinct description of set's contents
+  void dump(std::ostream & os, OA::OA_ptr<OA::IRHandlesIRInterface>);
+
+  void dump(std::ostream & os);
+
+  void dump();
+
+  // ----- our own methods -----
+
+  /// meet of two sets: TOP meet v = v; v meet v = v; otherwise NAC
+  OA::OA_ptr<ConstantDFSet> meet(OA::OA_ptr<ConstantDFSet> other);
+
+  /// the constant value of the name, or 0 if it is TOP or NAC
+  SEXP lookup(SEXP name) const;
+
+  void replace(SEXP name, SEXP value);
+
+  /// set every name in the set to NAC
+  void kill_all();
+
+  /// the lattice value representing "not a constant"
+  static SEXP nac();
+
+  /// Are two constant values equal? Values are vectors without
+  /// attributes as produced by constant folding.
+  static bool equal_values(SEXP x, SEXP y);
+
+private:
+  MyMap m_map;
+};
+
+#endif
@@ -0,0 +1,214 @@
+// -*- Mode: C++ -*-
+//
+// Copyright (c) 2009 Rice University
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation; either version 2 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+
+// File: ConstantDFSolver.cc
+//
+// Author: John Garvin (garvin@cs.rice.edu)
+
+#include <include/R/R_Defn.h>
+#include <include/R/R_RInternals.h>
+
+#include <OpenAnalysis/IRInterface/IRHandles.hpp>
+#include <OpenAnalysis/DataFlow/CFGDFSolver.hpp>
+
+#include <support/Debug.h>
+
+#include <analysis/AnalysisResults.h>
+#include <analysis/ConstantDFSet.h>
+#include <analysis/ExpressionInfo.h>
+#include <analysis/FuncInfo.h>
+#include <analysis/IRInterface.h>
+#include <analysis/HandleInterface.h>
+#include <analysis/PropertySet.h>
+#include <analysis/Utils.h>
+#include <analysis/Var.h>
+#include <analysis/VarAnnotationMap.h>
+#include <analysis/VarBinding.h>
+
+#include "ConstantDFSolver.h"
+
+using namespace RAnnot;
+using namespace OA;
+using namespace HandleInterface;
+
+typedef ConstantDFSet DFSet;
+typedef ConstantDFSolver::ConstantMap ConstantMap;
+
+static bool debug;
+
+ConstantDFSolver::ConstantDFSolver(OA_ptr<R_IRInterface> ir)
+  : m_ir(ir)
+{
+  RCC_DEBUG("RCC_ConstantDFSolver", debug);
+}
+
+ConstantDFSolver::~ConstantDFSolver()
+{}
+
+/// Perform the data flow analysis, then in a post-pass walk each
+/// statement with the constants known on entry to it and record every
+/// variable use and call that folds to a scalar constant.
+OA_ptr<ConstantMap> ConstantDFSolver::perform_analysis(FuncInfo * fi) {
+  OA_ptr<CFG::NodeInterface> node;
+  StmtHandle stmt;
+
+  m_fi = fi;
+  m_cfg = fi->get_cfg();
+  m_top = new DFSet();
+  m_result = new ConstantMap();
+
+  // solve as a forward data flow problem
+  m_solver = new DataFlow::CFGDFSolver(DataFlow::CFGDFSolver::Forward, *this);
+  m_solver->solve(m_cfg, DataFlow::ITERATIVE);
+
+  CFG_FOR_EACH_NODE(m_cfg, node) {
+    OA_ptr<DFSet> in_set = m_solver->getInSet(node)->clone().convert<DFSet>();
+    NODE_FOR_EACH_STATEMENT(node, stmt) {
+      m_in = in_set;
+      annotate_stmt(make_sexp(stmt), is_flat(make_sexp(stmt), m_fi), *m_result);
+      in_set = transfer(in_set, stmt).convert<DFSet>();
+    }
+  }
+
+  if (debug) {
+    dump_node_maps();
+    for (ConstantMap::const_iterator it = m_result->begin(); it != m_result->end(); ++it) {
+      std::cout << "folded: ";
+      Rf_PrintValue(CAR(it->first));
+      std::cout << "    to: ";
+      Rf_PrintValue(it->second);
+    }
+  }
+
+  return m_result;
+}
+
+// ----- debugging -----
+
+void ConstantDFSolver::dump_node_maps() {
+  dump_node_maps(std::cout);
+}
+
+void ConstantDFSolver::dump_node_maps(std::ostream &os) {
+  OA_ptr<DataFlow::DataFlowSet> df_in_set, df_out_set;
+  OA_ptr<DFSet> in_set, out_set;
+  OA_ptr<CFG::NodesIteratorInterface> ni = m_cfg->getCFGNodesIterator();
+
+  for ( ; ni->isValid(); ++*ni) {
+    OA_ptr<CFG::NodeInterface> n = ni->current().convert<CFG::NodeInterface>();
+    df_in_set = m_solver->getInSet(n);
+    df_out_set = m_solver->getOutSet(n);
+    in_set = df_in_set.convert<DFSet>();
+    out_set = df_out_set.convert<DFSet>();
+    os << "CFG NODE #" << n->getId() << ":\n";
+    os << "IN SET:\n";
+    in_set->dump(os, m_ir);
+    os << "OUT SET:\n";
+    out_set->dump(os, m_ir);
+  }
+}
+
+// ----- callbacks for CFGDFProblem: initialization, meet, transfer -----
+
+/// TOP is the empty set: no information about any name.
+OA_ptr<DataFlow::DataFlowSet> ConstantDFSolver::initializeTop() {
+  return m_top;
+}
+
+/// Not used.
+OA_ptr<DataFlow::DataFlowSet> ConstantDFSolver::initializeBottom() {
+  assert(0);
+}
+
+/// On procedure entry, no local name has a known value (formals are
+/// promises), so every local name is NAC. Everywhere else start at
+/// TOP.
+OA_ptr<DataFlow::DataFlowSet> ConstantDFSolver::initializeNodeIN(OA_ptr<CFG::NodeInterface> n) {
+  if (n.ptrEqual(m_cfg->getEntry())) {
+    OA_ptr<DFSet> dfset; dfset = new DFSet();
+    PROC_FOR_EACH_MENTION(m_fi, mi) {
+      Var * var = getProperty(Var, *mi);
+      if (var->get_scope_type() == Locality::Locality_LOCAL) {
+	dfset->replace(var->get_name(), DFSet::nac());
+      }
+    }
+    return dfset.convert<DataFlow::DataFlowSet>();  // upcast
+  } else {
+    return m_top->clone();
+  }
+}
+
+OA_ptr<DataFlow::DataFlowSet> ConstantDFSolver::initializeNodeOUT(OA_ptr<CFG::NodeInterface> n) {
+  return m_top->clone();
+}
+
+/// Meet function. A name is constant after a join only if it has the
+/// same constant value on every incoming path.
+///
+/// Note: base class CFGDFProblem says: OK to modify set1 and return
+/// it as result, because solver only passes a tempSet in as set1
+OA_ptr<DataFlow::DataFlowSet>
+ConstantDFSolver::meet(OA_ptr<DataFlow::DataFlowSet> set1_orig, OA_ptr<DataFlow::DataFlowSet> set2_orig) {
+  OA_ptr<DFSet> set1; set1 = set1_orig.convert<DFSet>();
+  OA_ptr<DFSet> set2; set2 = set2_orig.convert<DFSet>();
+  return set1->meet(set2).convert<DataFlow::DataFlowSet>();
+}
+
+/// Transfer function; the effect of a statement. A simple local
+/// assignment of a foldable expression makes its name constant;
+/// every other local def makes its name NAC. A statement that may
+/// modify locals behind our back kills everything.
+///
+/// Note: base class CFGDFProblem says: OK to modify in set and return
+/// it again as result because solver clones the BB in sets
+OA_ptr<DataFlow::DataFlowSet>
+ConstantDFSolver::transfer(OA_ptr<DataFlow::DataFlowSet> in_dfs, StmtHandle stmt_handle) {
+  SEXP def;
+  OA_ptr<DFSet> in; in = in_dfs.convert<DFSet>();
+  SEXP cell = make_sexp(stmt_handle);
+  SEXP e = CAR(cell);
+  ExpressionInfo * annot = getProperty(ExpressionInfo, cell);
+
+  // fold the right side before the assignment takes effect
+  SEXP value = 0;
+  if (is_simple_assign(e) && is_local_assign(e) && is_flat(cell, m_fi)) {
+    m_in = in;
+    value = fold(assign_rhs_c(e), true);
+    if (value != 0 && !is_foldable_value(value)) value = 0;
+  }
+
+  if (kills_locals(cell, m_fi)) {
+    in->kill_all();
+  }
+  EXPRESSION_FOR_EACH_DEF(annot, def) {
+    Var * def_annot = getProperty(Var, def);
+    if (def_annot->get_scope_type() == Locality::Locality_LOCAL) {
+      in->replace(def_annot->get_name(), DFSet::nac());
+    }
+  }
+  if (value != 0) {
+    in->replace(CAR(assign_lhs_c(e)), value);
+  }
+  return in;
+}
+
+/// Local names are looked up in the set of constants on entry to the
+/// statement being folded.
+SEXP ConstantDFSolver::lookup_local(SEXP cell) {
+  return m_in->lookup(getProperty(Var, cell)->get_name());
+}
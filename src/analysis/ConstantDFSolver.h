@@ -0,0 +1,89 @@
+// -*- Mode: C++ -*-
+//
+// Copyright (c) 2009 Rice University
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation; either version 2 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+
+// File: ConstantDFSolver.h
+//
+// Constant folding and propagation, a forward CFG data flow problem
+// over the local names of a procedure. A local name is constant at a
+// statement if on every path it was last assigned an expression that
+// folds to a constant (see ConstantFolder).
+//
+// Author: John Garvin (garvin@cs.rice.edu)
+
+#ifndef CONSTANT_DF_SOLVER_H
+#define CONSTANT_DF_SOLVER_H
+
+#include <map>
+
+#include <OpenAnalysis/Utils/OA_ptr.hpp>
+#include <OpenAnalysis/DataFlow/CFGDFProblem.hpp>
+#include <OpenAnalysis/DataFlow/CFGDFSolver.hpp>
+#include <OpenAnalysis/DataFlow/DataFlowSet.hpp>
+
+#include <include/R/R_RInternals.h>
+
+#include <analysis/ConstantFolder.h>
+
+class OA::CFG::CFGInterface;
+class R_IRInterface;
+class ConstantDFSet;
+namespace RAnnot { class FuncInfo; }
+
+class ConstantDFSolver : private OA::DataFlow::CFGDFProblem, private ConstantFolder {
+public:
+  typedef ConstantFolder::ConstantMap ConstantMap;
+
+  explicit ConstantDFSolver(OA::OA_ptr<R_IRInterface> _rir);
+  ~ConstantDFSolver();
+  OA::OA_ptr<ConstantMap> perform_analysis(RAnnot::FuncInfo * fi);
+  void dump_node_maps();
+  void dump_node_maps(std::ostream &os);
+
+  // ----- callbacks for CFGDFProblem: initialization, meet, transfer -----
+private:
+  OA::OA_ptr<OA::DataFlow::DataFlowSet> initializeTop();
+  OA::OA_ptr<OA::DataFlow::DataFlowSet> initializeBottom();
+
+  OA::OA_ptr<OA::DataFlow::DataFlowSet> initializeNodeIN(OA::OA_ptr<OA::CFG::NodeInterface> n);
+  OA::OA_ptr<OA::DataFlow::DataFlowSet> initializeNodeOUT(OA::OA_ptr<OA::CFG::NodeInterface> n);
+
+  // CFGDFProblem says: OK to modify set1 and return it as result, because solver
+  // only passes a tempSet in as set1
+  OA::OA_ptr<OA::DataFlow::DataFlowSet>
+  meet (OA::OA_ptr<OA::DataFlow::DataFlowSet> set1, OA::OA_ptr<OA::DataFlow::DataFlowSet> set2);
+
+  // CFGDFProblem says: OK to modify in set and return it again as result because
+  // solver clones the BB in sets
+  OA::OA_ptr<OA::DataFlow::DataFlowSet>
+  transfer(OA::OA_ptr<OA::DataFlow::DataFlowSet> in, OA::StmtHandle stmt);
+
+  // ----- folding -----
+private:
+  SEXP lookup_local(SEXP cell);
+
+private:
+  OA::OA_ptr<R_IRInterface> m_ir;
+  OA::OA_ptr<OA::CFG::CFGInterface> m_cfg;
+  RAnnot::FuncInfo * m_fi;
+  OA::OA_ptr<ConstantDFSet> m_top;
+  OA::OA_ptr<OA::DataFlow::CFGDFSolver> m_solver;
+  OA::OA_ptr<ConstantMap> m_result;
+  OA::OA_ptr<ConstantDFSet> m_in;  // constants on entry to the statement being folded
+};
+
+#endif // CONSTANT_DF_SOLVER_H
@@ -0,0 +1,295 @@
+// -*- Mode: C++ -*-
+//
+// Copyright (c) 2009 Rice University
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation; either version 2 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+
+// File: ConstantFolder.cc
+//
+// Author: John Garvin (garvin@cs.rice.edu)
+
+#include <math.h>
+
+#include <include/R/R_Defn.h>
+#include <include/R/R_RInternals.h>
+
+#include <analysis/AnalysisResults.h>
+#include <analysis/ExpressionInfo.h>
+#include <analysis/FuncInfo.h>
+#include <analysis/PropertySet.h>
+#include <analysis/Utils.h>
+#include <analysis/Var.h>
+#include <analysis/VarAnnotationMap.h>
+#include <analysis/VarBinding.h>
+
+#include "ConstantFolder.h"
+
+using namespace RAnnot;
+
+// Folded intermediate values longer than this are not worth keeping
+// (and 1:1e8 is not worth computing).
+static const int MAX_FOLDED_LENGTH = 1024;
+
+static bool is_pure_library_fun(SEXP sym);
+static bool is_library_constant(SEXP sym);
+
+ConstantFolder::ConstantFolder()
+{}
+
+ConstantFolder::~ConstantFolder()
+{}
+
+/// Does the statement call something that may modify local names
+/// behind our back: a function that works on environments, or, if
+/// the procedure has closures, anything but a library function?
+bool ConstantFolder::kills_locals(SEXP stmt_c, FuncInfo * fi) {
+  SEXP cs;
+  ExpressionInfo * annot = getProperty(ExpressionInfo, stmt_c);
+  EXPRESSION_FOR_EACH_CALL_SITE(annot, cs) {
+    SEXP lhs = call_lhs(CAR(cs));
+    if ((is_var(lhs) && is_environment_library(lhs)) ||
+	(fi->has_children() && (!is_var(lhs) || !getProperty(VarBinding, CAR(cs))->is_internal())))
+    {
+      return true;
+    }
+  }
+  return false;
+}
+
+/// A statement is flat if the values of local names cannot change
+/// while it is being evaluated: its only def is the one made by the
+/// statement itself, and it makes no call that could modify locals.
+bool ConstantFolder::is_flat(SEXP stmt_c, FuncInfo * fi) {
+  SEXP def, cs;
+  SEXP e = CAR(stmt_c);
+  ExpressionInfo * annot = getProperty(ExpressionInfo, stmt_c);
+  EXPRESSION_FOR_EACH_DEF(annot, def) {
+    if (!(is_assign(e) && def == assign_lhs_c(e)) && !(is_for(e) && def == for_iv_c(e))) {
+      return false;
+    }
+  }
+  EXPRESSION_FOR_EACH_CALL_SITE(annot, cs) {
+    SEXP lhs = call_lhs(CAR(cs));
+    if (!is_var(lhs) || is_environment_library(lhs)) return false;
+    if (fi->has_children() && !getProperty(VarBinding, CAR(cs))->is_internal()) return false;
+  }
+  return true;
+}
+
+/// Return the constant value the expression in the given cell folds
+/// to, or 0 if it doesn't fold. Uses of local names are folded only
+/// if flat is true.
+SEXP ConstantFolder::fold(SEXP cell, bool flat) {
+  SEXP e = CAR(cell);
+  if (is_const(e)) {
+    return e;
+  } else if (is_var(e)) {
+    if (e == R_MissingArg || !VarAnnotationMap::instance()->is_valid(cell)) {
+      return 0;
+    }
+    Var * var = getProperty(Var, cell);
+    if (var->get_scope_type() == Locality::Locality_LOCAL) {
+      return (flat ? lookup_local(cell) : 0);
+    } else if (is_library_constant(e) && getProperty(VarBinding, cell)->is_internal()) {
+      SEXP value = Rf_findVar(e, R_GlobalEnv);
+      return (is_foldable_value(value) ? value : 0);
+    } else {
+      return 0;
+    }
+  } else if (is_paren_exp(e)) {
+    return fold(paren_body_c(e), flat);
+  } else if (is_call(e)) {
+    return fold_call(e, flat);
+  } else {
+    return 0;
+  }
+}
+
+/// Fold a call to a pure library function by evaluating it in the
+/// embedded R on the folded arguments. Calls that signal an error or
+/// a warning are left for run time.
+SEXP ConstantFolder::fold_call(SEXP e, bool flat) {
+  SEXP fun = call_lhs(e);
+  if (!is_var(fun) || !is_pure_library_fun(fun) || !getProperty(VarBinding, e)->is_internal()) {
+    return 0;
+  }
+  SEXP args, a, arg_c, v;
+  PROTECT(args = Rf_allocList(Rf_length(call_args(e))));
+  for (arg_c = call_args(e), a = args; arg_c != R_NilValue; arg_c = CDR(arg_c), a = CDR(a)) {
+    v = fold(arg_c, flat);
+    if (v == 0 || !is_foldable_value(v)) {
+      UNPROTECT(1);
+      return 0;
+    }
+    SETCAR(a, v);
+    SET_TAG(a, TAG(arg_c));
+  }
+  if (fun == Rf_install(":")) {
+    if (Rf_length(args) != 2 ||
+	fabs(Rf_asReal(CADR(args)) - Rf_asReal(CAR(args))) >= MAX_FOLDED_LENGTH)
+    {
+      UNPROTECT(1);
+      return 0;
+    }
+  }
+  SEXP call;
+  PROTECT(call = Rf_lcons(fun, args));
+  // warnings are counted in R_CollectWarnings only if warn is 0
+  SEXP warn_sym = Rf_install("warn");
+  SEXP saved_warn = PROTECT(SetOption(warn_sym, Rf_ScalarInteger(0)));
+  int saved_warnings = R_CollectWarnings;
+  int error = 0;
+  SEXP value = R_tryEval(call, R_GlobalEnv, &error);
+  bool warned = (R_CollectWarnings != saved_warnings);
+  R_CollectWarnings = saved_warnings;
+  if (!error) PROTECT(value);
+  SetOption(warn_sym, saved_warn);
+  if (error || warned || !is_foldable_value(value)) {
+    UNPROTECT(error ? 3 : 4);
+    return 0;
+  }
+  // folded values live in data flow sets and annotations for the
+  // rest of the compilation
+  keep(value);
+  UNPROTECT(4);
+  return value;
+}
+
+void ConstantFolder::keep(SEXP value) {
+  if (s_kept == 0) {
+    s_kept = Rf_cons(R_NilValue, R_NilValue);
+    R_PreserveObject(s_kept);
+  }
+  SETCDR(s_kept, Rf_cons(value, CDR(s_kept)));
+}
+
+void ConstantFolder::reset() {
+  if (s_kept != 0) {
+    R_ReleaseObject(s_kept);
+    s_kept = 0;
+  }
+}
+
+SEXP ConstantFolder::s_kept = 0;
+
+/// Record folded values for the parts of a statement that codegen
+/// evaluates.
+void ConstantFolder::annotate_stmt(SEXP stmt_c, bool flat, ConstantMap & result) {
+  SEXP e = CAR(stmt_c);
+  if (is_for(e)) {
+    annotate(for_range_c(e), flat, result);
+  } else if (is_while(e)) {
+    annotate(while_cond_c(e), flat, result);
+  } else if (is_if(e)) {
+    annotate(if_cond_c(e), flat, result);
+  } else if (is_explicit_return(e)) {
+    if (call_args(e) != R_NilValue) {
+      annotate(call_nth_arg_c(e, 1), flat, result);
+    }
+  } else if (is_repeat(e) || is_break(e) || is_next(e) || is_stop(e)) {
+    // nothing to fold
+  } else {
+    annotate(stmt_c, flat, result);
+  }
+}
+
+/// Record the largest subexpressions that fold to scalars. Descends
+/// only into right sides of assignments and arguments of builtins,
+/// whose arguments are always evaluated in order; arguments to
+/// anything else may be promises or quoted.
+void ConstantFolder::annotate(SEXP cell, bool flat, ConstantMap & result) {
+  SEXP e = CAR(cell);
+  if (is_const(e)) {
+    return;
+  }
+  SEXP value = fold(cell, flat);
+  if (value != 0 && is_scalar_value(value)) {
+    result[cell] = value;
+  } else if (is_simple_assign(e)) {
+    annotate(assign_rhs_c(e), flat, result);
+  } else if (is_paren_exp(e)) {
+    annotate(paren_body_c(e), flat, result);
+  } else if (is_call(e) && is_var(call_lhs(e)) && is_library(call_lhs(e)) &&
+	     is_library_builtin(call_lhs(e)) && getProperty(VarBinding, e)->is_internal())
+  {
+    for (SEXP arg_c = call_args(e); arg_c != R_NilValue; arg_c = CDR(arg_c)) {
+      annotate(arg_c, flat, result);
+    }
+  }
+}
+
+// ----- value predicates and static helpers -----
+
+static bool name_in(SEXP sym, const char * const * names) {
+  for (const char * const * n = names; *n != 0; n++) {
+    if (sym == Rf_install(*n)) return true;
+  }
+  return false;
+}
+
+/// Library functions with no side effects whose result depends only
+/// on their arguments.
+static bool is_pure_library_fun(SEXP sym) {
+  static const char * const names[] = {
+    "+", "-", "*", "/", "^", "%%", "%/%",
+    "==", "!=", "<", ">", "<=", ">=", "!", "&", "|",
+    "c", ":", "[", "[[", "length",
+    "sqrt", "exp", "log", "abs", "floor", "ceiling",
+    "as.integer", "as.double", "as.numeric", "as.logical",
+    0 };
+  return name_in(sym, names);
+}
+
+/// Library variables whose values are constants.
+static bool is_library_constant(SEXP sym) {
+  static const char * const names[] = { "pi", "T", "F", 0 };
+  return name_in(sym, names);
+}
+
+/// Values that folding may produce and consume: atomic vectors with
+/// no attributes, and NULL.
+bool ConstantFolder::is_foldable_value(SEXP v) {
+  switch (TYPEOF(v)) {
+  case NILSXP:
+    return true;
+  case LGLSXP:
+  case INTSXP:
+  case REALSXP:
+  case CPLXSXP:
+  case STRSXP:
+    return (ATTRIB(v) == R_NilValue && Rf_length(v) <= MAX_FOLDED_LENGTH);
+  default:
+    return false;
+  }
+}
+
+/// Values that codegen can emit as constants. Codegen has no
+/// representation for NA strings, and NaN would confuse the table of
+/// real constants, so those stay unfolded.
+bool ConstantFolder::is_scalar_value(SEXP v) {
+  if (TYPEOF(v) == NILSXP || !is_foldable_value(v) || Rf_length(v) != 1) {
+    return false;
+  }
+  switch (TYPEOF(v)) {
+  case REALSXP:
+    return !ISNAN(REAL(v)[0]);
+  case CPLXSXP:
+    return !ISNAN(COMPLEX(v)[0].r) && !ISNAN(COMPLEX(v)[0].i);
+  case STRSXP:
+    return STRING_ELT(v, 0) != NA_STRING;
+  default:
+    return true;
+  }
+}
@@ -0,0 +1,87 @@
+// -*- Mode: C++ -*-
+//
+// Copyright (c) 2009 Rice University
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation; either version 2 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+
+// File: ConstantFolder.h
+//
+// Compile-time evaluation of expressions, shared by the constant
+// propagation solvers. An expression folds if it is a literal, a
+// local name the solver knows to be constant, one of a few library
+// constants (pi, T, F), or a call to a pure library function on
+// folded arguments; such calls are evaluated by the embedded R
+// interpreter. Solvers supply the values of local names.
+//
+// Author: John Garvin (garvin@cs.rice.edu)
+
+#ifndef CONSTANT_FOLDER_H
+#define CONSTANT_FOLDER_H
+
+#include <map>
+
+#include <include/R/R_RInternals.h>
+
+namespace RAnnot { class FuncInfo; }
+
+class ConstantFolder {
+public:
+  /// maps expression cells to the constant values they fold to
+  typedef std::map<SEXP, SEXP> ConstantMap;
+
+  /// Values that folding may produce and consume: atomic vectors with
+  /// no attributes, and NULL.
+  static bool is_foldable_value(SEXP v);
+
+  /// Values that codegen can emit as constants.
+  static bool is_scalar_value(SEXP v);
+
+  /// A statement is flat if the values of local names cannot change
+  /// while it is being evaluated.
+  static bool is_flat(SEXP stmt_c, RAnnot::FuncInfo * fi);
+
+  /// Does the statement make a call that may modify local names?
+  static bool kills_locals(SEXP stmt_c, RAnnot::FuncInfo * fi);
+
+  /// Release the values folded so far, which are kept alive until the
+  /// end of the compilation
+  static void reset();
+
+protected:
+  explicit ConstantFolder();
+  virtual ~ConstantFolder();
+
+  /// The constant value of the local name mentioned in the cell, or
+  /// 0 if it has none.
+  virtual SEXP lookup_local(SEXP cell) = 0;
+
+  /// The constant value the expression in the cell folds to, or 0.
+  /// Uses of local names are folded only if flat is true.
+  SEXP fold(SEXP cell, bool flat);
+
+  /// Record in 'result' the folded values of the parts of a
+  /// statement that codegen evaluates.
+  void annotate_stmt(SEXP stmt_c, bool flat, ConstantMap & result);
+
+private:
+  SEXP fold_call(SEXP e, bool flat);
+  void annotate(SEXP cell, bool flat, ConstantMap & result);
+  static void keep(SEXP value);
+
+  // preserved pairlist holding every folded value
+  static SEXP s_kept;
+};
+
+#endif // CONSTANT_FOLDER_H
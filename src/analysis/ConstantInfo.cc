@@ -0,0 +1,61 @@
+// -*- Mode: C++ -*-
+//
+// Copyright (c) 2009 Rice University
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation; either version 2 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA 
+
+// File: ConstantInfo.cc
+//
+// Annotation for information coming from constant folding and
+// propagation: the constant value an expression always evaluates
+// to. Attached to the cells of expressions that fold.
+//
+// Author: John Garvin (garvin@cs.rice.edu)
+
+#include <analysis/ConstantInfoAnnotationMap.h>
+
+#include <support/DumpMacros.h>
+
+#include "ConstantInfo.h"
+
+namespace RAnnot {
+
+ConstantInfo::ConstantInfo(SEXP value) : m_value(value) {
+}
+
+ConstantInfo::~ConstantInfo() {
+}
+
+SEXP ConstantInfo::get_value() {
+  return m_value;
+}
+
+AnnotationBase * ConstantInfo::clone() {
+  return new ConstantInfo(m_value);
+}
+
+std::ostream & ConstantInfo::dump(std::ostream & os) const {
+  beginObjDump(os, ConstantInfo);
+  SEXP value = m_value;
+  dumpSEXP(os, value);
+  endObjDump(os, ConstantInfo);
+  return os;
+}
+
+PropertyHndlT ConstantInfo::handle() {
+  return ConstantInfoAnnotationMap::handle();
+}
+
+}
@@ -0,0 +1,108 @@
+// -*- Mode: C++ -*-
+//
+// Copyright (c) 2009 Rice University
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation; either version 2 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA 
+
+// File: ConstantInfoAnnotationMap.cc
+//
+// Maps expression cells to the constant values they fold to.
+//
+// Author: John Garvin (garvin@cs.rice.edu)
+
+#include <OpenAnalysis/CFG/CFG.hpp>
+
+#include <analysis/AnalysisResults.h>
+#include <analysis/Analyst.h>
+#include <analysis/ConstantDFSolver.h>
+#include <analysis/ConstantInfo.h>
+#include <analysis/FuncInfo.h>
+#include <analysis/PropertyHndl.h>
+#include <analysis/SCCPSolver.h>
+#include <analysis/Settings.h>
+
+#include "ConstantInfoAnnotationMap.h"
+
+using namespace OA;
+
+namespace RAnnot {
+
+// ----- type definitions for readability -----
+
+typedef ConstantInfoAnnotationMap::MyKeyT MyKeyT;
+typedef ConstantInfoAnnotationMap::MyMappedT MyMappedT;
+
+// ----- constructor/destructor ----- 
+
+ConstantInfoAnnotationMap::ConstantInfoAnnotationMap()
+{}
+
+ConstantInfoAnnotationMap::~ConstantInfoAnnotationMap() {
+  // owns ConstantInfo annotations, so delete them in deconstructor
+  std::map<MyKeyT, MyMappedT>::const_iterator iter;
+  for(iter = get_map().begin(); iter != get_map().end(); ++iter) {
+    delete(iter->second);
+  }
+}
+
+// ----- computation -----
+
+// Run constant propagation on each procedure: sparse conditional
+// constant propagation over SSA form, or with -fno-sparse-constants
+// the dense data flow solver. Only expressions that fold to a
+// constant are put in the map.
+void ConstantInfoAnnotationMap::compute() {
+  FuncInfo * fi;
+  ConstantDFSolver dense_solver(R_Analyst::instance()->get_interface());
+  SCCPSolver sparse_solver;
+  bool sparse = Settings::instance()->get_sparse_constants();
+
+  FOR_EACH_PROC(fi) {
+    OA_ptr<ConstantFolder::ConstantMap> constants =
+      (sparse ? sparse_solver.perform_analysis(fi) : dense_solver.perform_analysis(fi));
+    ConstantFolder::ConstantMap::const_iterator it;
+    for (it = constants->begin(); it != constants->end(); ++it) {
+      get_map()[it->first] = new ConstantInfo(it->second);
+    }
+  }
+}
+
+// ----- singleton pattern -----
+
+ConstantInfoAnnotationMap * ConstantInfoAnnotationMap::instance() {
+  if (s_instance == 0) {
+    create();
+  }
+  return s_instance;
+}
+
+PropertyHndlT ConstantInfoAnnotationMap::handle() {
+  if (s_instance == 0) {
+    create();
+  }
+  return s_handle;
+}
+
+// Create the singleton instance and register the map in PropertySet
+// for getProperty
+void ConstantInfoAnnotationMap::create() {
+  s_instance = new ConstantInfoAnnotationMap();
+  analysisResults.add_instance(s_handle, s_instance);
+}
+
+ConstantInfoAnnotationMap * ConstantInfoAnnotationMap::s_instance = 0;
+PropertyHndlT ConstantInfoAnnotationMap::s_handle = "ConstantInfo";
+
+} // end namespace RAnnot
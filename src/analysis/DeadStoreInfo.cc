@@ -0,0 +1,56 @@
+// -*- Mode: C++ -*-
+//
+// Copyright (c) 2009 Rice University
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation; either version 2 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA 
+
+// File: DeadStoreInfo.cc
+//
+// Annotation for information coming from liveness analysis: marks a
+// statement as a dead store, an assignment whose value is never used
+// and whose right side has no other effect. Attached to statement
+// cells.
+//
+// Author: John Garvin (garvin@cs.rice.edu)
+
+#include <analysis/DeadStoreInfoAnnotationMap.h>
+
+#include <support/DumpMacros.h>
+
+#include "DeadStoreInfo.h"
+
+namespace RAnnot {
+
+DeadStoreInfo::DeadStoreInfo() {
+}
+
+DeadStoreInfo::~DeadStoreInfo() {
+}
+
+AnnotationBase * DeadStoreInfo::clone() {
+  return new DeadStoreInfo();
+}
+
+std::ostream & DeadStoreInfo::dump(std::ostream & os) const {
+  beginObjDump(os, DeadStoreInfo);
+  endObjDump(os, DeadStoreInfo);
+  return os;
+}
+
+PropertyHndlT DeadStoreInfo::handle() {
+  return DeadStoreInfoAnnotationMap::handle();
+}
+
+}
@@ -0,0 +1,101 @@
+// -*- Mode: C++ -*-
+//
+// Copyright (c) 2009 Rice University
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation; either version 2 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA 
+
+// File: DeadStoreInfoAnnotationMap.cc
+//
+// Maps the cells of dead store statements to DeadStoreInfo markers.
+//
+// Author: John Garvin (garvin@cs.rice.edu)
+
+#include <OpenAnalysis/CFG/CFG.hpp>
+
+#include <analysis/AnalysisResults.h>
+#include <analysis/Analyst.h>
+#include <analysis/DeadStoreInfo.h>
+#include <analysis/FuncInfo.h>
+#include <analysis/LivenessDFSolver.h>
+#include <analysis/PropertyHndl.h>
+
+#include "DeadStoreInfoAnnotationMap.h"
+
+using namespace OA;
+
+namespace RAnnot {
+
+// ----- type definitions for readability -----
+
+typedef DeadStoreInfoAnnotationMap::MyKeyT MyKeyT;
+typedef DeadStoreInfoAnnotationMap::MyMappedT MyMappedT;
+
+// ----- constructor/destructor ----- 
+
+DeadStoreInfoAnnotationMap::DeadStoreInfoAnnotationMap()
+{}
+
+DeadStoreInfoAnnotationMap::~DeadStoreInfoAnnotationMap() {
+  // owns DeadStoreInfo annotations, so delete them in deconstructor
+  std::map<MyKeyT, MyMappedT>::const_iterator iter;
+  for(iter = get_map().begin(); iter != get_map().end(); ++iter) {
+    delete(iter->second);
+  }
+}
+
+// ----- computation -----
+
+// Run liveness analysis on each procedure. Only dead stores are put
+// in the map.
+void DeadStoreInfoAnnotationMap::compute() {
+  FuncInfo * fi;
+  LivenessDFSolver solver(R_Analyst::instance()->get_interface());
+
+  FOR_EACH_PROC(fi) {
+    OA_ptr<std::set<SEXP> > dead = solver.perform_analysis(fi);
+    std::set<SEXP>::const_iterator it;
+    for (it = dead->begin(); it != dead->end(); ++it) {
+      get_map()[*it] = new DeadStoreInfo();
+    }
+  }
+}
+
+// ----- singleton pattern -----
+
+DeadStoreInfoAnnotationMap * DeadStoreInfoAnnotationMap::instance() {
+  if (s_instance == 0) {
+    create();
+  }
+  return s_instance;
+}
+
+PropertyHndlT DeadStoreInfoAnnotationMap::handle() {
+  if (s_instance == 0) {
+    create();
+  }
+  return s_handle;
+}
+
+// Create the singleton instance and register the map in PropertySet
+// for getProperty
+void DeadStoreInfoAnnotationMap::create() {
+  s_instance = new DeadStoreInfoAnnotationMap();
+  analysisResults.add_instance(s_handle, s_instance);
+}
+
+DeadStoreInfoAnnotationMap * DeadStoreInfoAnnotationMap::s_instance = 0;
+PropertyHndlT DeadStoreInfoAnnotationMap::s_handle = "DeadStoreInfo";
+
+} // end namespace RAnnot
@@ -22,10 +22,17 @@
 //
 // Author: John Garvin (garvin@cs.rice.edu)
 
+#include <cxxabi.h>
+#include <stdlib.h>
+
+#include <typeinfo>
+
 #include "DefaultAnnotationMap.h"
 
 #include <support/RccError.h>
 
+#include <CompileReport.h>
+
 namespace RAnnot {
 
 // ----- type definitions for readability -----
@@ -87,11 +94,28 @@ void DefaultAnnotationMap::compute_if_necessary() {
     rcc_error("Compiler bug: annotation map depends on itself");
   }
   m_computation_in_progress = true;
-  compute();
+  if (CompileReport::instance()->enabled()) {
+    ReportPhase phase("analysis: " + report_name());
+    compute();
+  } else {
+    compute();
+  }
   m_computed = true;
   m_computation_in_progress = false;
 }
 
+// name of the concrete map class without its namespace, for the
+// compile report
+std::string DefaultAnnotationMap::report_name() const {
+  const char * mangled = typeid(*this).name();
+  int status;
+  char * demangled = abi::__cxa_demangle(mangled, 0, 0, &status);
+  std::string name = (status == 0 ? demangled : mangled);
+  free(demangled);
+  std::string::size_type colons = name.rfind("::");
+  return (colons == std::string::npos ? name : name.substr(colons + 2));
+}
+
 void DefaultAnnotationMap::reset() {
   std::map<MyKeyT, MyMappedT>::iterator iter;
   for (iter = m_map.begin(); iter != m_map.end(); ++iter) {
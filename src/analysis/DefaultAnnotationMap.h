@@ -26,6 +26,7 @@
 #define DEFAULT_ANNOTATION_MAP_H
 
 #include <map>
+#include <string>
 
 #include <analysis/AnnotationMap.h>
 
@@ -58,6 +59,7 @@ protected:
   void delete_map_values();
   void compute_if_necessary();
   virtual void compute() = 0;              // Template Method pattern
+  std::string report_name() const;
 
 private:
   bool m_computed;
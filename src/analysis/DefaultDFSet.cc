@@ -142,6 +142,16 @@ OA_ptr<DefaultDFSet> DefaultDFSet::intersect(OA_ptr<DefaultDFSet> other) {
   return result;
 }
 
+/// Set union
+OA_ptr<DefaultDFSet> DefaultDFSet::set_union(OA_ptr<DefaultDFSet> other) {
+  OA_ptr<DefaultDFSet> result; result = clone().convert<DefaultDFSet>();
+  std::set<OA_ptr<R_VarRef> >::const_iterator it;
+  for (it = other->m_set->begin(); it != other->m_set->end(); it++) {
+    result->insert(*it);
+  }
+  return result;
+}
+
 /// Union in a set of variables associated with a given statement
 void DefaultDFSet::insert_varset(OA_ptr<R_VarRefSet> vars)
 {
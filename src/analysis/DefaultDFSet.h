@@ -118,6 +118,8 @@ public:
 
   OA::OA_ptr<DefaultDFSet> intersect(OA::OA_ptr<DefaultDFSet> other);
 
+  OA::OA_ptr<DefaultDFSet> set_union(OA::OA_ptr<DefaultDFSet> other);
+
   OA::OA_ptr<std::set<SEXP> > as_sexp_set();
 
   // debugging
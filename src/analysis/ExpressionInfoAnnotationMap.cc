@@ -94,7 +94,7 @@ PropertyHndlT ExpressionInfoAnnotationMap::handle() {
 // for getProperty
 void ExpressionInfoAnnotationMap::create() {
   s_instance = new ExpressionInfoAnnotationMap();
-  analysisResults.add(s_handle, s_instance);
+  analysisResults.add_instance(s_handle, s_instance);
 }
 
 ExpressionInfoAnnotationMap * ExpressionInfoAnnotationMap::s_instance = 0;
@@ -22,10 +22,6 @@
 
 #include "ExpressionSideEffectAnnotationMap.h"
 
-#include <OpenAnalysis/SideEffect/ManagerInterSideEffectStandard.hpp>
-#include <OpenAnalysis/DataFlow/ManagerParamBindings.hpp>
-#include <OpenAnalysis/Alias/AliasTagSet.hpp>
-
 #include <analysis/AnalysisException.h>
 #include <analysis/AnalysisResults.h>
 #include <analysis/Analyst.h>
@@ -39,6 +35,7 @@
 #include <analysis/ResolvedArgsAnnotationMap.h>
 #include <analysis/Settings.h>
 #include <analysis/SideEffect.h>
+#include <analysis/SideEffectSummaryAnnotationMap.h>
 #include <analysis/SimpleIterators.h>
 
 #include <support/Debug.h>
@@ -102,7 +99,7 @@ PropertyHndlT ExpressionSideEffectAnnotationMap::handle() {
 
 void ExpressionSideEffectAnnotationMap::create() {
   s_instance = new ExpressionSideEffectAnnotationMap();
-  analysisResults.add(s_handle, s_instance);
+  analysisResults.add_instance(s_handle, s_instance);
 }
 
 ExpressionSideEffectAnnotationMap * ExpressionSideEffectAnnotationMap::s_instance = 0;
@@ -118,9 +115,6 @@ void ExpressionSideEffectAnnotationMap::compute() {
   OA_ptr<CFG::NodeInterface> node;
   StmtHandle stmt;
 
-  compute_oa_side_effect();
-  // now use m_side_effect to get info on expressions
-  
 #if 0
   ExpressionInfoAnnotationMap::const_iterator it;
   ExpressionInfoAnnotationMap * eiam = ExpressionInfoAnnotationMap::instance();
@@ -177,64 +171,9 @@ void ExpressionSideEffectAnnotationMap::compute() {
 
 }
 
-/// populate m_side_effect with OA side effect info
-void ExpressionSideEffectAnnotationMap::compute_oa_side_effect() {
-  OA_ptr<R_IRInterface> interface; interface = R_Analyst::instance()->get_interface();
-  OA_ptr<CallGraph::CallGraphInterface> call_graph;
-  call_graph = OACallGraphAnnotationMap::instance()->get_OA_call_graph();
-  m_alias = OACallGraphAnnotationMap::instance()->get_OA_alias();
-
-  OA::SideEffect::ManagerInterSideEffectStandard solver(interface);
-  // param bindings
-  DataFlow::ManagerParamBindings pb_man(interface);
-  OA_ptr<DataFlow::ParamBindings> param_bindings; param_bindings = pb_man.performAnalysis(call_graph);
-
-  // intra side effect information
-  OA_ptr<OA::SideEffect::ManagerSideEffectStandard> intra_man;
-  intra_man = new OA::SideEffect::ManagerSideEffectStandard(interface);
-
-  // compute side effect information
-  m_side_effect = solver.performAnalysis(call_graph, param_bindings, m_alias, intra_man, DataFlow::ITERATIVE);
-}
-
-void ExpressionSideEffectAnnotationMap::add_all_names_used(SideEffect * annot,
-						 OA_ptr<Alias::Interface> alias,
-						 OA_ptr<Alias::AliasTagIterator> tag_iter)
-{
-  for(; tag_iter->isValid(); ++(*tag_iter)) {
-    OA_ptr<MemRefExprIterator> mem_iter = alias->getMemRefExprIterator(tag_iter->current());
-    for (; mem_iter->isValid(); ++(*mem_iter)) {
-      if (mem_iter->current()->isaNamed()) {
-	OA_ptr<NamedRef> ref = mem_iter->current().convert<NamedRef>();
-	annot->insert_use(make_var_info(ref->getSymHandle()));
-      } else {
-	throw new AnalysisException("Not yet implemented");
-      }
-    }
-  }
-}
-
-void ExpressionSideEffectAnnotationMap::add_all_names_defined(SideEffect * annot,
-						    OA_ptr<Alias::Interface> alias,
-						    OA_ptr<Alias::AliasTagIterator> tag_iter)
-{
-  for(; tag_iter->isValid(); ++(*tag_iter)) {
-    OA_ptr<MemRefExprIterator> mem_iter = alias->getMemRefExprIterator(tag_iter->current());
-    for (; mem_iter->isValid(); ++(*mem_iter)) {
-      if (mem_iter->current()->isaNamed()) {
-	OA_ptr<NamedRef> ref = mem_iter->current().convert<NamedRef>();
-	annot->insert_def(make_var_info(ref->getSymHandle()));
-      } else {
-	throw new AnalysisException("Not yet implemented");
-      }
-    }
-  }
-}
-
 void ExpressionSideEffectAnnotationMap::make_side_effect(const ProcHandle ph, const SEXP cell) {
   SEXP cs_c, use, def;
 
-  OA_ptr<Alias::Interface> alias = m_alias->getAliasResults(ph);
   SEXP e = CAR(cell);
   ExpressionInfo * expr = getProperty(ExpressionInfo, cell);
   ExpressionSideEffect * annot = new ExpressionSideEffect(expression_is_trivial(e), expression_is_cheap(e));
@@ -247,16 +186,14 @@ void ExpressionSideEffectAnnotationMap::make_side_effect(const ProcHandle ph, co
     annot->insert_def_sexp(def);
   }
 
-  // now grab side effects due to procedure calls: get interprocedural
-  // uses and defs from m_side_effect
+  // now grab side effects due to procedure calls: interprocedural
+  // uses and defs from the callees' summaries
+  SideEffectSummaryAnnotationMap * summaries = SideEffectSummaryAnnotationMap::instance();
   EXPRESSION_FOR_EACH_CALL_SITE(expr, cs_c) {
     if (call_may_have_action(CAR(cs_c))) {
       annot->set_action(true);
     }
-    
-    CallHandle call_handle = make_call_h(CAR(cs_c));
-    add_all_names_used(annot->get_side_effect(), alias, m_side_effect->getREFIterator(call_handle));
-    add_all_names_defined(annot->get_side_effect(), alias, m_side_effect->getMODIterator(call_handle));
+    summaries->add_call_side_effect(CAR(cs_c), annot->get_side_effect());
   }
   
   if (debug) {
@@ -266,17 +203,26 @@ void ExpressionSideEffectAnnotationMap::make_side_effect(const ProcHandle ph, co
   get_map()[cell] = annot;
 } 
 
+bool ExpressionSideEffectAnnotationMap::is_trivial(const SEXP e) {
+  compute_if_necessary();  // library data
+  return expression_is_trivial(e);
+}
+
 // an expression is trivially evaluable if it cannot diverge, throw an
 // error/exception, or have any side effect. Used for call-by-value
 // transformation: if the callee is non-strict in some formal
 // argument, then the call-by-value transformation is valid if there
 // is no dependence between pre-debut code and the corresponding
 // actual argument and the actual argument is trivially evaluable.
+//
+// A variable may be unbound and a subscript may be out of bounds or
+// dispatch on a class, so they are trivial only in a program assumed
+// correct; call_may_throw_error makes the same assumption for calls.
 bool ExpressionSideEffectAnnotationMap::expression_is_trivial(const SEXP e) {
-  if (is_const(e) || is_var(e) || is_subscript(e)) {
+  if (is_const(e)) {
     return true;
-
-    // TODO: and (assume-correct-program or call cannot throw error)
+  } else if (is_var(e) || is_subscript(e)) {
+    return Settings::instance()->get_assume_correct_program();
   } else if (is_call(e) &&
 	     ! call_may_have_action(e) &&
 	     ! call_may_throw_error(e))
@@ -29,7 +29,6 @@
 #include <vector>
 
 #include <OpenAnalysis/IRInterface/IRHandles.hpp>
-#include <OpenAnalysis/SideEffect/InterSideEffectStandard.hpp>
 
 #include <analysis/DefaultAnnotationMap.h>
 #include <analysis/PropertyHndl.h>
@@ -59,12 +58,16 @@ public:
   /// getting the name causes this map to be created and registered
   static PropertyHndlT handle();
 
+  /// Can the expression be evaluated (or skipped) without any effect
+  /// other than producing its value? For expressions that are not
+  /// statements or arguments and so have no annotation of their own.
+  bool is_trivial(const SEXP e);
+
 private:
   /// private constructor for singleton pattern
   explicit ExpressionSideEffectAnnotationMap();
 
   void compute();
-  void compute_oa_side_effect();
   void make_side_effect(const OA::ProcHandle ph, const SEXP e);
 
   void init_lib_data();
@@ -75,19 +78,10 @@ private:
   bool call_may_be_expensive(const SEXP e);
   bool call_may_throw_error(const SEXP e);
 
-  void add_all_names_used(SideEffect * annot,
-			  OA::OA_ptr<OA::Alias::Interface> alias,
-			  OA::OA_ptr<OA::Alias::AliasTagIterator> tag_iter);
-  void add_all_names_defined(SideEffect * annot,
-			     OA::OA_ptr<OA::Alias::Interface> alias,
-			     OA::OA_ptr<OA::Alias::AliasTagIterator> tag_iter);
-
   static ExpressionSideEffectAnnotationMap * s_instance;
   static PropertyHndlT s_handle;
   static void create();
 
-  OA::OA_ptr<OA::SideEffect::InterSideEffectStandard> m_side_effect;
-  OA::OA_ptr<OA::Alias::InterAliasInterface> m_alias;
   SideEffectLibMap m_non_action_libs;
 };
 
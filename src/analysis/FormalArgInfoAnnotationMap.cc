@@ -65,7 +65,7 @@ PropertyHndlT FormalArgInfoAnnotationMap::handle() {
 
 void FormalArgInfoAnnotationMap::create() {
   s_instance = new FormalArgInfoAnnotationMap();
-  analysisResults.add(s_handle, s_instance);
+  analysisResults.add_instance(s_handle, s_instance);
 }
 
 void FormalArgInfoAnnotationMap::compute() {
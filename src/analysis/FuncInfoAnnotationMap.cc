@@ -80,7 +80,7 @@ PropertyHndlT FuncInfoAnnotationMap::handle() {
 
 void FuncInfoAnnotationMap::create() {
   s_instance = new FuncInfoAnnotationMap();
-  analysisResults.add(s_handle, s_instance);
+  analysisResults.add_instance(s_handle, s_instance);
 }
 
 FuncInfo * FuncInfoAnnotationMap::get_scope_tree_root() {
@@ -40,6 +40,7 @@
 #include <analysis/HandleInterface.h>
 #include <analysis/HellProcedure.h>
 #include <analysis/LexicalScope.h>
+#include <analysis/LoweredIR.h>
 #include <analysis/MemRefExprInterface.h>
 #include <analysis/OACallGraphAnnotationMap.h>
 #include <analysis/ResolvedArgs.h>
@@ -63,7 +64,6 @@ using namespace OA;
 using namespace RAnnot;
 using namespace HandleInterface;
 
-static bool debug = false;
 
 static OA_ptr<MemRefExprIterator> make_singleton_mre_iterator(OA_ptr<MemRefExpr> mre);
 
@@ -76,7 +76,7 @@ static OA_ptr<MemRefExprIterator> make_singleton_mre_iterator(OA_ptr<MemRefExpr>
 OA_ptr<IRRegionStmtIterator> R_IRInterface::procBody(ProcHandle h) {
   assert(h != HellProcedure::instance());
   OA_ptr<IRRegionStmtIterator> ptr;
-  ptr = new R_RegionStmtIterator(make_stmt_h(procedure_body_c(make_sexp(h))));
+  ptr = new R_LoweredStmtIterator(LoweredIR::instance()->region(procedure_body_c(make_sexp(h))));
   return ptr;
 }
 
@@ -140,14 +140,15 @@ StmtLabel R_IRInterface::getLabel(StmtHandle h) {
 OA_ptr<IRRegionStmtIterator> R_IRInterface::getFirstInCompound(StmtHandle h) {
   SEXP cell = make_sexp(h);
   SEXP e = CAR(cell);
+  LoweredIR * lir = LoweredIR::instance();
   OA_ptr<IRRegionStmtIterator> ptr;
   if (is_curly_list(e)) {
-    // use the iterator that doesn't take a cell
-    ptr = new R_RegionStmtListIterator(curly_body(e));
+    // the body is a list of statements, not a cell
+    ptr = new R_LoweredStmtIterator(lir->region_list(curly_body(e)));
   } else if (is_paren_exp(e)) {
-    ptr = new R_RegionStmtIterator(make_stmt_h(paren_body_c(e)));
+    ptr = new R_LoweredStmtIterator(lir->region(paren_body_c(e)));
   } else if (is_fundef(e)) {
-    ptr = new R_RegionStmtIterator(make_stmt_h(fundef_body_c(e)));
+    ptr = new R_LoweredStmtIterator(lir->region(fundef_body_c(e)));
   } else {
     rcc_error("getFirstInCompound: unrecognized statement type");
   }
@@ -161,7 +162,7 @@ OA_ptr<IRRegionStmtIterator> R_IRInterface::getFirstInCompound(StmtHandle h) {
 /// Given a loop statement, return an IRRegionStmtIterator for the loop body.
 OA_ptr<IRRegionStmtIterator> R_IRInterface::loopBody(StmtHandle h) {
   OA_ptr<IRRegionStmtIterator> ptr;
-  ptr = new R_RegionStmtIterator(make_stmt_h(loop_body_c(CAR(make_sexp(h)))));
+  ptr = new R_LoweredStmtIterator(LoweredIR::instance()->region(loop_body_c(CAR(make_sexp(h)))));
   return ptr;
 }
 
@@ -211,7 +212,7 @@ bool R_IRInterface::loopIterationsDefinedAtEntry(StmtHandle h) {
 /// under the "if" clause).
 OA_ptr<IRRegionStmtIterator> R_IRInterface::trueBody(StmtHandle h) {
   OA_ptr<IRRegionStmtIterator> ptr;
-  ptr = new R_RegionStmtIterator(make_stmt_h(if_truebody_c(CAR(make_sexp(h)))));
+  ptr = new R_LoweredStmtIterator(LoweredIR::instance()->region(if_truebody_c(CAR(make_sexp(h)))));
   return ptr;
 }
 
@@ -222,9 +223,9 @@ OA_ptr<IRRegionStmtIterator> R_IRInterface::elseBody(StmtHandle h) {
   OA_ptr<IRRegionStmtIterator> ptr;
   SEXP else_body = if_falsebody_c(CAR(make_sexp(h)));
   if (else_body == R_NilValue) {
-    ptr = new R_RegionStmtListIterator(R_NilValue);  // empty iterator
+    ptr = new R_LoweredStmtIterator(LoweredIR::instance()->region_list(R_NilValue));  // empty iterator
   } else {
-    ptr = new R_RegionStmtIterator(make_stmt_h(else_body));
+    ptr = new R_LoweredStmtIterator(LoweredIR::instance()->region(else_body));
   }
   return ptr;
 }
@@ -344,7 +345,7 @@ OA_ptr<IRStmtIterator> R_IRInterface::getStmtIterator(ProcHandle h) {
   assert(h != HellProcedure::instance());
   // unlike procBody, here we want an iterator that descends into compound statements.
   OA_ptr<IRRegionStmtIterator> ptr;
-  ptr = new R_DescendingStmtIterator(make_stmt_h(procedure_body_c(make_sexp(h))));
+  ptr = new R_LoweredStmtIterator(LoweredIR::instance()->descendants(procedure_body_c(make_sexp(h))));
   return ptr;
 }
 
@@ -352,8 +353,8 @@ OA_ptr<IRStmtIterator> R_IRInterface::getStmtIterator(ProcHandle h) {
 /// in the given statement.  Order that memory references are iterated
 /// over can be arbitrary.
 OA_ptr<MemRefHandleIterator> R_IRInterface::getAllMemRefs(StmtHandle stmt) {
-  ExpressionInfo * ei = getProperty(ExpressionInfo, make_sexp(stmt));
-  OA_ptr<MemRefHandleIterator> iter; iter = new R_ExpMemRefHandleIterator(ei);
+  const LoweredIR::StmtRecord & rec = LoweredIR::instance()->stmt(make_sexp(stmt));
+  OA_ptr<MemRefHandleIterator> iter; iter = new R_LoweredMemRefIterator(rec.mentions);
   return iter;
 }
 
@@ -405,8 +406,9 @@ SymHandle R_IRInterface::getFormalSym(ProcHandle proc, int n) {
 
 /// Return an iterator over all of the callsites in a given stmt
 OA_ptr<IRCallsiteIterator> R_IRInterface::getCallsites(StmtHandle h) {
-  // R_IRProgramCallsiteIterator (as opposed to R_IRCallsiteIterator) does not include internal calls
-  OA_ptr<IRCallsiteIterator> iter; iter = new R_IRProgramCallsiteIterator(h);
+  // unlike R_IRCallsiteIterator, does not include internal calls
+  const LoweredIR::StmtRecord & rec = LoweredIR::instance()->stmt(make_sexp(h));
+  OA_ptr<IRCallsiteIterator> iter; iter = new R_LoweredCallsiteIterator(rec.program_calls);
   return iter;
 }
 
@@ -616,18 +618,9 @@ OA_ptr<SideEffect::SideEffectStandard> R_IRInterface::getSideEffect(ProcHandle c
 /// Return a list of all the target memory reference handles that appear
 /// in the given statement.
 OA_ptr<MemRefHandleIterator> R_IRInterface::getDefMemRefs(StmtHandle h) {
-  SEXP def;
-  VarRefFactory * fact = VarRefFactory::instance();
-  ExpressionInfo * stmt_info = getProperty(ExpressionInfo, make_sexp(h));
-  assert(stmt_info != 0);
-
-  OA_ptr<R_VarRefSet> defs; defs = new R_VarRefSet;
-  EXPRESSION_FOR_EACH_DEF(stmt_info, def) {
-    OA_ptr<R_BodyVarRef> bvr; bvr = fact->make_body_var_ref(def);
-    defs->insert_ref(bvr);
-  }
+  const LoweredIR::StmtRecord & rec = LoweredIR::instance()->stmt(make_sexp(h));
   OA_ptr<MemRefHandleIterator> retval;
-  retval = new R_UseDefAsMemRefIterator(defs->get_iterator());
+  retval = new R_LoweredMemRefIterator(rec.defs);
   return retval;
 }
 
@@ -635,18 +628,9 @@ OA_ptr<MemRefHandleIterator> R_IRInterface::getDefMemRefs(StmtHandle h) {
 /// Return a list of all the source memory reference handles that appear
 /// in the given statement.
 OA_ptr<MemRefHandleIterator> R_IRInterface::getUseMemRefs(StmtHandle h) {
-  SEXP use;
-  VarRefFactory * fact = VarRefFactory::instance();
-  ExpressionInfo * stmt_info = getProperty(ExpressionInfo, make_sexp(h));
-  assert(stmt_info != 0);
-
-  OA_ptr<R_VarRefSet> uses; uses = new R_VarRefSet;
-  EXPRESSION_FOR_EACH_USE(stmt_info, use) {
-    OA_ptr<R_BodyVarRef> bvr; bvr = fact->make_body_var_ref(use);
-    uses->insert_ref(bvr);
-  }
+  const LoweredIR::StmtRecord & rec = LoweredIR::instance()->stmt(make_sexp(h));
   OA_ptr<MemRefHandleIterator> retval;
-  retval = new R_UseDefAsMemRefIterator(uses->get_iterator());
+  retval = new R_LoweredMemRefIterator(rec.uses);
   return retval;
 }
 
@@ -655,34 +639,16 @@ OA_ptr<MemRefHandleIterator> R_IRInterface::getUseMemRefs(StmtHandle h) {
 //--------------------------------------------------------
 
 OA_ptr<SSA::IRUseDefIterator> R_IRInterface::getDefs(StmtHandle h) {
-  SEXP def;
-  ExpressionInfo * stmt_info = getProperty(ExpressionInfo, make_sexp(h));
-  assert(stmt_info != 0);
-
-  OA_ptr<R_VarRefSet> defs; defs = new R_VarRefSet;
-  VarRefFactory * fact = VarRefFactory::instance();
-  EXPRESSION_FOR_EACH_DEF(stmt_info, def) {
-    OA_ptr<R_BodyVarRef> bvr; bvr = fact->make_body_var_ref(def);
-    defs->insert_ref(bvr);
-  }
+  const LoweredIR::StmtRecord & rec = LoweredIR::instance()->stmt(make_sexp(h));
   OA_ptr<SSA::IRUseDefIterator> retval;
-  retval = new R_UseDefAsLeafIterator(defs->get_iterator());
+  retval = new R_LoweredLeafIterator(rec.defs);
   return retval;
 }
 
 OA_ptr<SSA::IRUseDefIterator> R_IRInterface::getUses(StmtHandle h) {
-  SEXP use;
-  ExpressionInfo * stmt_info = getProperty(ExpressionInfo, make_sexp(h));
-  assert(stmt_info != 0);
-
-  OA_ptr<R_VarRefSet> uses; uses = new R_VarRefSet;
-  VarRefFactory * fact = VarRefFactory::instance();
-  EXPRESSION_FOR_EACH_USE(stmt_info, use) {
-    OA_ptr<R_BodyVarRef> bvr; bvr = fact->make_body_var_ref(use);
-    uses->insert_ref(bvr);
-  }
+  const LoweredIR::StmtRecord & rec = LoweredIR::instance()->stmt(make_sexp(h));
   OA_ptr<SSA::IRUseDefIterator> retval;
-  retval = new R_UseDefAsLeafIterator(uses->get_iterator());
+  retval = new R_LoweredLeafIterator(rec.uses);
   return retval;
 }
 
@@ -771,239 +737,6 @@ std::string R_IRInterface::toString(CallHandle h) const {
   return to_string(make_sexp(h));
 }
 
-//--------------------------------------------------------------------
-// R_RegionStmtIterator
-//
-// Statement iterator that does not descend into compound statements.
-//--------------------------------------------------------------------
-
-R_RegionStmtIterator::R_RegionStmtIterator(OA::StmtHandle stmt) {
-  build_stmt_list(stmt);
-}
-
-R_RegionStmtIterator::~R_RegionStmtIterator() {
-  delete stmt_iter_ptr;
-}
-
-StmtHandle R_RegionStmtIterator::current() const {
-  return make_stmt_h(stmt_iter_ptr->current());
-}
-
-bool R_RegionStmtIterator::isValid() const { 
-  return stmt_iter_ptr->isValid(); 
-}
-
-void R_RegionStmtIterator::operator++() {
-  ++*stmt_iter_ptr;
-}
-
-void R_RegionStmtIterator::reset() {
-  stmt_iter_ptr->reset();
-}
-
-/// Build the list of statements for iterator. Does not descend into
-/// compound statements. The given StmtHandle is a CONS cell whose CAR
-/// is the actual expression.
-void R_RegionStmtIterator::build_stmt_list(StmtHandle stmt) {
-  SEXP cell = make_sexp(stmt);
-  if (cell == R_NilValue) {
-    return;
-  }
-  assert(is_cons(cell));
-  SEXP exp = CAR(cell);
-  switch (getSexpCfgType(exp)) {
-  case CFG::SIMPLE:
-    if (exp == R_NilValue) {
-      stmt_iter_ptr = new R_ListIterator(R_NilValue);  // empty iterator
-    } else {
-      stmt_iter_ptr = new R_SingletonSEXPIterator(cell);
-    }
-    break;
-  case CFG::LOOP:
-  case CFG::STRUCT_TWOWAY_CONDITIONAL:
-  case CFG::RETURN:
-  case CFG::BREAK:
-  case CFG::LOOP_CONTINUE:
-    stmt_iter_ptr = new R_SingletonSEXPIterator(cell);
-    break;
-  case CFG::COMPOUND:
-    if (is_curly_list(exp)) {
-      // Special case for a list of statments in curly braces.
-      // CDR(exp), our list of statements, is not in a cell. But it is
-      // guaranteed to be a list or nil, so we can call the iterator
-      // that doesn't take a cell.
-      stmt_iter_ptr = new R_ListIterator(CDR(exp));
-    } else {
-      // We have a non-loop compound statement with a body. (body_c is
-      // the cell containing the body.) This body might be a list for
-      // which we're returning an iterator, or it might be some other
-      // thing. First we figure out what the body is.
-      SEXP body_c;
-      if (is_fundef(exp)) {
-	body_c = fundef_body_c(exp);
-      } else if (is_paren_exp(exp)) {
-	body_c = paren_body_c(exp);
-      }
-      // Now return the appropriate iterator.
-      if (TYPEOF(CAR(body_c)) == NILSXP || TYPEOF(CAR(body_c)) == LISTSXP) {
-	stmt_iter_ptr = new R_ListIterator(CAR(body_c));
-      } else {
-	stmt_iter_ptr = new R_SingletonSEXPIterator(body_c);
-      }
-    }
-    break;
-  default:
-    rcc_error("R_RegionStmtIterator::build_stmt_list: unrecognized CFG statement type");
-    break;
-  }
-}
-
-//------------------------------------------------------------
-// R_DescendingStmtIterator
-//------------------------------------------------------------
-
-R_DescendingStmtIterator::R_DescendingStmtIterator(OA::StmtHandle stmt) {
-  build_stmt_list(make_sexp(stmt));
-  m_iter = m_stmts.begin();
-}
-
-R_DescendingStmtIterator::~R_DescendingStmtIterator() {
-}
-
-StmtHandle R_DescendingStmtIterator::current() const {
-  return *m_iter;
-}
-
-bool R_DescendingStmtIterator::isValid() const {
-  return (m_iter != m_stmts.end());
-}
-
-void R_DescendingStmtIterator::operator++() {
-  ++m_iter;
-}
-
-void R_DescendingStmtIterator::reset() {
-  m_iter = m_stmts.begin();
-}
-
-void R_DescendingStmtIterator::build_stmt_list(SEXP exp_c) {
-  assert(exp_c != 0);
-  if (exp_c == R_NilValue) {
-    return;
-  }
-  assert(is_cons(exp_c));
-  SEXP exp = CAR(exp_c);
-  switch(getSexpCfgType(exp)) {
-  case CFG::COMPOUND:
-    if (is_curly_list(exp)) {
-      for (SEXP e = curly_body(exp); e != R_NilValue; e = CDR(e)) {
-	build_stmt_list(e);
-      }
-    } else if (is_fundef(exp)) {
-      // no-op
-      // (nested fundefs are NOT counted as part of the parent)
-    } else if (is_paren_exp(exp)) {
-      build_stmt_list(paren_body_c(exp));
-    }
-    break;
-  case CFG::LOOP:
-    if (is_for(exp)) {
-      build_stmt_list(for_range_c(exp));
-      build_stmt_list(for_body_c(exp));
-    } else if (is_while(exp)) {
-      build_stmt_list(while_cond_c(exp));
-      build_stmt_list(while_body_c(exp));
-    } else if (is_repeat(exp)) {
-      build_stmt_list(repeat_body_c(exp));
-    }
-    break;
-  case CFG::STRUCT_TWOWAY_CONDITIONAL:  // a.k.a. "if"
-    build_stmt_list(if_truebody_c(exp));
-    build_stmt_list(if_falsebody_c(exp));
-    break;
-  default:  // including CFG::SIMPLE
-    if (exp != R_NilValue) {
-      m_stmts.push_back(make_stmt_h(exp_c));
-    }
-  }
-}
-
-//--------------------------------------------------------------------
-// R_RegionStmtListIterator
-//--------------------------------------------------------------------
-
-StmtHandle R_RegionStmtListIterator::current() const {
-  return make_stmt_h(iter.current());
-}
-
-bool R_RegionStmtListIterator::isValid() const {
-  return iter.isValid();
-}
-
-void R_RegionStmtListIterator::operator++() {
-  ++iter;
-}
-
-void R_RegionStmtListIterator::reset() {
-  iter.reset(); 
-}
-
-//--------------------------------------------------------------------
-// R_UseDefAsLeafIterator
-//--------------------------------------------------------------------
-
-R_UseDefAsLeafIterator::R_UseDefAsLeafIterator(OA_ptr<R_VarRefSetIterator> iter)
-  : m_iter(iter)
-{
-}
-
-R_UseDefAsLeafIterator::~R_UseDefAsLeafIterator() {
-}
-
-LeafHandle R_UseDefAsLeafIterator::current() const {
-  return make_leaf_h(m_iter->current()->get_sexp());
-}
- 
-bool R_UseDefAsLeafIterator::isValid() {
-  return m_iter->isValid();
-}
-
-void R_UseDefAsLeafIterator::operator++() {
-  ++*m_iter;
-}
-
-void R_UseDefAsLeafIterator::reset() {
-  m_iter->reset();
-}
-
-//------------------------------------------------------------
-// R_UseDefAsMemRefIterator
-//------------------------------------------------------------
-
-R_UseDefAsMemRefIterator::R_UseDefAsMemRefIterator(OA_ptr<R_VarRefSetIterator> iter)
-  : m_iter(iter)
-{
-}
-
-R_UseDefAsMemRefIterator::~R_UseDefAsMemRefIterator() {
-}
-
-MemRefHandle R_UseDefAsMemRefIterator::current() const {
-  return make_mem_ref_h(m_iter->current()->get_sexp());
-}
- 
-bool R_UseDefAsMemRefIterator::isValid() const {
-  return m_iter->isValid();
-}
-
-void R_UseDefAsMemRefIterator::operator++() {
-  ++*m_iter;
-}
-
-void R_UseDefAsMemRefIterator::reset() {
-  m_iter->reset();
-}
-
 //--------------------------------------------------------------------
 // R_IRCallsiteIterator
 //--------------------------------------------------------------------
@@ -1035,47 +768,6 @@ void R_IRCallsiteIterator::reset() {
   m_current = m_begin;
 }
 
-//--------------------------------------------------------------------
-// R_IRProgramCallsiteIterator
-//--------------------------------------------------------------------
-
-R_IRProgramCallsiteIterator::R_IRProgramCallsiteIterator(StmtHandle _h)
-  : m_annot(getProperty(ExpressionInfo, make_sexp(_h)))
-{
-  SEXP csi_c;
-  // In the ExpressionInfo's call sites, collect only non-internal calls
-  EXPRESSION_FOR_EACH_CALL_SITE(m_annot, csi_c) {
-    if (is_var(call_lhs(CAR(csi_c))) && !is_library(call_lhs(CAR(csi_c)))) {
-      if (debug) {
-	std::cout << "ProgramCallsiteIterator: adding call site ";
-	Rf_PrintValue(CAR(csi_c));
-      }
-      m_program_call_sites.push_back(csi_c);
-    }
-  }
-  m_current = m_program_call_sites.begin();
-}
-
-R_IRProgramCallsiteIterator::~R_IRProgramCallsiteIterator() {
-}
-
-CallHandle R_IRProgramCallsiteIterator::current() const {
-  return make_call_h(CAR(*m_current));
-}
-
-bool R_IRProgramCallsiteIterator::isValid() const {
-  return (m_current != m_program_call_sites.end());
-}
-
-void R_IRProgramCallsiteIterator::operator++() {
-  ++m_current;
-}
-
-void R_IRProgramCallsiteIterator::reset() {
-  m_current = m_program_call_sites.begin();
-}
-
-
 //----------------------------------------------------------------------
 // R_ProcHandleIterator
 //----------------------------------------------------------------------
@@ -1108,47 +800,6 @@ void R_ProcHandleIterator::reset() {
   m_fii->Reset();
 }
 
-//------------------------------------------------------------
-// R_ExpMemRefHandleIterator
-//------------------------------------------------------------
-
-R_ExpMemRefHandleIterator::R_ExpMemRefHandleIterator(ExpressionInfo * stmt)
-  : m_stmt(stmt),
-    m_use_iter(stmt->begin_uses()),
-    m_def_iter(stmt->begin_defs())
-{
-}
-
-MemRefHandle R_ExpMemRefHandleIterator::current() const {
-  MemRefHandle handle;
-  if (m_use_iter != m_stmt->end_uses()) {
-    handle = make_mem_ref_h(*m_use_iter);
-  } else {
-    handle = make_mem_ref_h(*m_def_iter);
-  }
-  assert(handle != MemRefHandle(0));
-  return handle;
-}
-
-bool R_ExpMemRefHandleIterator::isValid() const {
-  return (!(m_use_iter == m_stmt->end_uses() &&
-	    m_def_iter == m_stmt->end_defs()));
-}
-
-void R_ExpMemRefHandleIterator::operator++() {
-  assert(isValid());
-  if (m_use_iter != m_stmt->end_uses()) {
-    ++m_use_iter;
-  } else {
-    ++m_def_iter;
-  }
-}
-
-void R_ExpMemRefHandleIterator::reset() {
-  m_use_iter = m_stmt->begin_uses();
-  m_def_iter = m_stmt->begin_defs();
-}
-
 //------------------------------------------------------------
 // R_ParamBindIterator
 //------------------------------------------------------------
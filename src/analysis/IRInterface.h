@@ -26,9 +26,9 @@
 //
 // Author: John Garvin (garvin@cs.rice.edu)
 
-#include <list>
 #include <string>
 #include <ostream>
+#include <vector>
 
 #include <OpenAnalysis/CFG/ManagerCFG.hpp>
 #include <OpenAnalysis/IRInterface/AliasIRInterface.hpp>
@@ -43,6 +43,8 @@
 
 #include <analysis/ExpressionInfo.h>
 #include <analysis/FuncInfo.h>
+#include <analysis/HandleInterface.h>
+#include <analysis/LoweredIR.h>
 #include <analysis/SimpleIterators.h>
 #include <analysis/Utils.h>
 #include <analysis/VarRefSet.h>
@@ -346,89 +348,46 @@ OA::CFG::IRStmtType getSexpCfgType(SEXP e);
 // Iterators
 //--------------------------------------------------------------------
 
-/// Enumerate all the statements in a program region, e.g. all the statements
-/// in a procedure or a loop. Does not descend into compound statements.
-class R_RegionStmtIterator : public OA::IRRegionStmtIterator {
+/// Enumerate a range of the cells in the LoweredIR, giving each one
+/// as the kind of handle the OA iterator interface returns. Lowering
+/// happens when the range is asked for, so an iterator only walks an
+/// index through the shared vector.
+template<class IterT, class HandleT, HandleT (*make_handle)(const SEXP)>
+class R_LoweredRangeIterator : public IterT {
 public:
-  explicit R_RegionStmtIterator(OA::StmtHandle stmt);
-  virtual ~R_RegionStmtIterator();
-  
-  OA::StmtHandle current() const;
-  bool isValid() const;
-  void operator++();
-  void reset();
+  explicit R_LoweredRangeIterator(const LoweredIR::Range & range)
+    : m_cells(LoweredIR::instance()->cells()), m_range(range), m_current(range.begin)
+  { }
+  virtual ~R_LoweredRangeIterator() { }
+
+  HandleT current() const { return make_handle(m_cells[m_current]); }
+  bool isValid() const { return m_current < m_range.end; }
+  // IRUseDefIterator declares isValid non-const
+  bool isValid() { return m_current < m_range.end; }
+  void operator++() { ++m_current; }
+  void reset() { m_current = m_range.begin; }
 
 private:
-  R_SEXPIterator * stmt_iter_ptr;
-  void build_stmt_list(OA::StmtHandle stmt);
+  const std::vector<SEXP> & m_cells;
+  const LoweredIR::Range m_range;
+  unsigned int m_current;
 };
 
-// Enumerate statements; descends into compound statements.
-class R_DescendingStmtIterator : public OA::IRStmtIterator {
-public:
-  explicit R_DescendingStmtIterator(OA::StmtHandle stmt);
-  virtual ~R_DescendingStmtIterator();
+/// Statements of a region or procedure
+typedef R_LoweredRangeIterator<OA::IRRegionStmtIterator, OA::StmtHandle,
+			       HandleInterface::make_stmt_h> R_LoweredStmtIterator;
 
-  OA::StmtHandle current() const;
-  bool isValid() const;
-  void operator++();
-  void reset();
+/// Variable mentions of a statement as memory references
+typedef R_LoweredRangeIterator<OA::MemRefHandleIterator, OA::MemRefHandle,
+			       HandleInterface::make_mem_ref_h> R_LoweredMemRefIterator;
 
-private:
-  void build_stmt_list(SEXP exp_c);
-
-  std::list<OA::StmtHandle>::const_iterator m_iter;
-  std::list<OA::StmtHandle> m_stmts;
-};
+/// Variable uses or defs of a statement for SSA construction
+typedef R_LoweredRangeIterator<OA::SSA::IRUseDefIterator, OA::LeafHandle,
+			       HandleInterface::make_leaf_h> R_LoweredLeafIterator;
 
-/// Special-case version of R_RegionStmtListIterator: iterates through
-/// each of a list of statements. Each element is returned as a cell.
-/// Useful when you can't pass a cell to R_RegionStmtIterator.
-class R_RegionStmtListIterator : public OA::IRRegionStmtIterator {
-public:
-  explicit R_RegionStmtListIterator(SEXP ls) : iter(ls) { }
-  virtual ~R_RegionStmtListIterator() { };
-  
-  OA::StmtHandle current() const;
-  bool isValid() const;
-  void operator++();
-  void reset();
-
-private:
-  R_ListIterator iter;
-};
-
-/// Enumerate all the variable uses or variable definitions in a statement.
-/// This is useful for analyses that require information about variable
-/// references or definitions, such as SSA construction.
-class R_UseDefAsLeafIterator : public OA::SSA::IRUseDefIterator {
-public:
-  explicit R_UseDefAsLeafIterator(OA::OA_ptr<R_VarRefSetIterator> _iter);
-  virtual ~R_UseDefAsLeafIterator();
-  
-  OA::LeafHandle current() const;
-  bool isValid();    // why is this not const in IRUseDefIterator?
-  void operator++();
-  void reset();
-private:
-  OA::OA_ptr<R_VarRefSetIterator> m_iter;
-};
-
-/// Enumerate all the variable uses or variable definitions in a statement.
-/// This is useful for analyses that require information about variable
-/// references or definitions, such as SSA construction.
-class R_UseDefAsMemRefIterator : public OA::MemRefHandleIterator {
-public:
-  explicit R_UseDefAsMemRefIterator(OA::OA_ptr<R_VarRefSetIterator> _iter);
-  virtual ~R_UseDefAsMemRefIterator();
-  
-  OA::MemRefHandle current() const;
-  bool isValid() const;
-  void operator++();
-  void reset();
-private:
-  OA::OA_ptr<R_VarRefSetIterator> m_iter;
-};
+/// Calls to program (not library) procedures in a statement
+typedef R_LoweredRangeIterator<OA::IRCallsiteIterator, OA::CallHandle,
+			       HandleInterface::make_call_h> R_LoweredCallsiteIterator;
 
 //--------------------------------------------------------------------
 // R_IRCallsiteIterator
@@ -454,29 +413,6 @@ private:
   RAnnot::ExpressionInfo::const_call_site_iterator m_current;
 };
 
-//--------------------------------------------------------------------
-// R_IRProgramCallsiteIterator
-//
-// Enumerate all the procedure calls in a statement, NOT including
-// calls to internal R procedures.
-//--------------------------------------------------------------------
-
-class R_IRProgramCallsiteIterator : public OA::IRCallsiteIterator {
-public:
-  explicit R_IRProgramCallsiteIterator(OA::StmtHandle _h);
-  virtual ~R_IRProgramCallsiteIterator();
-
-  OA::CallHandle current() const;
-  bool isValid() const;
-  void operator++();
-  void reset();
-
-private:
-  RAnnot::ExpressionInfo * const m_annot;
-  std::list<RAnnot::ExpressionInfo::MyCallSiteT> m_program_call_sites;
-  RAnnot::ExpressionInfo::const_call_site_iterator m_current;
-};
-
 class R_ProcHandleIterator : public OA::ProcHandleIterator {
 public:
   explicit R_ProcHandleIterator(RAnnot::FuncInfo * fi);
@@ -490,22 +426,6 @@ private:
   RAnnot::FuncInfoIterator * m_fii;
 };
 
-// iterator over all uses and defs
-// This uses two internal iterators: first we iterate through the uses, then the defs
-class R_ExpMemRefHandleIterator : public OA::MemRefHandleIterator {
-public:
-  explicit R_ExpMemRefHandleIterator(RAnnot::ExpressionInfo * stmt);
-  OA::MemRefHandle current() const;
-  bool isValid() const;
-  void operator++();
-  void reset();
-  
-private:
-  RAnnot::ExpressionInfo * m_stmt;
-  RAnnot::ExpressionInfo::const_use_iterator m_use_iter;
-  RAnnot::ExpressionInfo::const_def_iterator m_def_iter;
-};
-
 /// implements the iterator Alias::getParamBindAssignPtrIterator
 /// wants. Each element returned is a pair containing an index
 /// representing which formal argument and a MemRefExpr for the
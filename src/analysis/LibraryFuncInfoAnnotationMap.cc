@@ -78,7 +78,7 @@ PropertyHndlT LibraryFuncInfoAnnotationMap::s_handle = "LibraryFuncInfo";
 
 void LibraryFuncInfoAnnotationMap::create() {
   s_instance = new LibraryFuncInfoAnnotationMap();
-  analysisResults.add(s_handle, s_instance);
+  analysisResults.add_instance(s_handle, s_instance);
 }
 
 
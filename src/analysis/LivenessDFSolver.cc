@@ -0,0 +1,253 @@
+// -*- Mode: C++ -*-
+//
+// Copyright (c) 2009 Rice University
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation; either version 2 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+
+// File: LivenessDFSolver.cc
+//
+// Author: John Garvin (garvin@cs.rice.edu)
+
+#include <include/R/R_RInternals.h>
+
+#include <OpenAnalysis/IRInterface/IRHandles.hpp>
+#include <OpenAnalysis/DataFlow/CFGDFSolver.hpp>
+
+#include <support/Debug.h>
+
+#include <analysis/AnalysisResults.h>
+#include <analysis/DefaultDFSet.h>
+#include <analysis/ExpressionInfo.h>
+#include <analysis/ExpressionSideEffectAnnotationMap.h>
+#include <analysis/FuncInfo.h>
+#include <analysis/FuncInfoAnnotationMap.h>
+#include <analysis/IRInterface.h>
+#include <analysis/HandleInterface.h>
+#include <analysis/PropertySet.h>
+#include <analysis/Settings.h>
+#include <analysis/Utils.h>
+#include <analysis/VarRef.h>
+#include <analysis/Var.h>
+
+#include "LivenessDFSolver.h"
+
+using namespace RAnnot;
+using namespace OA;
+using namespace HandleInterface;
+
+typedef DefaultDFSet DFSet;
+
+static bool debug;
+
+LivenessDFSolver::LivenessDFSolver(OA_ptr<R_IRInterface> ir)
+  : m_ir(ir), m_fact(VarRefFactory::instance())
+{
+  RCC_DEBUG("RCC_LivenessDFSolver", debug);
+}
+
+LivenessDFSolver::~LivenessDFSolver()
+{}
+
+/// Perform the data flow analysis. Live sets only grow as the solver
+/// iterates, so rather than walking the statements again afterward,
+/// the transfer function records every candidate store it finds
+/// live; a candidate the solver reached but never found live is dead.
+OA_ptr<std::set<SEXP> > LivenessDFSolver::perform_analysis(FuncInfo * fi) {
+  m_fi = fi;
+  m_cfg = fi->get_cfg();
+  m_top = new DFSet();
+  m_candidates.clear();
+  m_live_stores.clear();
+
+  OA_ptr<std::set<SEXP> > dead; dead = new std::set<SEXP>();
+  if (!proc_is_candidate()) {
+    return dead;
+  }
+
+  // solve as a backward data flow problem
+  m_solver = new DataFlow::CFGDFSolver(DataFlow::CFGDFSolver::Backward, *this);
+  m_solver->solve(m_cfg, DataFlow::ITERATIVE);
+
+  std::set<SEXP>::const_iterator it;
+  for (it = m_candidates.begin(); it != m_candidates.end(); ++it) {
+    if (m_live_stores.find(*it) == m_live_stores.end()) {
+      dead->insert(*it);
+      if (debug) {
+	std::cout << "dead store: ";
+	Rf_PrintValue(CAR(*it));
+      }
+    }
+  }
+  return dead;
+}
+
+// ----- debugging -----
+
+void LivenessDFSolver::dump_node_maps() {
+  dump_node_maps(std::cout);
+}
+
+void LivenessDFSolver::dump_node_maps(std::ostream &os) {
+  OA_ptr<DataFlow::DataFlowSet> df_in_set, df_out_set;
+  OA_ptr<DFSet> in_set, out_set;
+  OA_ptr<CFG::NodesIteratorInterface> ni = m_cfg->getCFGNodesIterator();
+
+  for ( ; ni->isValid(); ++*ni) {
+    OA_ptr<CFG::NodeInterface> n = ni->current().convert<CFG::NodeInterface>();
+    df_in_set = m_solver->getInSet(n);
+    df_out_set = m_solver->getOutSet(n);
+    in_set = df_in_set.convert<DFSet>();
+    out_set = df_out_set.convert<DFSet>();
+    os << "CFG NODE #" << n->getId() << ":\n";
+    os << "IN SET:\n";
+    in_set->dump(os, m_ir);
+    os << "OUT SET:\n";
+    out_set->dump(os, m_ir);
+  }
+}
+
+// ----- callbacks for CFGDFProblem: initialization, meet, transfer -----
+
+/// TOP is the empty set: nothing is live.
+OA_ptr<DataFlow::DataFlowSet> LivenessDFSolver::initializeTop() {
+  return m_top;
+}
+
+/// Not used.
+OA_ptr<DataFlow::DataFlowSet> LivenessDFSolver::initializeBottom() {
+  assert(0);
+}
+
+/// Locals are dead on exit; the return value is a use in the
+/// statement that computes it.
+OA_ptr<DataFlow::DataFlowSet> LivenessDFSolver::initializeNodeIN(OA_ptr<CFG::NodeInterface> n) {
+  return m_top->clone();
+}
+
+OA_ptr<DataFlow::DataFlowSet> LivenessDFSolver::initializeNodeOUT(OA_ptr<CFG::NodeInterface> n) {
+  return m_top->clone();
+}
+
+/// Meet function. A name is live if it is live on any path.
+///
+/// Note: base class CFGDFProblem says: OK to modify set1 and return
+/// it as result, because solver only passes a tempSet in as set1
+OA_ptr<DataFlow::DataFlowSet>
+LivenessDFSolver::meet(OA_ptr<DataFlow::DataFlowSet> set1_orig, OA_ptr<DataFlow::DataFlowSet> set2_orig) {
+  OA_ptr<DFSet> set1; set1 = set1_orig.convert<DFSet>();
+  OA_ptr<DFSet> set2; set2 = set2_orig.convert<DFSet>();
+  return set1->set_union(set2);
+}
+
+/// Transfer function; the effect of a statement, going backward.
+/// Must-defs kill; uses and may-defs (partial updates like x[i] <- v,
+/// which read the old value of x) generate.
+///
+/// Note: base class CFGDFProblem says: OK to modify in set and return
+/// it again as result because solver clones the BB in sets
+OA_ptr<DataFlow::DataFlowSet>
+LivenessDFSolver::transfer(OA_ptr<DataFlow::DataFlowSet> in_dfs, StmtHandle stmt_handle) {
+  SEXP use, def;
+  OA_ptr<DFSet> in; in = in_dfs.convert<DFSet>();
+  SEXP cell = make_sexp(stmt_handle);
+  ExpressionInfo * annot = getProperty(ExpressionInfo, cell);
+
+  if (is_candidate(cell)) {
+    m_candidates.insert(cell);
+    OA_ptr<R_VarRef> lhs; lhs = m_fact->make_body_var_ref(assign_lhs_c(CAR(cell)));
+    if (in->includes_name(lhs)) {
+      m_live_stores.insert(cell);
+    }
+  }
+
+  EXPRESSION_FOR_EACH_DEF(annot, def) {
+    Var * def_annot = getProperty(Var, def);
+    if (def_annot->get_scope_type() == Locality::Locality_LOCAL &&
+	def_annot->get_may_must_type() == BasicVar::Var_MUST)
+    {
+      OA_ptr<R_VarRef> mention; mention = m_fact->make_body_var_ref(def);
+      in->remove(mention);
+    }
+  }
+  EXPRESSION_FOR_EACH_DEF(annot, def) {
+    Var * def_annot = getProperty(Var, def);
+    if (def_annot->get_may_must_type() == BasicVar::Var_MAY) {
+      OA_ptr<R_VarRef> mention; mention = m_fact->make_body_var_ref(def);
+      in->insert(mention);
+    }
+  }
+  EXPRESSION_FOR_EACH_USE(annot, use) {
+    OA_ptr<R_VarRef> mention; mention = m_fact->make_body_var_ref(use);
+    in->insert(mention);
+  }
+  return in;
+}
+
+// ----- dead store candidates -----
+
+/// Can the procedure's locals be read other than through the uses
+/// we see? Not if it's the whole program (its locals are globals),
+/// has lexical children (closures read their parent's frame), has
+/// default arguments (promises evaluated in its frame at some unknown
+/// time), or calls a library function that inspects its environment.
+bool LivenessDFSolver::proc_is_candidate() {
+  if (m_fi == FuncInfoAnnotationMap::instance()->get_scope_tree_root() ||
+      m_fi->has_children())
+  {
+    return false;
+  }
+  for (SEXP arg = m_fi->get_args(); arg != R_NilValue; arg = CDR(arg)) {
+    if (CAR(arg) != R_MissingArg && !is_const(CAR(arg))) {
+      return false;
+    }
+  }
+  PROC_FOR_EACH_CALL_SITE(m_fi, csi) {
+    SEXP lhs = call_lhs(CAR(*csi));
+    if (is_var(lhs) && is_environment_library(lhs)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/// A candidate is a simple local assignment whose right side can be
+/// skipped without changing anything but the stored value. That is
+/// only a constant, unless the program is assumed correct: reading a
+/// variable may fail if it is unbound, and a subscript may fail or
+/// dispatch on a class. Uses of formals are excluded so that a
+/// promise is still forced (and its errors or side effects still
+/// happen) where the program says.
+bool LivenessDFSolver::is_candidate(SEXP cell) {
+  SEXP use;
+  SEXP e = CAR(cell);
+  if (!is_simple_assign(e) || !is_local_assign(e)) {
+    return false;
+  }
+  SEXP rhs = CAR(assign_rhs_c(e));
+  if (!is_const(rhs) &&
+      !(Settings::instance()->get_assume_correct_program() &&
+	ExpressionSideEffectAnnotationMap::instance()->is_trivial(rhs)))
+  {
+    return false;
+  }
+  ExpressionInfo * annot = getProperty(ExpressionInfo, cell);
+  EXPRESSION_FOR_EACH_USE(annot, use) {
+    SEXP name = getProperty(Var, use)->get_name();
+    for (SEXP arg = m_fi->get_args(); arg != R_NilValue; arg = CDR(arg)) {
+      if (TAG(arg) == name) return false;
+    }
+  }
+  return true;
+}
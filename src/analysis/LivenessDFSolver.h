@@ -0,0 +1,94 @@
+// -*- Mode: C++ -*-
+//
+// Copyright (c) 2009 Rice University
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation; either version 2 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+
+// File: LivenessDFSolver.h
+//
+// Live variable analysis, a backward CFG data flow problem over the
+// names of a procedure, used to find dead stores. A name is live at
+// a point if some path from there uses it before a must-def. A
+// statement `x <- e' is a dead store if x is not live after it and
+// evaluating e has no effect besides producing a value.
+//
+// Author: John Garvin (garvin@cs.rice.edu)
+
+#ifndef LIVENESS_DF_SOLVER_H
+#define LIVENESS_DF_SOLVER_H
+
+#include <set>
+
+#include <OpenAnalysis/Utils/OA_ptr.hpp>
+#include <OpenAnalysis/DataFlow/CFGDFProblem.hpp>
+#include <OpenAnalysis/DataFlow/CFGDFSolver.hpp>
+#include <OpenAnalysis/DataFlow/DataFlowSet.hpp>
+
+#include <include/R/R_RInternals.h>
+
+#include <analysis/VarRefFactory.h>
+
+class OA::CFG::CFGInterface;
+class R_IRInterface;
+class DefaultDFSet;
+namespace RAnnot { class FuncInfo; }
+
+class LivenessDFSolver : private OA::DataFlow::CFGDFProblem {
+public:
+  explicit LivenessDFSolver(OA::OA_ptr<R_IRInterface> _rir);
+  ~LivenessDFSolver();
+
+  /// returns the cells of the dead store statements of the procedure
+  OA::OA_ptr<std::set<SEXP> > perform_analysis(RAnnot::FuncInfo * fi);
+  void dump_node_maps();
+  void dump_node_maps(std::ostream &os);
+
+  // ----- callbacks for CFGDFProblem: initialization, meet, transfer -----
+private:
+  OA::OA_ptr<OA::DataFlow::DataFlowSet> initializeTop();
+  OA::OA_ptr<OA::DataFlow::DataFlowSet> initializeBottom();
+
+  OA::OA_ptr<OA::DataFlow::DataFlowSet> initializeNodeIN(OA::OA_ptr<OA::CFG::NodeInterface> n);
+  OA::OA_ptr<OA::DataFlow::DataFlowSet> initializeNodeOUT(OA::OA_ptr<OA::CFG::NodeInterface> n);
+
+  // CFGDFProblem says: OK to modify set1 and return it as result, because solver
+  // only passes a tempSet in as set1
+  OA::OA_ptr<OA::DataFlow::DataFlowSet>
+  meet (OA::OA_ptr<OA::DataFlow::DataFlowSet> set1, OA::OA_ptr<OA::DataFlow::DataFlowSet> set2);
+
+  // CFGDFProblem says: OK to modify in set and return it again as result because
+  // solver clones the BB in sets
+  OA::OA_ptr<OA::DataFlow::DataFlowSet>
+  transfer(OA::OA_ptr<OA::DataFlow::DataFlowSet> in, OA::StmtHandle stmt);
+
+private:
+  bool proc_is_candidate();
+  bool is_candidate(SEXP cell);
+
+private:
+  OA::OA_ptr<R_IRInterface> m_ir;
+  OA::OA_ptr<OA::CFG::CFGInterface> m_cfg;
+  RAnnot::FuncInfo * m_fi;
+  OA::OA_ptr<DefaultDFSet> m_top;
+  OA::OA_ptr<OA::DataFlow::CFGDFSolver> m_solver;
+  VarRefFactory * m_fact;
+
+  // candidate stores that were reached by the solver, and those
+  // among them that were ever found live
+  std::set<SEXP> m_candidates;
+  std::set<SEXP> m_live_stores;
+};
+
+#endif // LIVENESS_DF_SOLVER_H
@@ -0,0 +1,240 @@
+// -*- Mode: C++ -*-
+//
+// Copyright (c) 2009 Rice University
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation; either version 2 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA 
+
+// File: LoopSubscripts.cc
+//
+// Range analysis for the index of a for loop over a colon range.
+//
+// Author: John Garvin (garvin@cs.rice.edu)
+
+#include <math.h>
+#include <assert.h>
+
+#include <analysis/AnalysisResults.h>
+#include <analysis/FuncInfo.h>
+#include <analysis/FuncInfoAnnotationMap.h>
+#include <analysis/ScopeAnnotationMap.h>
+#include <analysis/Utils.h>
+#include <analysis/VarBinding.h>
+
+#include "LoopSubscripts.h"
+
+using namespace RAnnot;
+
+static bool may_assign(SEXP e, SEXP name);
+static bool calls_environment_library(SEXP e);
+static bool is_inline_call(SEXP e);
+static bool index_offset(SEXP e, SEXP iv, int * offset);
+static void collect(SEXP e, SEXP iv, SEXP body, LoopSubscriptList & out);
+static bool only_read(SEXP e, SEXP iv);
+
+void find_loop_subscripts(SEXP e, LoopSubscriptList & out) {
+  assert(is_for(e) && is_for_colon(e));
+  SEXP iv = CAR(for_iv_c(e));
+  SEXP body = CAR(for_body_c(e));
+
+  // At the top level, locals are globals that any call may assign;
+  // in a procedure with closures, a closure may assign them with <<-.
+  FuncInfo * fi = dynamic_cast<FuncInfo *>(ScopeAnnotationMap::instance()->get(e));
+  if (fi == 0 ||
+      fi == FuncInfoAnnotationMap::instance()->get_scope_tree_root() ||
+      fi->has_children())
+  {
+    return;
+  }
+  if (may_assign(body, iv) || calls_environment_library(body)) {
+    return;
+  }
+  collect(body, iv, body, out);
+}
+
+bool loop_value_is_reusable(SEXP e) {
+  assert(is_for(e));
+  SEXP iv = CAR(for_iv_c(e));
+  SEXP body = CAR(for_body_c(e));
+
+  // At the top level any call may read the index as a global; a
+  // closure may read it from its enclosing frame and keep it.
+  FuncInfo * fi = dynamic_cast<FuncInfo *>(ScopeAnnotationMap::instance()->get(e));
+  if (fi == 0 ||
+      fi == FuncInfoAnnotationMap::instance()->get_scope_tree_root() ||
+      fi->has_children())
+  {
+    return false;
+  }
+  return (!may_assign(body, iv) && !calls_environment_library(body) &&
+	  only_read(body, iv));
+}
+
+/// Whether e may assign name, either directly or by a replacement
+/// like x[j] <- y or names(x) <- y, or by using it as a loop index.
+static bool may_assign(SEXP e, SEXP name) {
+  if (!is_cons(e)) {
+    return false;
+  }
+  if (is_call(e) && is_assign(e)) {
+    SEXP lhs = CAR(assign_lhs_c(e));
+    while (is_call(lhs) && CDR(lhs) != R_NilValue) {
+      lhs = CADR(lhs);
+    }
+    if (is_string(lhs) && Rf_length(lhs) == 1) {
+      lhs = Rf_install(CHAR(STRING_ELT(lhs, 0)));
+    }
+    if (lhs == name) return true;
+  }
+  if (is_call(e) && is_for(e) && CAR(for_iv_c(e)) == name) {
+    return true;
+  }
+  for (SEXP x = e; x != R_NilValue; x = CDR(x)) {
+    if (may_assign(CAR(x), name)) return true;
+  }
+  return false;
+}
+
+static bool calls_environment_library(SEXP e) {
+  if (!is_cons(e)) {
+    return false;
+  }
+  if (is_call(e) && is_var(call_lhs(e)) && is_environment_library(call_lhs(e))) {
+    return true;
+  }
+  for (SEXP x = e; x != R_NilValue; x = CDR(x)) {
+    if (calls_environment_library(CAR(x))) return true;
+  }
+  return false;
+}
+
+/// Whether the arguments of call e are compiled in line with the
+/// call: e calls a builtin or special that is not redefined. Arguments
+/// to closures become promises, which may be forced anywhere.
+static bool is_inline_call(SEXP e) {
+  SEXP lhs = call_lhs(e);
+  return (is_var(lhs) && !is_fundef(e) && is_library(lhs) &&
+	  (is_library_builtin(lhs) || is_library_special(lhs)) &&
+	  getProperty(VarBinding, e)->is_internal());
+}
+
+/// If e is iv, iv + c, c + iv, or iv - c for an integral constant c,
+/// set offset to c and return true.
+static bool index_offset(SEXP e, SEXP iv, int * offset) {
+  if (e == iv) {
+    *offset = 0;
+    return true;
+  }
+  if (is_paren_exp(e)) {
+    return index_offset(CAR(paren_body_c(e)), iv, offset);
+  }
+  if (!is_call(e) || Rf_length(e) != 3 || !is_var(call_lhs(e)) ||
+      !(call_lhs(e) == Rf_install("+") || call_lhs(e) == Rf_install("-")) ||
+      !getProperty(VarBinding, e)->is_internal())
+  {
+    return false;
+  }
+  bool plus = (call_lhs(e) == Rf_install("+"));
+  SEXP x = CAR(call_args(e));
+  SEXP y = CADR(call_args(e));
+  if (plus && y == iv) {
+    SEXP tmp = x; x = y; y = tmp;
+  }
+  if (x != iv ||
+      !(TYPEOF(y) == INTSXP || TYPEOF(y) == REALSXP) ||
+      Rf_length(y) != 1 || ATTRIB(y) != R_NilValue)
+  {
+    return false;
+  }
+  double c = Rf_asReal(y);
+  if (ISNAN(c) || c != floor(c) || fabs(c) > 1e6) {
+    return false;
+  }
+  *offset = (plus ? (int)c : -(int)c);
+  return true;
+}
+
+static void collect(SEXP e, SEXP iv, SEXP body, LoopSubscriptList & out) {
+  if (!is_call(e)) {
+    return;
+  }
+  int offset;
+  if (is_assign(e) && is_local_assign(e) && is_simple_subscript(CAR(assign_lhs_c(e)))) {
+    SEXP lhs = CAR(assign_lhs_c(e));
+    if (index_offset(CAR(subscript_first_sub_c(lhs)), iv, &offset)) {
+      LoopSubscript ls = { lhs, CAR(subscript_lhs_c(lhs)), offset, true, false };
+      out.push_back(ls);
+    }
+    collect(CAR(subscript_first_sub_c(lhs)), iv, body, out);
+    collect(CAR(assign_rhs_c(e)), iv, body, out);
+    return;
+  }
+  if (is_simple_subscript(e) && index_offset(CAR(subscript_first_sub_c(e)), iv, &offset)) {
+    SEXP array = CAR(subscript_lhs_c(e));
+    LoopSubscript ls = { e, array, offset, false, !may_assign(body, array) };
+    out.push_back(ls);
+  }
+  if (is_inline_call(e)) {
+    for (SEXP arg = call_args(e); arg != R_NilValue; arg = CDR(arg)) {
+      collect(CAR(arg), iv, body, out);
+    }
+  }
+}
+
+/// Whether every mention of iv in e is an operand of a builtin that
+/// only reads its value or the index of a subscript. Binary + reads
+/// its operands, but unary +x is x itself.
+static bool only_read(SEXP e, SEXP iv) {
+  static const char * const readers[] = {
+    "-", "*", "/", "^", "%%", "%/%",
+    "==", "!=", "<", ">", "<=", ">=", "!", "&", "|", "&&", "||",
+    "abs", "sqrt", "exp", "log", "floor", "ceiling", "is.na", "length",
+    0 };
+  if (e == iv) {
+    return false;
+  }
+  if (!is_call(e)) {
+    return true;
+  }
+  if (is_paren_exp(e) && CAR(paren_body_c(e)) == iv) {
+    return false;  // (iv) is iv itself
+  }
+  SEXP first = call_args(e);
+  bool reads_args = false;
+  if (is_var(call_lhs(e)) && is_inline_call(e)) {
+    for (const char * const * r = readers; *r != 0; r++) {
+      if (call_lhs(e) == Rf_install(*r)) reads_args = true;
+    }
+    if (call_lhs(e) == Rf_install("+") && Rf_length(call_args(e)) == 2) {
+      reads_args = true;
+    }
+  }
+  if (!reads_args && is_subscript(e)) {
+    // the index is only read; the array is not
+    if (!only_read(CAR(subscript_lhs_c(e)), iv)) return false;
+    first = CDR(subscript_lhs_c(e));
+    reads_args = true;
+  }
+  if (!only_read(call_lhs(e), iv)) {
+    return false;
+  }
+  for (SEXP arg = first; arg != R_NilValue; arg = CDR(arg)) {
+    if (CAR(arg) == iv) {
+      if (!reads_args) return false;
+    } else if (!only_read(CAR(arg), iv)) {
+      return false;
+    }
+  }
+  return true;
+}
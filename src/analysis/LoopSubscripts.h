@@ -0,0 +1,66 @@
+// -*- Mode: C++ -*-
+//
+// Copyright (c) 2009 Rice University
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation; either version 2 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA 
+
+// File: LoopSubscripts.h
+//
+// Range analysis for the index of a for loop over a colon range. In
+// `for (i in a:b)' the index takes the values from a to b in steps of
+// one, so a subscript x[i + c] stays within [min(a,b) + c, max(a,b) + c]
+// for the whole loop. If the body never assigns i, that range can be
+// checked against length(x) once before the loop instead of at every
+// access; this module finds the subscripts for which that is sound.
+// It also decides when the value of a loop index can be overwritten
+// in place from one iteration to the next.
+//
+// Author: John Garvin (garvin@cs.rice.edu)
+
+#ifndef LOOP_SUBSCRIPTS_H
+#define LOOP_SUBSCRIPTS_H
+
+#include <vector>
+
+#include <include/R/R_RInternals.h>
+
+/// A single subscript x[i + offset] of the index i of a loop.
+struct LoopSubscript {
+  SEXP expr;       // the subscript expression x[i + offset]
+  SEXP array;      // x
+  int offset;
+  bool is_write;   // appears as x[i + offset] <- y
+  bool hoistable;  // x is not assigned in the loop body
+};
+
+typedef std::vector<LoopSubscript> LoopSubscriptList;
+
+/// Find the subscripts of the index of for loop e, which must have a
+/// colon range, that code generation may turn into direct accesses.
+/// Only subscripts evaluated in line with the loop body are found;
+/// those inside promises or function definitions may run after the
+/// loop is gone. Nothing is found if the index or the procedure's
+/// locals may be changed behind our back.
+void find_loop_subscripts(SEXP e, LoopSubscriptList & out);
+
+/// Whether the body of for loop e only reads the value of the index,
+/// so that one vector can hold it for every iteration instead of a
+/// fresh one each time. The index may appear only as an operand of
+/// arithmetic, comparison and logical builtins and as a subscript;
+/// it must not be assigned, passed to a closure (whose promise could
+/// be forced later), or visible to closures or environment functions.
+bool loop_value_is_reusable(SEXP e);
+
+#endif
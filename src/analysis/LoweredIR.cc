@@ -0,0 +1,243 @@
+// -*- Mode: C++ -*-
+//
+// Copyright (c) 2009 Rice University
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation; either version 2 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+
+// File: LoweredIR.cc
+//
+// Flat lowering of the statements and mentions R_IRInterface hands to
+// OpenAnalysis.
+//
+// Author: John Garvin (garvin@cs.rice.edu)
+
+#include <algorithm>
+
+#include <analysis/AnalysisResults.h>
+#include <analysis/ExpressionInfo.h>
+#include <analysis/IRInterface.h>
+#include <analysis/Utils.h>
+
+#include <support/RccError.h>
+
+#include "LoweredIR.h"
+
+using namespace OA;
+using namespace RAnnot;
+
+// order mention cells by name, as R_BodyVarRef orders itself
+static bool name_less(SEXP a, SEXP b) {
+  return CAR(a) < CAR(b);
+}
+
+static bool name_equal(SEXP a, SEXP b) {
+  return CAR(a) == CAR(b);
+}
+
+const LoweredIR::Range & LoweredIR::region(SEXP cell) {
+  std::map<SEXP, Range>::const_iterator it = m_regions.find(cell);
+  if (it != m_regions.end()) {
+    return it->second;
+  }
+  unsigned int begin = static_cast<unsigned int>(m_cells.size());
+  lower_region(cell);
+  return m_regions[cell] = end_range(begin);
+}
+
+const LoweredIR::Range & LoweredIR::region_list(SEXP list) {
+  std::map<SEXP, Range>::const_iterator it = m_lists.find(list);
+  if (it != m_lists.end()) {
+    return it->second;
+  }
+  unsigned int begin = static_cast<unsigned int>(m_cells.size());
+  append_list(list);
+  return m_lists[list] = end_range(begin);
+}
+
+const LoweredIR::Range & LoweredIR::descendants(SEXP cell) {
+  std::map<SEXP, Range>::const_iterator it = m_descendants.find(cell);
+  if (it != m_descendants.end()) {
+    return it->second;
+  }
+  unsigned int begin = static_cast<unsigned int>(m_cells.size());
+  lower_descendants(cell);
+  return m_descendants[cell] = end_range(begin);
+}
+
+const LoweredIR::StmtRecord & LoweredIR::stmt(SEXP cell) {
+  std::map<SEXP, StmtRecord>::const_iterator it = m_stmts.find(cell);
+  if (it != m_stmts.end()) {
+    return it->second;
+  }
+  ExpressionInfo * ei = getProperty(ExpressionInfo, cell);
+  assert(ei != 0);
+  StmtRecord rec;
+  SEXP mention;
+
+  unsigned int begin = static_cast<unsigned int>(m_cells.size());
+  EXPRESSION_FOR_EACH_USE(ei, mention) {
+    m_cells.push_back(mention);
+  }
+  Range uses = end_range(begin);
+  EXPRESSION_FOR_EACH_DEF(ei, mention) {
+    m_cells.push_back(mention);
+  }
+  rec.mentions = end_range(begin);
+  Range defs = {uses.end, rec.mentions.end};
+
+  rec.uses = append_unique_names(uses);
+  rec.defs = append_unique_names(defs);
+
+  // program call sites only; calls to library functions are not
+  // call graph edges
+  begin = static_cast<unsigned int>(m_cells.size());
+  SEXP cs_c;
+  EXPRESSION_FOR_EACH_CALL_SITE(ei, cs_c) {
+    SEXP lhs = call_lhs(CAR(cs_c));
+    if (is_var(lhs) && !is_library(lhs)) {
+      m_cells.push_back(CAR(cs_c));
+    }
+  }
+  rec.program_calls = end_range(begin);
+
+  return m_stmts[cell] = rec;
+}
+
+/// Append the mentions in the range with one mention per name: the
+/// first one in the range, ordered by the name's address.
+LoweredIR::Range LoweredIR::append_unique_names(Range mentions) {
+  std::vector<SEXP> sorted(m_cells.begin() + mentions.begin,
+			   m_cells.begin() + mentions.end);
+  std::stable_sort(sorted.begin(), sorted.end(), name_less);
+  sorted.erase(std::unique(sorted.begin(), sorted.end(), name_equal),
+	       sorted.end());
+  unsigned int begin = static_cast<unsigned int>(m_cells.size());
+  m_cells.insert(m_cells.end(), sorted.begin(), sorted.end());
+  return end_range(begin);
+}
+
+/// Statements of a region, as R_RegionStmtIterator used to list them.
+/// The given cell's CAR is the actual expression.
+void LoweredIR::lower_region(SEXP cell) {
+  if (cell == R_NilValue) {
+    return;
+  }
+  assert(is_cons(cell));
+  SEXP exp = CAR(cell);
+  switch (getSexpCfgType(exp)) {
+  case CFG::SIMPLE:
+    if (exp != R_NilValue) {
+      m_cells.push_back(cell);
+    }
+    break;
+  case CFG::LOOP:
+  case CFG::STRUCT_TWOWAY_CONDITIONAL:
+  case CFG::RETURN:
+  case CFG::BREAK:
+  case CFG::LOOP_CONTINUE:
+    m_cells.push_back(cell);
+    break;
+  case CFG::COMPOUND:
+    if (is_curly_list(exp)) {
+      append_list(curly_body(exp));
+    } else {
+      // a function definition or parenthesized expression; its body
+      // is either a list of statements or a single one
+      SEXP body_c;
+      if (is_fundef(exp)) {
+	body_c = fundef_body_c(exp);
+      } else {
+	body_c = paren_body_c(exp);
+      }
+      if (TYPEOF(CAR(body_c)) == NILSXP || TYPEOF(CAR(body_c)) == LISTSXP) {
+	append_list(CAR(body_c));
+      } else {
+	m_cells.push_back(body_c);
+      }
+    }
+    break;
+  default:
+    rcc_error("LoweredIR::lower_region: unrecognized CFG statement type");
+    break;
+  }
+}
+
+void LoweredIR::lower_descendants(SEXP exp_c) {
+  assert(exp_c != 0);
+  if (exp_c == R_NilValue) {
+    return;
+  }
+  assert(is_cons(exp_c));
+  SEXP exp = CAR(exp_c);
+  switch(getSexpCfgType(exp)) {
+  case CFG::COMPOUND:
+    if (is_curly_list(exp)) {
+      for (SEXP e = curly_body(exp); e != R_NilValue; e = CDR(e)) {
+	lower_descendants(e);
+      }
+    } else if (is_paren_exp(exp)) {
+      lower_descendants(paren_body_c(exp));
+    }
+    // nested fundefs are NOT counted as part of the parent
+    break;
+  case CFG::LOOP:
+    if (is_for(exp)) {
+      lower_descendants(for_range_c(exp));
+      lower_descendants(for_body_c(exp));
+    } else if (is_while(exp)) {
+      lower_descendants(while_cond_c(exp));
+      lower_descendants(while_body_c(exp));
+    } else if (is_repeat(exp)) {
+      lower_descendants(repeat_body_c(exp));
+    }
+    break;
+  case CFG::STRUCT_TWOWAY_CONDITIONAL:  // a.k.a. "if"
+    lower_descendants(if_truebody_c(exp));
+    lower_descendants(if_falsebody_c(exp));
+    break;
+  default:  // including CFG::SIMPLE
+    if (exp != R_NilValue) {
+      m_cells.push_back(exp_c);
+    }
+  }
+}
+
+void LoweredIR::append_list(SEXP list) {
+  for (SEXP e = list; e != R_NilValue; e = CDR(e)) {
+    m_cells.push_back(e);
+  }
+}
+
+LoweredIR::Range LoweredIR::end_range(unsigned int begin) const {
+  Range r = {begin, static_cast<unsigned int>(m_cells.size())};
+  return r;
+}
+
+LoweredIR * LoweredIR::instance() {
+  if (s_instance == 0) {
+    s_instance = new LoweredIR();
+  }
+  return s_instance;
+}
+
+void LoweredIR::reset() {
+  delete s_instance;
+  s_instance = 0;
+}
+
+LoweredIR::LoweredIR() {
+}
+
+LoweredIR * LoweredIR::s_instance = 0;
@@ -0,0 +1,96 @@
+// -*- Mode: C++ -*-
+//
+// Copyright (c) 2009 Rice University
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation; either version 2 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+
+// File: LoweredIR.h
+//
+// Flat lowering of the statements and mentions R_IRInterface hands to
+// OpenAnalysis. Every region, procedure and statement is lowered the
+// first time it is queried into ranges of one shared vector of cells;
+// later queries of the same thing only return the range. The
+// iterators in IRInterface.h are views of these ranges.
+//
+// Author: John Garvin (garvin@cs.rice.edu)
+
+#ifndef LOWERED_IR_H
+#define LOWERED_IR_H
+
+#include <map>
+#include <vector>
+
+#include <include/R/R_RInternals.h>
+
+class LoweredIR {
+public:
+  /// Half-open range of indices into cells()
+  struct Range {
+    unsigned int begin;
+    unsigned int end;
+  };
+
+  /// Everything the IR interface is asked about one statement. The
+  /// mentions are the uses then the defs in ExpressionInfo order;
+  /// uses and defs hold one mention per name, in the order an
+  /// R_VarRefSet would give them.
+  struct StmtRecord {
+    Range mentions;
+    Range uses;
+    Range defs;
+    Range program_calls;
+  };
+
+  /// Statements of the region rooted at the given cell, not
+  /// descending into compound statements
+  const Range & region(SEXP cell);
+
+  /// Cells of a list of statements, e.g. the body of a curly
+  const Range & region_list(SEXP list);
+
+  /// Every simple statement under the given cell, descending into
+  /// compound statements but not into nested function definitions
+  const Range & descendants(SEXP cell);
+
+  /// Record for the statement in the given cell
+  const StmtRecord & stmt(SEXP cell);
+
+  /// The vector all ranges index into. Lowering only appends to it,
+  /// so ranges stay valid as it grows.
+  const std::vector<SEXP> & cells() const { return m_cells; }
+
+  static LoweredIR * instance();
+  /// Forget the instance, so the next compilation starts afresh
+  static void reset();
+
+private:
+  // singleton pattern
+  explicit LoweredIR();
+  static LoweredIR * s_instance;
+
+  void lower_region(SEXP cell);
+  void lower_descendants(SEXP cell);
+  void append_list(SEXP list);
+  Range append_unique_names(Range mentions);
+  Range end_range(unsigned int begin) const;
+
+  std::vector<SEXP> m_cells;
+  std::map<SEXP, Range> m_regions;
+  std::map<SEXP, Range> m_lists;
+  std::map<SEXP, Range> m_descendants;
+  std::map<SEXP, StmtRecord> m_stmts;
+};
+
+#endif
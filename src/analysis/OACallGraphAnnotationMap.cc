@@ -25,10 +25,6 @@
 #include <OpenAnalysis/CallGraph/ManagerCallGraph.hpp>
 #include <OpenAnalysis/Alias/Interface.hpp>
 #include <OpenAnalysis/Alias/ManagerFIAliasAliasTag.hpp>
-#include <OpenAnalysis/DataFlow/CallGraphDFSolver.hpp>
-#include <OpenAnalysis/DataFlow/DGraphSolverDFP.hpp>
-#include <OpenAnalysis/DataFlow/ManagerParamBindings.hpp>
-#include <OpenAnalysis/SideEffect/ManagerInterSideEffectStandard.hpp>
 #include <OpenAnalysis/Utils/OutputBuilderDOT.hpp>
 
 #include <analysis/AnalysisResults.h>
@@ -36,6 +32,7 @@
 #include <analysis/HandleInterface.h>
 #include <analysis/IRInterface.h>
 #include <analysis/OACallGraphAnnotation.h>
+#include <analysis/SideEffectSummaryAnnotationMap.h>
 
 #include <support/Debug.h>
 #include <support/RccError.h>
@@ -83,7 +80,7 @@ PropertyHndlT OACallGraphAnnotationMap::handle() {
   
 void OACallGraphAnnotationMap::create() {
   s_instance = new OACallGraphAnnotationMap();
-  analysisResults.add(s_handle, s_instance);
+  analysisResults.add_instance(s_handle, s_instance);
 }
   
 OACallGraphAnnotationMap * OACallGraphAnnotationMap::s_instance = 0;
@@ -142,20 +139,9 @@ void OACallGraphAnnotationMap::compute() {
     m_call_graph->output(*interface);
   }
 
-  // now perform call graph data flow analysis (specifically, interprocedural side effect).
-  // We need (3) param bindings and (4) intraprocedural side effect information
-  SideEffect::ManagerInterSideEffectStandard solver(interface);
-
-  // (3) param bindings
-  DataFlow::ManagerParamBindings pb_man(interface);
-  OA_ptr<DataFlow::ParamBindings> param_bindings = pb_man.performAnalysis(m_call_graph);
-
-  // (4) intra side effect information
-  OA_ptr<SideEffect::ManagerSideEffectStandard> intra_man;
-  intra_man = new SideEffect::ManagerSideEffectStandard(interface);
-
-  // compute side effect information
-  m_side_effect = solver.performAnalysis(m_call_graph, param_bindings, m_alias, intra_man, DataFlow::ITERATIVE);
+  // Interprocedural side effects are not solved here for the whole
+  // program; SideEffectSummaryAnnotationMap summarizes procedures on
+  // demand using this call graph.
 }
 
 // ----- debugging -----
@@ -165,7 +151,7 @@ void OACallGraphAnnotationMap::dump(std::ostream & os) {
 
   OA_ptr<R_IRInterface> interface; interface = R_Analyst::instance()->get_interface();
   m_call_graph->output(*interface);
-  m_side_effect->dump(cout, interface);
+  SideEffectSummaryAnnotationMap::instance()->serialize(os);
 }
 
 void OACallGraphAnnotationMap::dumpdot(std::ostream & os) {
@@ -33,12 +33,6 @@
 #include <analysis/DefaultAnnotationMap.h>
 #include <analysis/PropertyHndl.h>
 
-namespace OA {
-  namespace SideEffect {
-    class InterSideEffectStandard;
-  }
-}
-
 namespace RAnnot {
 
 class OACallGraphAnnotationMap : public DefaultAnnotationMap
@@ -87,7 +81,6 @@ private:
 
 private:
   OA::OA_ptr<OA::CallGraph::CallGraphInterface> m_call_graph;
-  OA::OA_ptr<OA::SideEffect::InterSideEffectStandard> m_side_effect; // side effect information
   OA::OA_ptr<OA::Alias::InterAliasInterface> m_alias;                // alias information
 };
 
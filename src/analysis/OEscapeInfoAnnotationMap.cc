@@ -238,7 +238,7 @@ PropertyHndlT OEscapeInfoAnnotationMap::handle() {
 // for getProperty
 void OEscapeInfoAnnotationMap::create() {
   s_instance = new OEscapeInfoAnnotationMap();
-  analysisResults.add(s_handle, s_instance);
+  analysisResults.add_instance(s_handle, s_instance);
 }
 
 OEscapeInfoAnnotationMap * OEscapeInfoAnnotationMap::s_instance = 0;
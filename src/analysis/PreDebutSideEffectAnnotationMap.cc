@@ -79,7 +79,7 @@ PropertyHndlT PreDebutSideEffectAnnotationMap::handle() {
 
 void PreDebutSideEffectAnnotationMap::create() {
   s_instance = new PreDebutSideEffectAnnotationMap();
-  analysisResults.add(s_handle, s_instance);
+  analysisResults.add_instance(s_handle, s_instance);
 }
 
 PreDebutSideEffectAnnotationMap * PreDebutSideEffectAnnotationMap::s_instance = 0;
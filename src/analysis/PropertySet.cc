@@ -55,6 +55,23 @@ PropertySet::~PropertySet()
     delete it->second;
   }
   this->clear();
+  for (unsigned int i = 0; i < m_instances.size(); i++) {
+    delete m_instances[i];
+  }
+}
+
+
+void PropertySet::reset()
+{
+  for (iterator it = this->begin(); it != this->end(); ++it) {
+    delete it->second;
+  }
+  this->clear();
+  for (unsigned int i = 0; i < m_instances.size(); i++) {
+    m_instances[i]->clear();
+    delete m_instances[i];
+  }
+  m_instances.clear();
 }
 
 
@@ -29,6 +29,7 @@
 
 #include <iostream>
 #include <map>
+#include <vector>
 
 //**************************** R Include Files ******************************
 
@@ -79,6 +80,19 @@ public:
   /// AnnotationMap can be looked up.
   void add(PropertyHndlT propertyName, RAnnot::AnnotationMap * amap);
 
+  /// Like add, for an AnnotationMap that is a singleton: also
+  /// remember the singleton's instance pointer, so that reset can
+  /// clear it and the next use creates a fresh map.
+  template <class T>
+  void add_instance(PropertyHndlT propertyName, T *& instance) {
+    add(propertyName, instance);
+    m_instances.push_back(new InstanceRef<T>(instance));
+  }
+
+  /// Delete every AnnotationMap and clear the instance pointers of
+  /// the singletons, as if no analysis had run.
+  void reset();
+
   // -------------------------------------------------------
   // cloning (proscribe by hiding copy constructor and operator=)
   // -------------------------------------------------------
@@ -99,6 +113,22 @@ private:
   PropertySet & operator=(const PropertySet & x) { return *this; }
 
 private:
+  class InstanceRefBase {
+  public:
+    virtual ~InstanceRefBase() {}
+    virtual void clear() = 0;
+  };
+
+  template <class T>
+  class InstanceRef : public InstanceRefBase {
+  public:
+    explicit InstanceRef(T *& instance) : m_instance(instance) {}
+    void clear() { m_instance = 0; }
+  private:
+    T *& m_instance;
+  };
+
+  std::vector<InstanceRefBase *> m_instances;
 };
 
 
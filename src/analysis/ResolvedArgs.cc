@@ -23,6 +23,7 @@
 #include "ResolvedArgs.h"
 
 #include <support/RccError.h>
+#include <support/StringUtils.h>
 
 #include <analysis/ResolvedArgsAnnotationMap.h>
 #include <analysis/Utils.h>
@@ -76,10 +77,10 @@ void ResolvedArgs::resolve() {
       for (b = m_supplied; b != R_NilValue; b = CDR(b)) {
 	if (TAG(b) != R_NilValue && Rf_pmatch(TAG(f), TAG(b), TRUE)) {
 	  if (ARGUSED(f) == 2)
-	    Rf_error(_("formal argument \"%s\" matched by multiple actual arguments"),
-		     var_name(TAG(f)).c_str());
+	    rcc_error("formal argument \"" + var_name(TAG(f)) +
+		      "\" matched by multiple actual arguments");
 	  if (ARGUSED(b) == 2)
-	    Rf_error(_("argument %d matches multiple formal arguments"), j);
+	    rcc_error("argument " + i_to_s(j) + " matches multiple formal arguments");
 	  m_resolved_args.at(i).cell = b;
 	  m_resolved_args.at(i).source = RESOLVED_TAG_EXACT;
 	  if(CAR(b) != R_MissingArg)
@@ -117,10 +118,10 @@ void ResolvedArgs::resolve() {
 	  if (ARGUSED(b) != 2 && TAG(b) != R_NilValue &&
 	      Rf_pmatch(TAG(f), TAG(b), seendots)) {
 	    if (ARGUSED(b))
-	      Rf_error(_("argument %d matches multiple formal arguments"), j);
+	      rcc_error("argument " + i_to_s(j) + " matches multiple formal arguments");
 	    if (ARGUSED(f) == 1)
-	      Rf_error(_("formal argument \"%s\" matched by multiple actual arguments"),
-		       var_name(TAG(f)).c_str());
+	      rcc_error("formal argument \"" + var_name(TAG(f)) +
+			"\" matched by multiple actual arguments");
 	    it->cell = b;
 	    it->source = RESOLVED_TAG_PARTIAL;
 	    if (CAR(b) != R_MissingArg)
@@ -212,10 +213,8 @@ void ResolvedArgs::resolve() {
     /* Check that all arguments are used */
     for (b = m_supplied; b != R_NilValue; b = CDR(b))
       if (!ARGUSED(b) && CAR(b) != R_MissingArg)
-	Rf_errorcall(R_GlobalContext->call,
-		     _("unused argument(s) (%s ...)"),
-		     /* anything better when b is "untagged" ? : */
-		     TAG(b) != R_NilValue ? var_name(TAG(b)).c_str() : "");
+	rcc_error("unused argument(s) (" +
+		  (TAG(b) != R_NilValue ? var_name(TAG(b)) : std::string("")) + " ...)");
   }
 }
 
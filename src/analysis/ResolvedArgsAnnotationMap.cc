@@ -50,7 +50,7 @@ ResolvedArgsAnnotationMap::ResolvedArgsAnnotationMap() {
 ResolvedArgsAnnotationMap * ResolvedArgsAnnotationMap::instance() {
   if (s_instance == 0) {
     s_instance = new ResolvedArgsAnnotationMap();
-    analysisResults.add(s_handle, s_instance);
+    analysisResults.add_instance(s_handle, s_instance);
   }
   return s_instance;
 }
@@ -58,7 +58,7 @@ ResolvedArgsAnnotationMap * ResolvedArgsAnnotationMap::instance() {
 PropertyHndlT ResolvedArgsAnnotationMap::handle() {
   if (s_instance == 0) {
     s_instance = new ResolvedArgsAnnotationMap();
-    analysisResults.add(s_handle, s_instance);
+    analysisResults.add_instance(s_handle, s_instance);
   }
   return s_handle;
 }
@@ -57,7 +57,7 @@ PropertyHndlT ResolvedCallByValueInfoAnnotationMap::s_handle = "ResolvedCallByVa
 
 void ResolvedCallByValueInfoAnnotationMap::create() {
   s_instance = new ResolvedCallByValueInfoAnnotationMap();
-  analysisResults.add(s_handle, s_instance);
+  analysisResults.add_instance(s_handle, s_instance);
 }
 
 // ----- computation -----
@@ -0,0 +1,244 @@
+// -*- Mode: C++ -*-
+//
+// Copyright (c) 2009 Rice University
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation; either version 2 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+
+// File: SCCPSolver.cc
+//
+// Author: John Garvin (garvin@cs.rice.edu)
+
+#include <iostream>
+
+#include <support/Debug.h>
+
+#include <analysis/ConstantDFSet.h>
+#include <analysis/FuncInfo.h>
+#include <analysis/SSAForm.h>
+#include <analysis/Utils.h>
+
+#include "SCCPSolver.h"
+
+using namespace OA;
+using namespace RAnnot;
+
+static bool debug;
+
+SCCPSolver::SCCPSolver()
+  : m_ssa(0), m_fi(0)
+{
+  RCC_DEBUG("RCC_SCCPSolver", debug);
+}
+
+SCCPSolver::~SCCPSolver() {
+  delete m_ssa;
+}
+
+OA_ptr<SCCPSolver::ConstantMap> SCCPSolver::perform_analysis(FuncInfo * fi) {
+  m_fi = fi;
+  delete m_ssa;
+  m_ssa = new SSAForm(fi);
+  const std::vector<SSAForm::Def> & defs = m_ssa->defs();
+
+  m_value.assign(defs.size(), 0);
+  for (unsigned int d = 0; d < defs.size(); d++) {
+    if (defs[d].kind == SSAForm::ENTRY) {
+      // formals are promises; other names are unbound
+      m_value[d] = ConstantDFSet::nac();
+    }
+  }
+  m_edge_exec.assign(m_ssa->edges().size(), false);
+  m_block_exec.assign(m_ssa->blocks().size(), false);
+  m_edge_work.clear();
+  m_def_work.clear();
+
+  m_block_exec[0] = true;
+  visit_block(0);
+  while (!m_edge_work.empty() || !m_def_work.empty()) {
+    if (!m_edge_work.empty()) {
+      int e = m_edge_work.back();
+      m_edge_work.pop_back();
+      int b = m_ssa->edges()[e].to;
+      if (!m_block_exec[b]) {
+	m_block_exec[b] = true;
+	visit_block(b);
+      } else {
+	// a newly executable edge only affects the phis
+	const std::vector<int> & phis = m_ssa->blocks()[b].phis;
+	for (unsigned int k = 0; k < phis.size(); k++) {
+	  visit_phi(phis[k]);
+	}
+      }
+    } else {
+      int d = m_def_work.back();
+      m_def_work.pop_back();
+      const std::vector<int> & phis = m_ssa->phi_uses(d);
+      for (unsigned int k = 0; k < phis.size(); k++) {
+	if (m_block_exec[defs[phis[k]].block]) visit_phi(phis[k]);
+      }
+      const std::vector<int> & stmts = m_ssa->stmt_uses(d);
+      for (unsigned int k = 0; k < stmts.size(); k++) {
+	int b = m_ssa->stmts()[stmts[k]].block;
+	if (!m_block_exec[b]) continue;
+	visit_stmt(stmts[k]);
+	if (m_ssa->blocks()[b].stmts.back() == stmts[k]) visit_branch(b);
+      }
+    }
+  }
+
+  OA_ptr<ConstantMap> result; result = new ConstantMap();
+  const std::vector<SSAForm::Stmt> & stmts = m_ssa->stmts();
+  for (unsigned int s = 0; s < stmts.size(); s++) {
+    if (m_block_exec[stmts[s].block]) {
+      annotate_stmt(stmts[s].cell, is_flat(stmts[s].cell, m_fi), *result);
+    }
+  }
+
+  if (debug) {
+    std::cout << "SSA form of " << m_fi->get_c_name() << ":" << std::endl;
+    m_ssa->dump(std::cout);
+    for (unsigned int b = 0; b < m_block_exec.size(); b++) {
+      if (!m_block_exec[b]) std::cout << "block " << b << " is not executable" << std::endl;
+    }
+    for (ConstantMap::const_iterator it = result->begin(); it != result->end(); ++it) {
+      std::cout << "folded: ";
+      Rf_PrintValue(CAR(it->first));
+      std::cout << "    to: ";
+      Rf_PrintValue(it->second);
+    }
+  }
+
+  return result;
+}
+
+/// The value of a local name is the value of the def reaching it.
+/// A use of a name not yet known (TOP) folds to nothing for now, and
+/// m_saw_top tells the caller not to conclude NAC.
+SEXP SCCPSolver::lookup_local(SEXP cell) {
+  int d = m_ssa->reaching_def(cell);
+  if (d == SSAForm::NO_DEF) return 0;
+  SEXP value = m_value[d];
+  if (value == 0) {
+    m_saw_top = true;
+    return 0;
+  }
+  return (value == ConstantDFSet::nac() ? 0 : value);
+}
+
+void SCCPSolver::visit_block(int b) {
+  const SSAForm::Block & block = m_ssa->blocks()[b];
+  for (unsigned int k = 0; k < block.phis.size(); k++) {
+    visit_phi(block.phis[k]);
+  }
+  for (unsigned int k = 0; k < block.stmts.size(); k++) {
+    visit_stmt(block.stmts[k]);
+  }
+  visit_branch(b);
+}
+
+/// A phi is the meet of its arguments on executable edges.
+void SCCPSolver::visit_phi(int phi) {
+  const SSAForm::Def & def = m_ssa->defs()[phi];
+  const SSAForm::Block & block = m_ssa->blocks()[def.block];
+  SEXP value = 0;
+  for (unsigned int k = 0; k < def.args.size(); k++) {
+    if (m_edge_exec[block.in_edges[k]] && def.args[k] != SSAForm::NO_DEF) {
+      value = meet(value, m_value[def.args[k]]);
+    }
+  }
+  lower(phi, value);
+}
+
+/// A simple local assignment of a flat statement gets the folded
+/// value of its right side; every other def is NAC.
+void SCCPSolver::visit_stmt(int si) {
+  const SSAForm::Stmt & s = m_ssa->stmts()[si];
+  SEXP e = CAR(s.cell);
+  for (unsigned int k = 0; k < s.defs.size(); k++) {
+    const SSAForm::Def & def = m_ssa->defs()[s.defs[k]];
+    SEXP value = ConstantDFSet::nac();
+    if (def.kind == SSAForm::STMT && is_simple_assign(e) && is_local_assign(e) &&
+	def.mention_c == assign_lhs_c(e) && is_flat(s.cell, m_fi))
+    {
+      m_saw_top = false;
+      value = fold(assign_rhs_c(e), true);
+      if (value == 0) {
+	value = (m_saw_top ? 0 : ConstantDFSet::nac());
+      } else if (!is_foldable_value(value)) {
+	value = ConstantDFSet::nac();
+      }
+    }
+    lower(s.defs[k], value);
+  }
+}
+
+/// Mark the successors of a block executable: only the taken one if
+/// the block ends in an if or while whose condition is constant,
+/// none yet if the condition is TOP, otherwise all of them.
+void SCCPSolver::visit_branch(int b) {
+  const SSAForm::Block & block = m_ssa->blocks()[b];
+  if (!block.stmts.empty()) {
+    SEXP stmt_c = m_ssa->stmts()[block.stmts.back()].cell;
+    SEXP e = CAR(stmt_c);
+    if ((is_if(e) || is_while(e)) && is_flat(stmt_c, m_fi)) {
+      m_saw_top = false;
+      SEXP value = fold(is_if(e) ? if_cond_c(e) : while_cond_c(e), true);
+      if (value == 0 && m_saw_top) {
+	return;
+      }
+      if (value != 0 && is_scalar_value(value) && TYPEOF(value) != STRSXP) {
+	int cond = Rf_asLogical(value);
+	if (cond != NA_LOGICAL) {
+	  OA::CFG::EdgeType taken = (cond ? OA::CFG::TRUE_EDGE : OA::CFG::FALSE_EDGE);
+	  for (unsigned int k = 0; k < block.out_edges.size(); k++) {
+	    int edge = block.out_edges[k];
+	    OA::CFG::EdgeType type = m_ssa->edges()[edge].type;
+	    if (type == taken || (type != OA::CFG::TRUE_EDGE && type != OA::CFG::FALSE_EDGE)) {
+	      mark_edge(edge);
+	    }
+	  }
+	  return;
+	}
+      }
+    }
+  }
+  for (unsigned int k = 0; k < block.out_edges.size(); k++) {
+    mark_edge(block.out_edges[k]);
+  }
+}
+
+/// Values only move down the lattice: TOP, then a constant, then NAC.
+void SCCPSolver::lower(int def, SEXP value) {
+  SEXP lowered = meet(m_value[def], value);
+  if (lowered != m_value[def]) {
+    m_value[def] = lowered;
+    m_def_work.push_back(def);
+  }
+}
+
+void SCCPSolver::mark_edge(int edge) {
+  if (!m_edge_exec[edge]) {
+    m_edge_exec[edge] = true;
+    m_edge_work.push_back(edge);
+  }
+}
+
+/// TOP meet v = v; v meet v = v; otherwise NAC
+SEXP SCCPSolver::meet(SEXP x, SEXP y) {
+  if (x == 0) return y;
+  if (y == 0) return x;
+  if (x == ConstantDFSet::nac() || y == ConstantDFSet::nac()) return ConstantDFSet::nac();
+  return (ConstantDFSet::equal_values(x, y) ? x : ConstantDFSet::nac());
+}
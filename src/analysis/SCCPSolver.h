@@ -0,0 +1,79 @@
+// -*- Mode: C++ -*-
+//
+// Copyright (c) 2009 Rice University
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation; either version 2 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+
+// File: SCCPSolver.h
+//
+// Sparse conditional constant propagation (Wegman and Zadeck) over
+// the SSA form of a procedure. Values flow along def-use chains
+// instead of through every statement, branches whose condition is
+// constant make only one successor executable, and names are assumed
+// constant until shown otherwise, so it finds everything the dense
+// ConstantDFSolver does and more: values that stay constant around a
+// loop, and values merged only from executable paths.
+//
+// Author: John Garvin (garvin@cs.rice.edu)
+
+#ifndef SCCP_SOLVER_H
+#define SCCP_SOLVER_H
+
+#include <vector>
+
+#include <OpenAnalysis/Utils/OA_ptr.hpp>
+
+#include <include/R/R_RInternals.h>
+
+#include <analysis/ConstantFolder.h>
+
+namespace RAnnot { class FuncInfo; }
+class SSAForm;
+
+class SCCPSolver : private ConstantFolder {
+public:
+  typedef ConstantFolder::ConstantMap ConstantMap;
+
+  explicit SCCPSolver();
+  ~SCCPSolver();
+
+  /// Solve, then record the folded values of the statements in
+  /// executable blocks in the same form as ConstantDFSolver.
+  OA::OA_ptr<ConstantMap> perform_analysis(RAnnot::FuncInfo * fi);
+
+private:
+  SEXP lookup_local(SEXP cell);
+
+  void visit_block(int block);
+  void visit_phi(int phi);
+  void visit_stmt(int stmt);
+  void visit_branch(int block);
+  void lower(int def, SEXP value);
+  void mark_edge(int edge);
+
+  static SEXP meet(SEXP x, SEXP y);
+
+private:
+  SSAForm * m_ssa;
+  RAnnot::FuncInfo * m_fi;
+  std::vector<SEXP> m_value;  // for each def: 0 (TOP), a constant, or NAC
+  std::vector<bool> m_edge_exec;
+  std::vector<bool> m_block_exec;
+  std::vector<int> m_edge_work;
+  std::vector<int> m_def_work;
+  bool m_saw_top;  // folding looked up a name whose value is TOP
+};
+
+#endif // SCCP_SOLVER_H
@@ -0,0 +1,396 @@
+// -*- Mode: C++ -*-
+//
+// Copyright (c) 2009 Rice University
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation; either version 2 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+
+// File: SSAForm.cc
+//
+// Dominators are computed with the iterative algorithm of Cooper,
+// Harvey and Kennedy ("A Simple, Fast Dominance Algorithm"), phis are
+// placed at the iterated dominance frontiers of each name's defs, and
+// defs are renamed in a walk of the dominator tree (Cytron et al.).
+//
+// Author: John Garvin (garvin@cs.rice.edu)
+
+#include <set>
+#include <utility>
+
+#include <support/StringUtils.h>
+
+#include <analysis/AnalysisResults.h>
+#include <analysis/ConstantFolder.h>
+#include <analysis/ExpressionInfo.h>
+#include <analysis/FuncInfo.h>
+#include <analysis/HandleInterface.h>
+#include <analysis/PropertySet.h>
+#include <analysis/Utils.h>
+#include <analysis/Var.h>
+
+#include "SSAForm.h"
+
+using namespace OA;
+using namespace RAnnot;
+using namespace HandleInterface;
+
+typedef std::pair<OA_ptr<CFG::NodeInterface>, CFG::EdgeType> Succ;
+
+/// A node in the depth-first search numbering the blocks: the node,
+/// its successors and the index of the next one to visit
+struct DFSFrame {
+  OA_ptr<CFG::NodeInterface> node;
+  std::vector<Succ> succs;
+  unsigned int next;
+};
+
+static void get_succs(OA_ptr<CFG::NodeInterface> node, std::vector<Succ> & succs);
+static bool is_local(SEXP mention_c);
+static bool has_inner_def(SEXP stmt_c);
+
+SSAForm::SSAForm(FuncInfo * fi)
+  : m_fi(fi)
+{
+  number_blocks();
+  collect_stmts();
+  compute_dominators();
+  place_phis();
+  for (unsigned int i = 0; i < m_names.size(); i++) {
+    m_stacks[m_names[i]].push_back(new_def(ENTRY, m_names[i], 0, -1, 0));
+  }
+  rename(0);
+  m_stacks.clear();
+}
+
+int SSAForm::reaching_def(SEXP use_c) const {
+  std::map<SEXP, int>::const_iterator it = m_use_def.find(use_c);
+  return (it == m_use_def.end() ? NO_DEF : it->second);
+}
+
+int SSAForm::stmt_index(SEXP stmt_c) const {
+  std::map<SEXP, int>::const_iterator it = m_stmt_index.find(stmt_c);
+  return (it == m_stmt_index.end() ? -1 : it->second);
+}
+
+/// Number the nodes reachable from the entry in reverse postorder
+/// and record the edges between them.
+void SSAForm::number_blocks() {
+  OA_ptr<CFG::CFGInterface> cfg; cfg = m_fi->get_cfg();
+  std::vector<OA_ptr<CFG::NodeInterface> > postorder;
+  std::set<unsigned int> visited;
+
+  // iterative depth-first search
+  std::vector<DFSFrame> stack(1);
+  stack.back().node = cfg->getEntry();
+  stack.back().next = 0;
+  get_succs(stack.back().node, stack.back().succs);
+  visited.insert(stack.back().node->getId());
+  while (!stack.empty()) {
+    DFSFrame & f = stack.back();
+    if (f.next < f.succs.size()) {
+      OA_ptr<CFG::NodeInterface> succ = f.succs[f.next++].first;
+      if (visited.insert(succ->getId()).second) {
+	DFSFrame g;
+	g.node = succ;
+	g.next = 0;
+	get_succs(succ, g.succs);
+	stack.push_back(g);
+      }
+    } else {
+      postorder.push_back(f.node);
+      stack.pop_back();
+    }
+  }
+
+  std::map<unsigned int, int> index;
+  m_blocks.resize(postorder.size());
+  for (unsigned int i = 0; i < postorder.size(); i++) {
+    int b = postorder.size() - 1 - i;
+    m_blocks[b].node = postorder[i];
+    index[postorder[i]->getId()] = b;
+  }
+  for (unsigned int b = 0; b < m_blocks.size(); b++) {
+    std::vector<Succ> succs;
+    get_succs(m_blocks[b].node, succs);
+    for (unsigned int k = 0; k < succs.size(); k++) {
+      Edge e;
+      e.from = b;
+      e.to = index[succs[k].first->getId()];
+      e.type = succs[k].second;
+      m_blocks[e.from].out_edges.push_back(m_edges.size());
+      m_blocks[e.to].in_edges.push_back(m_edges.size());
+      m_edges.push_back(e);
+    }
+  }
+}
+
+/// Record each statement with its mentions of local names, and the
+/// local names of the procedure.
+void SSAForm::collect_stmts() {
+  std::set<SEXP> seen;
+  PROC_FOR_EACH_MENTION(m_fi, mi) {
+    if (is_local(*mi)) {
+      SEXP name = getProperty(Var, *mi)->get_name();
+      if (seen.insert(name).second) {
+	m_names.push_back(name);
+      }
+    }
+  }
+
+  StmtHandle stmt;
+  SEXP mention;
+  for (unsigned int b = 0; b < m_blocks.size(); b++) {
+    NODE_FOR_EACH_STATEMENT(m_blocks[b].node, stmt) {
+      Stmt s;
+      s.cell = make_sexp(stmt);
+      s.block = b;
+      s.kills = ConstantFolder::kills_locals(s.cell, m_fi);
+      s.unordered = has_inner_def(s.cell);
+      ExpressionInfo * annot = getProperty(ExpressionInfo, s.cell);
+      EXPRESSION_FOR_EACH_USE(annot, mention) {
+	if (is_local(mention)) s.uses.push_back(mention);
+      }
+      EXPRESSION_FOR_EACH_DEF(annot, mention) {
+	if (is_local(mention)) s.def_mentions.push_back(mention);
+      }
+      m_stmt_index[s.cell] = m_stmts.size();
+      m_blocks[b].stmts.push_back(m_stmts.size());
+      m_stmts.push_back(s);
+    }
+  }
+}
+
+void SSAForm::compute_dominators() {
+  const int n = m_blocks.size();
+  m_idom.assign(n, -1);
+  m_idom[0] = 0;
+  bool changed = true;
+  while (changed) {
+    changed = false;
+    for (int b = 1; b < n; b++) {
+      int new_idom = -1;
+      for (unsigned int k = 0; k < m_blocks[b].in_edges.size(); k++) {
+	int p = m_edges[m_blocks[b].in_edges[k]].from;
+	if (m_idom[p] == -1) continue;
+	if (new_idom == -1) {
+	  new_idom = p;
+	} else {
+	  // intersect: walk up from both until they meet
+	  int x = p, y = new_idom;
+	  while (x != y) {
+	    while (x > y) x = m_idom[x];
+	    while (y > x) y = m_idom[y];
+	  }
+	  new_idom = x;
+	}
+      }
+      if (m_idom[b] != new_idom) {
+	m_idom[b] = new_idom;
+	changed = true;
+      }
+    }
+  }
+  m_dom_children.assign(n, std::vector<int>());
+  for (int b = 1; b < n; b++) {
+    m_dom_children[m_idom[b]].push_back(b);
+  }
+}
+
+/// Put a phi for each name at the iterated dominance frontier of the
+/// blocks defining it. The entry block defines every name.
+void SSAForm::place_phis() {
+  const int n = m_blocks.size();
+  std::vector<std::set<int> > frontier(n);
+  for (int b = 0; b < n; b++) {
+    if (m_blocks[b].in_edges.size() < 2) continue;
+    for (unsigned int k = 0; k < m_blocks[b].in_edges.size(); k++) {
+      int runner = m_edges[m_blocks[b].in_edges[k]].from;
+      while (runner != m_idom[b]) {
+	frontier[runner].insert(b);
+	runner = m_idom[runner];
+      }
+    }
+  }
+
+  std::map<SEXP, std::vector<int> > def_blocks;
+  std::vector<int> kill_blocks;
+  for (unsigned int i = 0; i < m_stmts.size(); i++) {
+    const Stmt & s = m_stmts[i];
+    if (s.kills) kill_blocks.push_back(s.block);
+    for (unsigned int k = 0; k < s.def_mentions.size(); k++) {
+      def_blocks[getProperty(Var, s.def_mentions[k])->get_name()].push_back(s.block);
+    }
+  }
+
+  for (unsigned int i = 0; i < m_names.size(); i++) {
+    SEXP name = m_names[i];
+    std::vector<int> work = def_blocks[name];
+    work.insert(work.end(), kill_blocks.begin(), kill_blocks.end());
+    work.push_back(0);
+    std::vector<bool> queued(n, false), has_phi(n, false);
+    for (unsigned int k = 0; k < work.size(); k++) queued[work[k]] = true;
+    while (!work.empty()) {
+      int b = work.back();
+      work.pop_back();
+      for (std::set<int>::const_iterator it = frontier[b].begin(); it != frontier[b].end(); ++it) {
+	if (has_phi[*it]) continue;
+	has_phi[*it] = true;
+	int phi = new_def(PHI, name, *it, -1, 0);
+	m_defs[phi].args.assign(m_blocks[*it].in_edges.size(), NO_DEF);
+	m_blocks[*it].phis.push_back(phi);
+	if (!queued[*it]) {
+	  queued[*it] = true;
+	  work.push_back(*it);
+	}
+      }
+    }
+  }
+}
+
+/// Rename in a preorder walk of the dominator tree: link the uses in
+/// the block to the defs on top of the stacks, push the block's defs,
+/// fill in the phi arguments of the successors, then do the children.
+void SSAForm::rename(int b) {
+  std::vector<SEXP> pushed;
+  Block & block = m_blocks[b];
+
+  for (unsigned int k = 0; k < block.phis.size(); k++) {
+    SEXP name = m_defs[block.phis[k]].name;
+    m_stacks[name].push_back(block.phis[k]);
+    pushed.push_back(name);
+  }
+
+  for (unsigned int k = 0; k < block.stmts.size(); k++) {
+    int si = block.stmts[k];
+    Stmt & s = m_stmts[si];
+    if (!s.unordered) {
+      for (unsigned int u = 0; u < s.uses.size(); u++) {
+	int def = m_stacks[getProperty(Var, s.uses[u])->get_name()].back();
+	m_use_def[s.uses[u]] = def;
+	if (m_stmt_uses[def].empty() || m_stmt_uses[def].back() != si) {
+	  m_stmt_uses[def].push_back(si);
+	}
+      }
+    }
+    if (s.kills) {
+      for (unsigned int i = 0; i < m_names.size(); i++) {
+	int def = new_def(KILL, m_names[i], b, si, 0);
+	s.defs.push_back(def);
+	m_stacks[m_names[i]].push_back(def);
+	pushed.push_back(m_names[i]);
+      }
+    }
+    for (unsigned int d = 0; d < s.def_mentions.size(); d++) {
+      SEXP name = getProperty(Var, s.def_mentions[d])->get_name();
+      int def = new_def(STMT, name, b, si, s.def_mentions[d]);
+      s.defs.push_back(def);
+      m_stacks[name].push_back(def);
+      pushed.push_back(name);
+    }
+  }
+
+  for (unsigned int k = 0; k < block.out_edges.size(); k++) {
+    int e = block.out_edges[k];
+    Block & succ = m_blocks[m_edges[e].to];
+    int pos = 0;
+    while (succ.in_edges[pos] != e) pos++;
+    for (unsigned int p = 0; p < succ.phis.size(); p++) {
+      Def & phi = m_defs[succ.phis[p]];
+      int arg = m_stacks[phi.name].back();
+      phi.args[pos] = arg;
+      m_phi_uses[arg].push_back(succ.phis[p]);
+    }
+  }
+
+  for (unsigned int k = 0; k < m_dom_children[b].size(); k++) {
+    rename(m_dom_children[b][k]);
+  }
+
+  for (unsigned int k = 0; k < pushed.size(); k++) {
+    m_stacks[pushed[k]].pop_back();
+  }
+}
+
+int SSAForm::new_def(DefKind kind, SEXP name, int block, int stmt, SEXP mention_c) {
+  Def d;
+  d.kind = kind;
+  d.name = name;
+  d.block = block;
+  d.stmt = stmt;
+  d.mention_c = mention_c;
+  m_defs.push_back(d);
+  m_stmt_uses.push_back(std::vector<int>());
+  m_phi_uses.push_back(std::vector<int>());
+  return m_defs.size() - 1;
+}
+
+void SSAForm::dump(std::ostream & os) const {
+  static const char * const kind_names[] = { "entry", "stmt", "kill", "phi" };
+  for (unsigned int b = 0; b < m_blocks.size(); b++) {
+    const Block & block = m_blocks[b];
+    os << "block " << b << " (CFG node " << block.node->getId() << "), idom " << m_idom[b] << ", preds";
+    for (unsigned int k = 0; k < block.in_edges.size(); k++) {
+      os << " " << m_edges[block.in_edges[k]].from;
+    }
+    os << std::endl;
+    for (unsigned int k = 0; k < block.phis.size(); k++) {
+      const Def & phi = m_defs[block.phis[k]];
+      os << "  d" << block.phis[k] << " = phi " << CHAR(PRINTNAME(phi.name)) << " (";
+      for (unsigned int a = 0; a < phi.args.size(); a++) {
+	os << (a > 0 ? ", d" : "d") << phi.args[a];
+      }
+      os << ")" << std::endl;
+    }
+    for (unsigned int k = 0; k < block.stmts.size(); k++) {
+      const Stmt & s = m_stmts[block.stmts[k]];
+      os << "  s" << block.stmts[k] << ": " << to_string(CAR(s.cell)) << std::endl;
+      for (unsigned int u = 0; u < s.uses.size(); u++) {
+	os << "    use " << CHAR(PRINTNAME(CAR(s.uses[u]))) << " <- d" << reaching_def(s.uses[u]) << std::endl;
+      }
+      for (unsigned int d = 0; d < s.defs.size(); d++) {
+	const Def & def = m_defs[s.defs[d]];
+	os << "    " << kind_names[def.kind] << " d" << s.defs[d] << " " << CHAR(PRINTNAME(def.name)) << std::endl;
+      }
+    }
+  }
+}
+
+// ----- static helpers -----
+
+/// The successors of a CFG node with the types of the edges to them
+static void get_succs(OA_ptr<CFG::NodeInterface> node, std::vector<Succ> & succs) {
+  OA_ptr<CFG::EdgesIteratorInterface> ei = node->getCFGOutgoingEdgesIterator();
+  for ( ; ei->isValid(); ++*ei) {
+    OA_ptr<CFG::EdgeInterface> edge = ei->currentCFGEdge();
+    succs.push_back(std::make_pair(edge->getCFGSink(), edge->getType()));
+  }
+}
+
+static bool is_local(SEXP mention_c) {
+  return getProperty(Var, mention_c)->get_scope_type() == Locality::Locality_LOCAL;
+}
+
+/// Does the statement define a name anywhere but its top level (the
+/// left side of an assignment or the index of a for loop)?
+static bool has_inner_def(SEXP stmt_c) {
+  SEXP def;
+  SEXP e = CAR(stmt_c);
+  ExpressionInfo * annot = getProperty(ExpressionInfo, stmt_c);
+  EXPRESSION_FOR_EACH_DEF(annot, def) {
+    if (!(is_assign(e) && def == assign_lhs_c(e)) && !(is_for(e) && def == for_iv_c(e))) {
+      return true;
+    }
+  }
+  return false;
+}
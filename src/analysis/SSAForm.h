@@ -0,0 +1,148 @@
+// -*- Mode: C++ -*-
+//
+// Copyright (c) 2009 Rice University
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation; either version 2 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+
+// File: SSAForm.h
+//
+// Static single assignment form of the local names of a procedure,
+// built over its CFG: every use of a local name is linked to the one
+// definition that reaches it, with phi definitions at join points.
+// This is the substrate for sparse analyses, which follow def-use
+// chains instead of propagating sets of names through every
+// statement.
+//
+// Author: John Garvin (garvin@cs.rice.edu)
+
+#ifndef SSA_FORM_H
+#define SSA_FORM_H
+
+#include <map>
+#include <ostream>
+#include <vector>
+
+#include <OpenAnalysis/CFG/CFG.hpp>
+
+#include <include/R/R_RInternals.h>
+
+namespace RAnnot { class FuncInfo; }
+
+/// Blocks are the reachable CFG nodes, numbered in reverse postorder,
+/// so block 0 is the entry. Statements are numbered in order within
+/// each block.
+///
+/// Definitions are:
+///   ENTRY   the value of a name on entry (a formal's promise, or unbound)
+///   STMT    an assignment, a for loop's index, or any other def
+///           (e.g. assign() on a local name or a def inside a call)
+///   KILL    the unknown value a name has after a statement that may
+///           modify locals behind our back (see ConstantFolder::kills_locals)
+///   PHI     the merge of a name's definitions at a join point
+///
+/// A use has no reaching definition (reaching_def returns NO_DEF) if
+/// its statement also defines local names somewhere other than at
+/// its top level, so that the order of the use and the def within
+/// the statement is not known.
+class SSAForm {
+public:
+  enum DefKind { ENTRY, STMT, KILL, PHI };
+
+  static const int NO_DEF = -1;
+
+  struct Def {
+    DefKind kind;
+    SEXP name;
+    int block;
+    int stmt;               // -1 for ENTRY and PHI
+    SEXP mention_c;         // the def's mention, for STMT
+    std::vector<int> args;  // for PHI, one per predecessor of the block
+  };
+
+  struct Edge {
+    int from;
+    int to;
+    OA::CFG::EdgeType type;
+  };
+
+  struct Block {
+    OA::OA_ptr<OA::CFG::NodeInterface> node;
+    std::vector<int> stmts;
+    std::vector<int> phis;
+    std::vector<int> in_edges;   // in predecessor order
+    std::vector<int> out_edges;
+  };
+
+  struct Stmt {
+    SEXP cell;
+    int block;
+    bool kills;                      // may modify every local name
+    bool unordered;                  // defines locals below its top level
+    std::vector<SEXP> uses;          // local name mentions
+    std::vector<SEXP> def_mentions;  // local name mentions
+    std::vector<int> defs;           // KILLs, then one STMT per def mention
+  };
+
+  explicit SSAForm(RAnnot::FuncInfo * fi);
+
+  RAnnot::FuncInfo * get_func_info() const { return m_fi; }
+
+  const std::vector<Block> & blocks() const { return m_blocks; }
+  const std::vector<Edge> & edges() const { return m_edges; }
+  const std::vector<Stmt> & stmts() const { return m_stmts; }
+  const std::vector<Def> & defs() const { return m_defs; }
+
+  /// The definition reaching the use of a local name in the cell, or
+  /// NO_DEF if it is unknown or the cell is not such a use.
+  int reaching_def(SEXP use_c) const;
+
+  /// The statements using a definition, each once
+  const std::vector<int> & stmt_uses(int def) const { return m_stmt_uses[def]; }
+
+  /// The phis using a definition
+  const std::vector<int> & phi_uses(int def) const { return m_phi_uses[def]; }
+
+  /// The index of a statement, or -1 if it is not in a reachable block
+  int stmt_index(SEXP stmt_c) const;
+
+  int immediate_dominator(int block) const { return m_idom[block]; }
+
+  void dump(std::ostream & os) const;
+
+private:
+  void number_blocks();
+  void collect_stmts();
+  void compute_dominators();
+  void place_phis();
+  void rename(int block);
+  int new_def(DefKind kind, SEXP name, int block, int stmt, SEXP mention_c);
+
+private:
+  RAnnot::FuncInfo * m_fi;
+  std::vector<Block> m_blocks;
+  std::vector<Edge> m_edges;
+  std::vector<Stmt> m_stmts;
+  std::vector<Def> m_defs;
+  std::vector<int> m_idom;
+  std::vector<std::vector<int> > m_dom_children;
+  std::vector<SEXP> m_names;                    // local names, in order of first mention
+  std::map<SEXP, std::vector<int> > m_stacks;   // renaming: current def of each name
+  std::map<SEXP, int> m_use_def;
+  std::map<SEXP, int> m_stmt_index;
+  std::vector<std::vector<int> > m_stmt_uses;
+  std::vector<std::vector<int> > m_phi_uses;
+};
+
+#endif // SSA_FORM_H
@@ -68,7 +68,7 @@ PropertyHndlT ScopeAnnotationMap::handle() {
 
 void ScopeAnnotationMap::create() {
   s_instance = new ScopeAnnotationMap();
-  analysisResults.add(s_handle, s_instance);
+  analysisResults.add_instance(s_handle, s_instance);
 }
 
 ScopeAnnotationMap * ScopeAnnotationMap::s_instance = 0;
@@ -35,4 +35,9 @@ Settings * Settings::instance() {
   return s_instance;
 }
 
+void Settings::reset() {
+  delete s_instance;
+  s_instance = 0;
+}
+
 
@@ -46,6 +46,20 @@ class Settings {
   BOOL_GETTER_SETTER(lookup_elimination)
   BOOL_GETTER_SETTER(stack_alloc_obj)
   BOOL_GETTER_SETTER(stack_debug)
+  BOOL_GETTER_SETTER(region_alloc)
+  BOOL_GETTER_SETTER(protect_elision)
+  BOOL_GETTER_SETTER(constant_folding)
+  BOOL_GETTER_SETTER(sparse_constants)
+  BOOL_GETTER_SETTER(dead_store_elimination)
+  BOOL_GETTER_SETTER(bounds_check_elimination)
+  BOOL_GETTER_SETTER(loop_box_reuse)
+  BOOL_GETTER_SETTER(field_cache)
+  BOOL_GETTER_SETTER(native_conditions)
+  BOOL_GETTER_SETTER(serialized_constants)
+  BOOL_GETTER_SETTER(lazy_constants)
+  BOOL_GETTER_SETTER(profile)
+  BOOL_GETTER_SETTER(profile_sites)
+  BOOL_GETTER_SETTER(alloc_stats)
   BOOL_GETTER_SETTER(assume_correct_program)
   BOOL_GETTER_SETTER(aggressive_cbv)
   BOOL_GETTER_SETTER(resolve_arguments)
@@ -53,6 +67,8 @@ class Settings {
   // Singleton pattern
 public:
   static Settings * instance();
+  /// Forget the instance, so the next compilation starts afresh
+  static void reset();
 
 private:
   Settings() : m_for_loop_range_deforestation(true),
@@ -63,6 +79,20 @@ private:
 	       m_lookup_elimination(true),
 	       m_stack_alloc_obj(true),
 	       m_stack_debug(false),
+	       m_region_alloc(false),
+	       m_protect_elision(false),
+	       m_constant_folding(true),
+	       m_sparse_constants(true),
+	       m_dead_store_elimination(true),
+	       m_bounds_check_elimination(true),
+	       m_loop_box_reuse(true),
+	       m_field_cache(true),
+	       m_native_conditions(true),
+	       m_serialized_constants(false),
+	       m_lazy_constants(false),
+	       m_profile(false),
+	       m_profile_sites(false),
+	       m_alloc_stats(false),
 	       m_assume_correct_program(false),
 	       m_aggressive_cbv(false),
 	       m_resolve_arguments(true)
@@ -83,6 +113,20 @@ public:
     out += SETTINGS_PRETTY_PRINT(lookup_elimination);
     out += SETTINGS_PRETTY_PRINT(stack_alloc_obj);
     out += SETTINGS_PRETTY_PRINT(stack_debug);
+    out += SETTINGS_PRETTY_PRINT(region_alloc);
+    out += SETTINGS_PRETTY_PRINT(protect_elision);
+    out += SETTINGS_PRETTY_PRINT(constant_folding);
+    out += SETTINGS_PRETTY_PRINT(sparse_constants);
+    out += SETTINGS_PRETTY_PRINT(dead_store_elimination);
+    out += SETTINGS_PRETTY_PRINT(bounds_check_elimination);
+    out += SETTINGS_PRETTY_PRINT(loop_box_reuse);
+    out += SETTINGS_PRETTY_PRINT(field_cache);
+    out += SETTINGS_PRETTY_PRINT(native_conditions);
+    out += SETTINGS_PRETTY_PRINT(serialized_constants);
+    out += SETTINGS_PRETTY_PRINT(lazy_constants);
+    out += SETTINGS_PRETTY_PRINT(profile);
+    out += SETTINGS_PRETTY_PRINT(profile_sites);
+    out += SETTINGS_PRETTY_PRINT(alloc_stats);
     out += SETTINGS_PRETTY_PRINT(assume_correct_program);
     out += SETTINGS_PRETTY_PRINT(aggressive_cbv);
     out += SETTINGS_PRETTY_PRINT(resolve_arguments);
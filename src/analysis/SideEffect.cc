@@ -52,7 +52,8 @@ static bool sets_intersect(MyVarSetT s, MyVarSetT t);
 SideEffect::SideEffect(bool trivial, bool cheap)
   : m_trivial(trivial),
     m_cheap(cheap),
-    m_action(false)
+    m_action(false),
+    m_unknown(false)
 {
 }
 
@@ -73,6 +74,10 @@ void SideEffect::set_action(bool x) {
   m_action = x;
 }
 
+void SideEffect::set_unknown(bool x) {
+  m_unknown = x;
+}
+
 // ----- insertion -----
 
 void SideEffect::insert_use_sexp(const SEXP sexp) {
@@ -105,6 +110,7 @@ void SideEffect::add(const SideEffect * x) {
     m_defs.insert(*it);
   }
   m_action = m_action || x->get_action();
+  m_unknown = m_unknown || x->get_unknown();
 }
 
 // ----- getters -----
@@ -112,6 +118,10 @@ void SideEffect::add(const SideEffect * x) {
 bool SideEffect::get_action() const {
   return m_action;
 }
+
+bool SideEffect::get_unknown() const {
+  return m_unknown;
+}
   
 MyVarSetT SideEffect::get_uses() const {
   return m_uses;
@@ -154,6 +164,11 @@ bool SideEffect::intersects(SideEffect * other) const {
   if (get_action() && other->get_action()) {
     return true;
   }
+  if ((get_unknown() && other->mentions_names()) ||
+      (other->get_unknown() && mentions_names()))
+  {
+    return true;
+  }
 
   bool true_dep = sets_intersect(get_defs(), other->get_uses());
   bool anti_dep = sets_intersect(get_uses(), other->get_defs());
@@ -161,6 +176,11 @@ bool SideEffect::intersects(SideEffect * other) const {
   return (true_dep || anti_dep || output_dep);
 }
 
+// whether there may be any use or def of a name
+bool SideEffect::mentions_names() const {
+  return (m_unknown || !m_uses.empty() || !m_defs.empty());
+}
+
 // ----- debugging -----
 
 std::ostream & SideEffect::dump(std::ostream & os) const {
@@ -178,6 +198,7 @@ std::ostream & SideEffect::dump(std::ostream & os) const {
   os << "Trivial: " << m_trivial << std::endl;
   os << "Cheap: " << m_cheap << std::endl;
   os << "Action: " << m_action << std::endl;
+  os << "Unknown: " << m_unknown << std::endl;
   endObjDump(os, SideEffect);
 }
 
@@ -56,6 +56,11 @@ public:
   void set_action(bool x);
   bool get_action() const;
 
+  /// whether the effect includes a call to a procedure the analysis
+  /// could not resolve, which may use or define any name
+  void set_unknown(bool x);
+  bool get_unknown() const;
+
   MyVarSetT get_uses() const;
   MyVarSetT get_defs() const;
 
@@ -79,9 +84,14 @@ public:
   std::ostream & dump(std::ostream & os) const;
 
 private:
+  bool mentions_names() const;
+
   // whether there is an "action" side effect, such as writing to the screen
   bool m_action;
 
+  // whether there may be uses and defs of names not in m_uses and m_defs
+  bool m_unknown;
+
   MyRawVarSetT m_uses;
   MyRawVarSetT m_defs;
 
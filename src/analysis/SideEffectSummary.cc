@@ -0,0 +1,100 @@
+// -*- Mode: C++ -*-
+//
+// Copyright (c) 2009 Rice University
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation; either version 2 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA 
+
+// File: SideEffectSummary.cc
+//
+// Interprocedural side effect summary of a procedure.
+//
+// Author: John Garvin (garvin@cs.rice.edu)
+
+#include <analysis/Analyst.h>
+#include <analysis/LexicalScope.h>
+#include <analysis/SideEffectSummaryAnnotationMap.h>
+#include <analysis/Utils.h>
+#include <analysis/VarInfo.h>
+
+#include <support/DumpMacros.h>
+#include <support/RccError.h>
+
+#include "SideEffectSummary.h"
+
+namespace RAnnot {
+
+static void serialize_names(std::ostream & os, SideEffect::MyIteratorT begin, SideEffect::MyIteratorT end);
+
+SideEffectSummary::SideEffectSummary()
+  : m_side_effect(new SideEffect(false, false))
+{
+}
+
+SideEffectSummary::~SideEffectSummary() {
+  delete m_side_effect;
+}
+
+SideEffect * SideEffectSummary::get_side_effect() const {
+  return m_side_effect;
+}
+
+// ----- handle, cloning for Annotation -----
+
+PropertyHndlT SideEffectSummary::handle() {
+  return SideEffectSummaryAnnotationMap::handle();
+}
+
+AnnotationBase * SideEffectSummary::clone() {
+  rcc_error("Cloning not implemented in SideEffectSummary");
+  return 0;
+}
+
+// ----- serialization -----
+
+std::ostream & SideEffectSummary::serialize(std::ostream & os) const {
+  os << "ref:";
+  serialize_names(os, m_side_effect->begin_uses(), m_side_effect->end_uses());
+  os << "; mod:";
+  serialize_names(os, m_side_effect->begin_defs(), m_side_effect->end_defs());
+  if (m_side_effect->get_unknown()) {
+    os << "; unknown";
+  }
+  return os;
+}
+
+// global names are written bare, names with no known scope as name@?
+static void serialize_names(std::ostream & os, SideEffect::MyIteratorT begin, SideEffect::MyIteratorT end) {
+  const LexicalScope * global = R_Analyst::instance()->get_global_scope();
+  for (SideEffect::MyIteratorT it = begin; it != end; ++it) {
+    os << " " << var_name((*it)->get_name());
+    if (!(*it)->has_scope()) {
+      os << "@?";
+    } else if ((*it)->get_scope() != global) {
+      os << "@" << (*it)->get_scope()->get_name();
+    }
+  }
+}
+
+// ----- debugging -----
+
+std::ostream & SideEffectSummary::dump(std::ostream & os) const {
+  beginObjDump(os, SideEffectSummary);
+  serialize(os);
+  os << std::endl;
+  endObjDump(os, SideEffectSummary);
+  return os;
+}
+
+} // end namespace RAnnot
@@ -0,0 +1,64 @@
+// -*- Mode: C++ -*-
+//
+// Copyright (c) 2009 Rice University
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation; either version 2 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA 
+
+// File: SideEffectSummary.h
+//
+// Interprocedural side effect summary of a procedure: the names
+// outside the procedure that calling it may use or define, directly
+// or through the procedures it calls. Used as an annotation type by
+// SideEffectSummaryAnnotationMap. Does not own the VarInfo
+// annotations it contains.
+//
+// Author: John Garvin (garvin@cs.rice.edu)
+
+#ifndef SIDE_EFFECT_SUMMARY_H
+#define SIDE_EFFECT_SUMMARY_H
+
+#include <ostream>
+
+#include <analysis/AnnotationBase.h>
+#include <analysis/PropertyHndl.h>
+#include <analysis/SideEffect.h>
+
+namespace RAnnot {
+
+class SideEffectSummary : public AnnotationBase {
+public:
+  explicit SideEffectSummary();
+  virtual ~SideEffectSummary();
+
+  /// uses are the REF set, defs the MOD set
+  SideEffect * get_side_effect() const;
+
+  AnnotationBase * clone();
+  static PropertyHndlT handle();
+
+  /// Write the summary on one line as "ref: x y@f; mod: z", followed
+  /// by "; unknown" if it includes unresolved calls. Names bound
+  /// outside the global scope are qualified by their procedure.
+  std::ostream & serialize(std::ostream & os) const;
+
+  std::ostream & dump(std::ostream & os) const;
+
+private:
+  SideEffect * m_side_effect;
+};
+
+}
+
+#endif
@@ -0,0 +1,317 @@
+// -*- Mode: C++ -*-
+//
+// Copyright (c) 2009 Rice University
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation; either version 2 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA 
+
+// File: SideEffectSummaryAnnotationMap.cc
+//
+// Maps fundef SEXPs to interprocedural side effect summaries,
+// computed on demand bottom-up over call graph SCCs.
+//
+// Author: John Garvin (garvin@cs.rice.edu)
+
+#include <algorithm>
+
+#include <OpenAnalysis/IRInterface/IRHandles.hpp>
+
+#include <analysis/AnalysisResults.h>
+#include <analysis/BasicVar.h>
+#include <analysis/Analyst.h>
+#include <analysis/FuncInfo.h>
+#include <analysis/FuncInfoAnnotationMap.h>
+#include <analysis/HandleInterface.h>
+#include <analysis/HellProcedure.h>
+#include <analysis/IRInterface.h>
+#include <analysis/LexicalScope.h>
+#include <analysis/OACallGraphAnnotation.h>
+#include <analysis/OACallGraphAnnotationMap.h>
+#include <analysis/SymbolTableFacade.h>
+#include <analysis/Utils.h>
+#include <analysis/Var.h>
+#include <analysis/VarInfo.h>
+
+#include <support/Debug.h>
+
+#include <CompileReport.h>
+
+#include "SideEffectSummaryAnnotationMap.h"
+
+using namespace OA;
+using namespace HandleInterface;
+
+static bool debug;
+
+namespace RAnnot {
+
+// ----- type definitions for readability -----
+
+typedef SideEffectSummaryAnnotationMap::MyKeyT MyKeyT;
+typedef SideEffectSummaryAnnotationMap::MyMappedT MyMappedT;
+
+static bool is_nonlocal(VarInfo * vi, FuncInfo * fi);
+static void add_nonlocal(FuncInfo * fi, SideEffect * from, SideEffect * to);
+
+//  ----- constructor/destructor -----
+
+SideEffectSummaryAnnotationMap::SideEffectSummaryAnnotationMap()
+  : m_next_index(0)
+{
+  RCC_DEBUG("RCC_SideEffectSummary", debug);
+}
+
+SideEffectSummaryAnnotationMap::~SideEffectSummaryAnnotationMap() {
+  delete_map_values();
+}
+
+// ----- singleton pattern -----
+
+SideEffectSummaryAnnotationMap * SideEffectSummaryAnnotationMap::instance() {
+  if (s_instance == 0) {
+    create();
+  }
+  return s_instance;
+}
+
+PropertyHndlT SideEffectSummaryAnnotationMap::handle() {
+  if (s_instance == 0) {
+    create();
+  }
+  return s_handle;
+}
+
+void SideEffectSummaryAnnotationMap::create() {
+  s_instance = new SideEffectSummaryAnnotationMap();
+  analysisResults.add_instance(s_handle, s_instance);
+}
+
+SideEffectSummaryAnnotationMap * SideEffectSummaryAnnotationMap::s_instance = 0;
+PropertyHndlT SideEffectSummaryAnnotationMap::s_handle = "SideEffectSummary";
+
+// ----- demand-driven analysis -----
+
+// overrides DefaultAnnotationMap::get, which would compute every summary
+MyMappedT SideEffectSummaryAnnotationMap::get(const MyKeyT & k) {
+  return summarize(getProperty(FuncInfo, k));
+}
+
+void SideEffectSummaryAnnotationMap::add_call_side_effect(const SEXP call, SideEffect * side_effect) {
+  std::vector<FuncInfo *> callees;
+  bool unknown = false;
+  resolve_call(call, callees, unknown);
+  if (unknown) {
+    side_effect->set_unknown(true);
+  }
+  std::vector<FuncInfo *>::const_iterator it;
+  for (it = callees.begin(); it != callees.end(); ++it) {
+    side_effect->add(summarize(*it)->get_side_effect());
+  }
+}
+
+SideEffectSummary * SideEffectSummaryAnnotationMap::summarize(FuncInfo * fi) {
+  if (get_map().find(fi->get_sexp()) == get_map().end()) {
+    if (CompileReport::instance()->enabled()) {
+      ReportPhase phase("analysis: " + report_name());
+      visit(fi);
+    } else {
+      visit(fi);
+    }
+  }
+  return dynamic_cast<SideEffectSummary *>(get_map()[fi->get_sexp()]);
+}
+
+void SideEffectSummaryAnnotationMap::compute() {
+  FuncInfo * fi;
+  FOR_EACH_PROC(fi) {
+    if (get_map().find(fi->get_sexp()) == get_map().end()) {
+      visit(fi);
+    }
+  }
+}
+
+/// Tarjan's algorithm: visit the procedure and everything it calls
+/// that is not yet summarized. Components are finished callees
+/// first, so each is solved when the summaries below it are done.
+void SideEffectSummaryAnnotationMap::visit(FuncInfo * fi) {
+  m_index[fi] = m_low[fi] = m_next_index++;
+  m_stack.push_back(fi);
+  m_on_stack.insert(fi);
+  m_pending[fi] = make_local_summary(fi);
+
+  const std::vector<FuncInfo *> & callees = m_callees[fi];
+  std::vector<FuncInfo *>::const_iterator it;
+  for (it = callees.begin(); it != callees.end(); ++it) {
+    FuncInfo * callee = *it;
+    if (get_map().find(callee->get_sexp()) != get_map().end()) {
+      continue;  // in a finished component
+    }
+    if (m_index.find(callee) == m_index.end()) {
+      visit(callee);
+      m_low[fi] = std::min(m_low[fi], m_low[callee]);
+    } else if (m_on_stack.find(callee) != m_on_stack.end()) {
+      m_low[fi] = std::min(m_low[fi], m_index[callee]);
+    }
+  }
+
+  if (m_low[fi] == m_index[fi]) {
+    std::vector<FuncInfo *> component;
+    FuncInfo * member;
+    do {
+      member = m_stack.back();
+      m_stack.pop_back();
+      m_on_stack.erase(member);
+      component.push_back(member);
+    } while (member != fi);
+    solve_component(component);
+  }
+}
+
+/// Add the callees' summaries to each member's until nothing
+/// changes, then move the members' summaries into the map. Callees
+/// outside the component are already in the map.
+void SideEffectSummaryAnnotationMap::solve_component(const std::vector<FuncInfo *> & component) {
+  std::vector<FuncInfo *>::const_iterator it, callee;
+  bool changed = true;
+  while (changed) {
+    changed = false;
+    for (it = component.begin(); it != component.end(); ++it) {
+      SideEffect * se = m_pending[*it]->get_side_effect();
+      unsigned int size = se->get_uses().size() + se->get_defs().size();
+      bool unknown = se->get_unknown();
+      const std::vector<FuncInfo *> & callees = m_callees[*it];
+      for (callee = callees.begin(); callee != callees.end(); ++callee) {
+	std::map<FuncInfo *, SideEffectSummary *>::const_iterator pending = m_pending.find(*callee);
+	SideEffectSummary * summary;
+	if (pending != m_pending.end()) {
+	  summary = pending->second;
+	} else {
+	  summary = dynamic_cast<SideEffectSummary *>(get_map()[(*callee)->get_sexp()]);
+	}
+	add_nonlocal(*it, summary->get_side_effect(), se);
+      }
+      if (se->get_uses().size() + se->get_defs().size() != size || se->get_unknown() != unknown) {
+	changed = true;
+      }
+    }
+  }
+
+  for (it = component.begin(); it != component.end(); ++it) {
+    get_map()[(*it)->get_sexp()] = m_pending[*it];
+    m_pending.erase(*it);
+    if (debug) {
+      std::cout << R_Analyst::instance()->get_interface()->toString(make_proc_h((*it)->get_sexp())) << ": ";
+      dynamic_cast<SideEffectSummary *>(get_map()[(*it)->get_sexp()])->serialize(std::cout);
+      std::cout << std::endl;
+    }
+  }
+}
+
+/// Non-local names the procedure mentions itself, and the procedures
+/// its call sites may invoke
+SideEffectSummary * SideEffectSummaryAnnotationMap::make_local_summary(FuncInfo * fi) {
+  SideEffectSummary * summary = new SideEffectSummary();
+  SideEffect * se = summary->get_side_effect();
+  SymbolTableFacade * symbol_table = SymbolTableFacade::instance();
+
+  PROC_FOR_EACH_MENTION(fi, mi) {
+    VarInfo * vi = symbol_table->find_entry(*mi);
+    if (is_nonlocal(vi, fi)) {
+      Var * var = getProperty(Var, *mi);
+      if (var->get_use_def_type() == BasicVar::Var_DEF) {
+	se->insert_def(vi);
+      } else {
+	se->insert_use(vi);
+      }
+    }
+  }
+
+  std::vector<FuncInfo *> & callees = m_callees[fi];
+  bool unknown = false;
+  PROC_FOR_EACH_CALL_SITE(fi, csi) {
+    resolve_call(CAR(*csi), callees, unknown);
+  }
+  se->set_unknown(unknown);
+  return summary;
+}
+
+/// Add the procedures the call may invoke to callees, or set unknown
+/// if the call graph cannot say. Library procedures are assumed to
+/// have no effect on names in userland.
+void SideEffectSummaryAnnotationMap::resolve_call(const SEXP call, std::vector<FuncInfo *> & callees, bool & unknown) {
+  SEXP lhs = call_lhs(call);
+  if (is_var(lhs) && is_library(lhs)) {
+    return;
+  }
+  OACallGraphAnnotation * cga = dynamic_cast<OACallGraphAnnotation *>(OACallGraphAnnotationMap::instance()->get(call));
+  if (cga == 0) {
+    unknown = true;
+    return;
+  }
+  OA_ptr<ProcHandleIterator> iter = cga->get_iterator();
+  for (iter->reset(); iter->isValid(); ++*iter) {
+    ProcHandle ph = iter->current();
+    if (ph == HellProcedure::instance()) {
+      unknown = true;
+      continue;
+    }
+    FuncInfo * callee = getProperty(FuncInfo, make_sexp(ph));
+    if (std::find(callees.begin(), callees.end(), callee) == callees.end()) {
+      callees.push_back(callee);
+    }
+  }
+  iter->reset();
+}
+
+// ----- serialization -----
+
+void SideEffectSummaryAnnotationMap::serialize(std::ostream & os) const {
+  OA_ptr<R_IRInterface> interface; interface = R_Analyst::instance()->get_interface();
+  std::map<MyKeyT, MyMappedT>::const_iterator it;
+  for (it = get_map().begin(); it != get_map().end(); ++it) {
+    os << interface->toString(make_proc_h(it->first)) << ": ";
+    dynamic_cast<SideEffectSummary *>(it->second)->serialize(os);
+    os << std::endl;
+  }
+}
+
+// ----- static functions -----
+
+/// A name is non-local to a procedure unless the procedure's own
+/// scope binds it. Names in the ambiguous symbol table have no scope
+/// and count as non-local.
+static bool is_nonlocal(VarInfo * vi, FuncInfo * fi) {
+  return (!vi->has_scope() || vi->get_scope() != fi->get_scope());
+}
+
+/// Add to the side effect of procedure fi the names in a callee's
+/// summary that are not local to fi
+static void add_nonlocal(FuncInfo * fi, SideEffect * from, SideEffect * to) {
+  SideEffect::MyIteratorT it;
+  for (it = from->begin_uses(); it != from->end_uses(); ++it) {
+    if (is_nonlocal(*it, fi)) {
+      to->insert_use(*it);
+    }
+  }
+  for (it = from->begin_defs(); it != from->end_defs(); ++it) {
+    if (is_nonlocal(*it, fi)) {
+      to->insert_def(*it);
+    }
+  }
+  if (from->get_unknown()) {
+    to->set_unknown(true);
+  }
+}
+
+}  // end namespace RAnnot
@@ -0,0 +1,101 @@
+// -*- Mode: C++ -*-
+//
+// Copyright (c) 2009 Rice University
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation; either version 2 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA 
+
+// File: SideEffectSummaryAnnotationMap.h
+//
+// Maps fundef SEXPs to interprocedural side effect summaries
+// (SideEffectSummary). Summaries are computed on demand: asking for
+// one procedure's summary computes it bottom-up over the strongly
+// connected components of the call graph below it, and nothing
+// else. Owns the values in its map.
+//
+// Author: John Garvin (garvin@cs.rice.edu)
+
+#ifndef SIDE_EFFECT_SUMMARY_ANNOTATION_MAP_H
+#define SIDE_EFFECT_SUMMARY_ANNOTATION_MAP_H
+
+#include <map>
+#include <ostream>
+#include <set>
+#include <vector>
+
+#include <analysis/DefaultAnnotationMap.h>
+#include <analysis/PropertyHndl.h>
+#include <analysis/SideEffectSummary.h>
+
+namespace RAnnot {
+
+class FuncInfo;
+
+class SideEffectSummaryAnnotationMap : public DefaultAnnotationMap {
+public:
+  virtual ~SideEffectSummaryAnnotationMap();
+
+  // singleton
+  static SideEffectSummaryAnnotationMap * instance();
+
+  // getting the name causes this map to be created and registered
+  static PropertyHndlT handle();
+
+  /// Summary of the given fundef; computes it if necessary.
+  // overrides DefaultAnnotationMap::get
+  virtual MyMappedT get(const MyKeyT & k);
+
+  /// Add the uses and defs of everything the call may invoke to the
+  /// given side effect. Calls to library procedures add nothing;
+  /// calls that cannot be resolved mark the side effect unknown.
+  void add_call_side_effect(const SEXP call, SideEffect * side_effect);
+
+  /// Write each summary computed so far on its own line, prefixed by
+  /// the procedure's name
+  void serialize(std::ostream & os) const;
+
+private:
+  // private constructor for singleton pattern
+  explicit SideEffectSummaryAnnotationMap();
+
+  /// summarize every procedure
+  void compute();
+
+  SideEffectSummary * summarize(FuncInfo * fi);
+  void visit(FuncInfo * fi);
+  void solve_component(const std::vector<FuncInfo *> & component);
+  SideEffectSummary * make_local_summary(FuncInfo * fi);
+  void resolve_call(const SEXP call, std::vector<FuncInfo *> & callees, bool & unknown);
+
+  static SideEffectSummaryAnnotationMap * s_instance;
+  static PropertyHndlT s_handle;
+  static void create();
+
+  // procedures called by each procedure, resolved when its local
+  // summary is made
+  std::map<FuncInfo *, std::vector<FuncInfo *> > m_callees;
+
+  // state of Tarjan's SCC search; m_pending holds the summaries of
+  // procedures visited but not yet in a finished component
+  std::map<FuncInfo *, unsigned int> m_index;
+  std::map<FuncInfo *, unsigned int> m_low;
+  std::vector<FuncInfo *> m_stack;
+  std::set<FuncInfo *> m_on_stack;
+  std::map<FuncInfo *, SideEffectSummary *> m_pending;
+  unsigned int m_next_index;
+};
+
+}  // end namespace RAnnot
+
+#endif
@@ -79,4 +79,9 @@ SpecialProcSymMap * SpecialProcSymMap::instance() {
   return s_instance;
 }
 
+void SpecialProcSymMap::reset() {
+  delete s_instance;
+  s_instance = 0;
+}
+
 SpecialProcSymMap * SpecialProcSymMap::s_instance = 0;
@@ -59,6 +59,8 @@ public:
   // ----- singleton pattern -----
 
   static SpecialProcSymMap * instance();
+  /// Forget the instance, so the next compilation starts afresh
+  static void reset();
 
 private:
   MyMapT m_anons;
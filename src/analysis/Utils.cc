@@ -238,6 +238,23 @@ SEXP library_value(const SEXP e) {
   return value;
 }
 
+/// Is e the name of a library procedure that can read or write the
+/// local variables of its caller?
+bool is_environment_library(const SEXP e) {
+  static const char * const names[] = {
+    "assign", "rm", "remove", "get", "mget", "exists", "ls", "objects",
+    "eval", "evalq", "eval.parent", "local", "with", "within", "attach",
+    "delayedAssign", "makeActiveBinding", "environment", "parent.frame",
+    "sys.frame", "sys.frames", "sys.function", "sys.call", "on.exit",
+    "source", "browser", "substitute", "UseMethod", "NextMethod",
+    0 };
+  assert(is_var(e));
+  for (const char * const * n = names; *n != 0; n++) {
+    if (e == Rf_install(*n)) return true;
+  }
+  return false;
+}
+
 bool is_cons(const SEXP e) {
   return (TYPEOF(e) == LISTSXP || TYPEOF(e) == LANGSXP);
 }
@@ -68,6 +68,7 @@ bool is_library_builtin(const SEXP e);
 bool is_library_special(const SEXP e);
 bool is_library_closure(const SEXP e);
 SEXP library_value(const SEXP e);
+bool is_environment_library(const SEXP e);
 bool is_cons(const SEXP e);
 bool is_string(const SEXP e);
 bool is_call(const SEXP e);
@@ -80,6 +81,7 @@ bool is_if(const SEXP e);
 SEXP if_cond_c(const SEXP e);
 SEXP if_truebody_c(const SEXP e);
 SEXP if_falsebody_c(const SEXP e);
+// short-circuit && or || with two arguments
 bool is_explicit_return(const SEXP e);
 bool is_break(const SEXP e);
 bool is_stop(const SEXP e);
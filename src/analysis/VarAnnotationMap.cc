@@ -87,7 +87,7 @@ PropertyHndlT VarAnnotationMap::handle() {
 
 void VarAnnotationMap::create() {
   s_instance = new VarAnnotationMap();
-  analysisResults.add(s_handle, s_instance);
+  analysisResults.add_instance(s_handle, s_instance);
 }
 
 VarAnnotationMap * VarAnnotationMap::s_instance = 0;
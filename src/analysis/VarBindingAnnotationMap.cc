@@ -84,7 +84,7 @@ PropertyHndlT VarBindingAnnotationMap::handle() {
 
 void VarBindingAnnotationMap::create() {
   s_instance = new VarBindingAnnotationMap();
-  analysisResults.add(s_handle, s_instance);
+  analysisResults.add_instance(s_handle, s_instance);
 }
 
 VarBindingAnnotationMap * VarBindingAnnotationMap::s_instance = 0;
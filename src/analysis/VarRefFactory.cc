@@ -58,6 +58,11 @@ VarRefFactory * VarRefFactory::instance() {
   return s_instance;
 }
 
+void VarRefFactory::reset() {
+  delete s_instance;
+  s_instance = 0;
+}
+
 VarRefFactory::VarRefFactory() {
 }
 
@@ -40,6 +40,8 @@ public:
   OA::OA_ptr<R_ArgVarRef> make_arg_var_ref(SEXP e);
 
   static VarRefFactory * instance();
+  /// Forget the instance, so the next compilation starts afresh
+  static void reset();
 
 private:
   // singleton pattern
@@ -108,7 +108,7 @@ PropertyHndlT RccCallGraphAnnotationMap::handle() {
   
 void RccCallGraphAnnotationMap::create() {
   s_instance = new RccCallGraphAnnotationMap();
-  analysisResults.add(s_handle, s_instance);
+  analysisResults.add_instance(s_handle, s_instance);
 }
   
 RccCallGraphAnnotationMap * RccCallGraphAnnotationMap::s_instance = 0;
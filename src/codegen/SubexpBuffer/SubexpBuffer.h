@@ -40,6 +40,7 @@
 namespace RAnnot {
   class FuncInfo;
 }
+class OutputUnits;
 
 class SubexpBuffer {
 public:
@@ -134,8 +135,9 @@ public:
 		    std::string arg7, 
 		    Protection resultProtection = Protected);
 
-  std::string op_program(SEXP e, std::string rho, std::string func_name,
-			 bool output_main_program, bool output_default_args);
+  void op_program(SEXP e, std::string rho, std::string func_name,
+		  bool output_main_program, bool output_default_args,
+		  OutputUnits & units);
   Expression op_exp(SEXP cell, std::string rho, 
 		    Protection resultProtection = Protected, 
 		    bool fullyEvaluatedResult = false,
@@ -162,6 +164,12 @@ public:
   Expression op_for_colon(SEXP e, std::string rho,
 			  ResultStatus resultStatus = ResultNeeded);
   Expression op_while(SEXP e, std::string rho, ResultStatus resultStatus = ResultNeeded);
+  std::string op_native_condition(SEXP cond_c, std::string rho);
+  /// Whether e is the library's && or || with two untagged operands
+  static bool is_native_andor(SEXP e);
+  Expression op_andor(SEXP cell, std::string rho,
+		      Protection resultProtection,
+		      ResultStatus resultStatus = ResultNeeded);
   Expression op_repeat(SEXP e, std::string rho);
   Expression op_return(SEXP e, std::string rho);
   Expression op_struct_field(SEXP e, SEXP op, std::string rho, Protection resultProtection);
@@ -202,6 +210,10 @@ public:
   const Expression output_to_expression(const Output op);
   const std::string get_prefix() { return prefix; }
 
+  /// Number temporaries and protected globals from zero again, for a
+  /// new compilation in the same process.
+  static void reset_counters();
+
 protected:
   const std::string prefix;
   static unsigned int n;
@@ -29,8 +29,11 @@
 #include <include/R/R_RInternals.h>
 
 #include <analysis/AnalysisResults.h>
+#include <analysis/DeadStoreInfoAnnotationMap.h>
+#include <analysis/Settings.h>
 #include <support/StringUtils.h>
 #include <CodeGenUtils.h>
+#include <CompileReport.h>
 
 using namespace std;
 
@@ -51,6 +54,17 @@ Expression SubexpBuffer::op_begin(SEXP exp, string rho,
     //    temp.encl_fn = this;
     ResultStatus rs = (next == R_NilValue) ? resultStatus : NoResultNeeded;
 
+    // A dead store whose value isn't the result of the sequence can
+    // be dropped entirely.
+    if (rs == NoResultNeeded &&
+	Settings::instance()->get_dead_store_elimination() &&
+	RAnnot::DeadStoreInfoAnnotationMap::instance()->is_valid(exp))
+    {
+      CompileReport::instance()->note_fast_path("dead_store");
+      exp = next;
+      continue;
+    }
+
     // To be safe, if the expression is a symbol (which might be bound
     // to a promise), evaluate at the end to force the promise.
     // TODO: This causes unnecessary calls to eval when the
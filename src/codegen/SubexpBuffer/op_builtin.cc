@@ -42,6 +42,7 @@
 
 #include <CodeGen.h>
 #include <CodeGenUtils.h>
+#include <CompileReport.h>
 #include <GetName.h>
 #include <Metrics.h>
 #include <ParseInfo.h>
@@ -88,6 +89,7 @@ Expression SubexpBuffer::op_builtin(SEXP cell, SEXP op, string rho,
 
   // special case for arithmetic operations
   if (PRIMFUN(op) == (CCODE)do_arith && Settings::instance()->get_special_case_arithmetic()) {
+    CompileReport::instance()->note_fast_path("special_case_arith");
 
     // R_unary if there's one argument and it's a non-object
     if (args != R_NilValue
@@ -157,6 +159,7 @@ Expression SubexpBuffer::op_builtin(SEXP cell, SEXP op, string rho,
     // special case for do_relop: call do_relop_dflt instead to avoid consing args
   } else if (PRIMFUN(op) == (CCODE)do_relop && Settings::instance()->get_special_case_arithmetic()) {
     if (!Rf_isObject(CAR(args)) && !Rf_isObject(CADR(args))) {
+      CompileReport::instance()->note_fast_path("special_case_relop");
       Protection xprot = Protected;
       if (is_constant_expr(CAR(args))) {
 	xprot = Unprotected;
@@ -48,6 +48,8 @@
 
 #include <CodeGen.h>
 #include <CodeGenUtils.h>
+#include <CompileReport.h>
+#include <ProfileTable.h>
 #include <Metrics.h>
 #include <Visibility.h>
 
@@ -74,13 +76,15 @@ static Expression op_arglist_rec(SubexpBuffer * const sb,
 				 const int n,
 				 int * const unprotcnt,
 				 string & laziness_string,
-				 const string rho);
+				 const string rho,
+				 const bool region);
 static Expression op_resolved_args(SubexpBuffer * sb,
 				   ResolvedArgs * resolved_args,
 				   ResolvedCallByValueInfo * cbv,
 				   string rho,
 				   int * unprotect,
-				   string & laziness_string);
+				   string & laziness_string,
+				   bool region);
 static Expression op_resolved_arg(SubexpBuffer * sb,
 				  ResolvedArgs * resolved_args,
 				  ResolvedCallByValueInfo * cbv,
@@ -89,7 +93,9 @@ static Expression op_resolved_arg(SubexpBuffer * sb,
 				  string & laziness_string,
 				  ResolvedArgs::const_reverse_iterator it,
 				  int i,
-				  Expression tail);
+				  Expression tail,
+				  bool region);
+static string cons_function(bool tagged, bool region);
 static Expression op_promise_args(SubexpBuffer * sb,
 				  string args1var,
 				  SEXP args,
@@ -115,14 +121,29 @@ Expression SubexpBuffer::op_clos_app(FuncInfo * fi_if_known,
   ResolvedArgs * args_annot;
   std::vector<EagerLazyT> lazy_info;
   bool args_resolved;
+  string region_mark;
+
+  // If neither the callee's environment nor the call's result
+  // escapes, the argument list (which becomes the environment's
+  // frame) can live in the region allocator until the call returns.
+  bool region = (Settings::instance()->get_region_alloc() &&
+		 fi_if_known != 0 &&
+		 !getProperty(CEscapeInfo, fi_if_known->get_sexp())->may_escape() &&
+		 !getProperty(OEscapeInfo, cell)->may_escape());
+  if (region) {
+    region_mark = new_var_unp();
+    append_decls("rcc_region_mark " + region_mark + ";\n");
+    append_defs(emit_assign(region_mark, emit_call0("rcc_region_save")));
+  }
 
   if (Settings::instance()->get_resolve_arguments() &&
       ResolvedArgsAnnotationMap::instance()->is_valid(cell)) {
     args_resolved = true;
+    CompileReport::instance()->note_fast_path("resolved_arguments");
     args_annot = getProperty(ResolvedArgs, cell);
     ResolvedCallByValueInfo * cbv = getProperty(ResolvedCallByValueInfo, cell);
     lazy_info = cbv->get_eager_lazy_info();
-    args1 = op_resolved_args(this, args_annot, cbv, rho, &unprotcnt, laziness_string);
+    args1 = op_resolved_args(this, args_annot, cbv, rho, &unprotcnt, laziness_string, region);
   } else {
     args_resolved = false;
     lazy_info = getProperty(CallByValueInfo, cell)->get_eager_lazy_info();
@@ -131,7 +152,7 @@ Expression SubexpBuffer::op_clos_app(FuncInfo * fi_if_known,
       args1 = op_list(args, rho, false, Protected);   // pass false to output compiled list
       laziness_string = "eager";
     } else {
-      args1 = op_arglist_rec(this, args, lazy_info, 0, &unprotcnt, laziness_string, rho);
+      args1 = op_arglist_rec(this, args, lazy_info, 0, &unprotcnt, laziness_string, rho, region);
     }
   }
 
@@ -144,11 +165,15 @@ Expression SubexpBuffer::op_clos_app(FuncInfo * fi_if_known,
     options = "AC_DEFAULT";
     if (safe_to_stack_alloc_env(e)) {
       options += " | AC_STACK_CLOSURE";
+      CompileReport::instance()->note_stack_closure_call(TYPEOF(CAR(e)) == SYMSXP ?
+							  var_name(CAR(e)) :
+							  "*anonymous*");
     }
   } else {
     options = "AC_RCC | AC_ENVIRONMENT | AC_USEMETHOD";
     if (!getProperty(CEscapeInfo, fi_if_known->get_sexp())->may_escape()) {
       options += " | AC_STACK_CLOSURE";
+      CompileReport::instance()->note_stack_closure_call(fi_if_known->get_c_name());
     }
   }
   if (!args_resolved) {
@@ -178,6 +203,21 @@ Expression SubexpBuffer::op_clos_app(FuncInfo * fi_if_known,
     append_defs(emit_assign(fallback, "getFallbackAlloc()"));
     append_defs(emit_call1("setFallbackAlloc","TRUE") + ";\n");
   }
+  string profile_entry, profile_start;
+  if (ProfileTable::instance()->sites()) {
+    string callee;
+    if (fi_if_known != 0) {
+      callee = ProfileTable::proc_name(fi_if_known);
+    } else if (TYPEOF(CAR(e)) == SYMSXP) {
+      callee = var_name(CAR(e));
+    } else {
+      callee = "*anonymous*";
+    }
+    profile_entry = ProfileTable::instance()->add("call", callee, ProfileTable::current_proc());
+    profile_start = new_var_unp();
+    append_decls(ProfileTable::emit_start_decl(profile_start));
+    append_defs(ProfileTable::emit_start(profile_entry, profile_start));
+  }
   // Unlike most R internal functions, applyClosure actually uses its
   // 'call' argument, so we can't just make it R_NilValue.
   string out = appl7(apply_closure_string,
@@ -190,12 +230,18 @@ Expression SubexpBuffer::op_clos_app(FuncInfo * fi_if_known,
 		     options,
 		     callee_sym,
 		     Unprotected);
+  if (!profile_entry.empty()) {
+    append_defs(ProfileTable::emit_stop(profile_entry, profile_start));
+  }
   if (may_escape) {
     append_defs(emit_call1("setFallbackAlloc", fallback) + ";\n");
   }
   if (!op1.del_text.empty()) unprotcnt++;
   if (!args1.del_text.empty()) unprotcnt++;
   append_defs("UNPROTECT(" + i_to_s(unprotcnt) + ");\n");
+  if (region) {
+    append_defs(emit_call1("rcc_region_restore", region_mark) + ";\n");
+  }
   string cleanup;
   if (resultProtection == Protected) {
     append_defs("SAFE_PROTECT(" + out + ");\n");
@@ -274,21 +320,22 @@ static Expression op_arglist_rec(SubexpBuffer * const sb,
 				 const int n,
 				 int * const unprotcnt,
 				 string & laziness_string,
-				 const string rho)
+				 const string rho,
+				 const bool region)
 {
   if (args == R_NilValue) {
     return Expression::nil_exp;
   }
 
-  Expression tail_exp = op_arglist_rec(sb, CDR(args), lazy_info, n+1, unprotcnt, laziness_string, rho);
+  Expression tail_exp = op_arglist_rec(sb, CDR(args), lazy_info, n+1, unprotcnt, laziness_string, rho, region);
   EagerLazyT eager_lazy = (lazy_info[n] == EAGER && Settings::instance()->get_strictness()) ? EAGER : LAZY;
   Expression head_exp = op_arg(sb, args, eager_lazy, rho);
   laziness_string = (eager_lazy == EAGER ? "E" : "L") + laziness_string;
   string out;
   if (TAG(args) == R_NilValue) {
-    out = sb->appl2("cons", "", head_exp.var, tail_exp.var);
+    out = sb->appl2(cons_function(false, region), "", head_exp.var, tail_exp.var);
   } else {
-    out = sb->appl3("tagged_cons", "", head_exp.var, make_symbol(TAG(args)), tail_exp.var);
+    out = sb->appl3(cons_function(true, region), "", head_exp.var, make_symbol(TAG(args)), tail_exp.var);
   }
   if (!head_exp.del_text.empty()) (*unprotcnt)++;
   if (!tail_exp.del_text.empty()) (*unprotcnt)++;
@@ -321,7 +368,8 @@ static Expression op_resolved_args(SubexpBuffer * sb,
 				   ResolvedCallByValueInfo * cbv,
 				   string rho,
 				   int * unprotcnt,
-				   string & laziness_string)
+				   string & laziness_string,
+				   bool region)
 {
   int i = resolved_args->size() - 1;
   string out;
@@ -330,7 +378,7 @@ static Expression op_resolved_args(SubexpBuffer * sb,
        it != resolved_args->rend();
        it++)
     {
-      tail = op_resolved_arg(sb, resolved_args, cbv, rho, unprotcnt, laziness_string, it, i, tail);
+      tail = op_resolved_arg(sb, resolved_args, cbv, rho, unprotcnt, laziness_string, it, i, tail, region);
       i--;
     }
   return tail;
@@ -344,23 +392,34 @@ static Expression op_resolved_arg(SubexpBuffer * sb,
 				  string & laziness_string,
 				  ResolvedArgs::const_reverse_iterator it,
 				  int i,
-				  Expression tail)
+				  Expression tail,
+				  bool region)
 {
   string out;
   Expression arg;
   laziness_string = (cbv->get_eager_lazy(i) == EAGER ? "E" : "L") + laziness_string;
   if (it->source == ResolvedArgs::RESOLVED_DEFAULT) {
     arg = sb->op_literal(CAR(it->cell), rho);
-    out = sb->appl3("tagged_cons", "", arg.var, make_symbol(TAG(it->formal)), tail.var);
+    out = sb->appl3(cons_function(true, region), "", arg.var, make_symbol(TAG(it->formal)), tail.var);
   } else {
     arg = op_arg(sb, it->cell, cbv->get_eager_lazy(i), rho);
     if (TAG(it->cell) == R_NilValue) {
-      out = sb->appl2("cons", "", arg.var, tail.var);
+      out = sb->appl2(cons_function(false, region), "", arg.var, tail.var);
     } else {
-      out = sb->appl3("tagged_cons", "", arg.var, make_symbol(TAG(it->cell)), tail.var);
+      out = sb->appl3(cons_function(true, region), "", arg.var, make_symbol(TAG(it->cell)), tail.var);
     }
   }
   if (!arg.del_text.empty()) (*unprotcnt)++;
   if (!tail.del_text.empty()) (*unprotcnt)++;
   return Expression(out, DEPENDENT, INVISIBLE, unp(out));
 }
+
+/// Name of the runtime function that conses an argument cell, either
+/// on the GC heap or in the current activation's region.
+static string cons_function(bool tagged, bool region) {
+  if (region) {
+    return (tagged ? "rcc_region_tagged_cons" : "rcc_region_cons");
+  } else {
+    return (tagged ? "tagged_cons" : "cons");
+  }
+}
@@ -34,6 +34,7 @@
 #include <analysis/Utils.h>
 #include <support/StringUtils.h>
 #include <CodeGen.h>
+#include <LazyConstants.h>
 #include <ParseInfo.h>
 #include <Dependence.h>
 #include <Visibility.h>
@@ -48,14 +49,16 @@ Expression SubexpBuffer::op_closure(SEXP e, string rho, Protection resultProtect
       formals.dependence == CONST &&
       body.dependence == CONST)
   {
-    string v = ParseInfo::global_constants->appl3("mkCLOSXP",
-						  to_string(e),
-						  formals.var,
-						  body.var,
-						  rho,
-						  resultProtection);
-    ParseInfo::global_constants->del(formals);
-    ParseInfo::global_constants->del(body);
+    SubexpBuffer * constants = LazyConstants::instance()->buffer();
+    string v = constants->appl3("mkCLOSXP",
+				to_string(e),
+				formals.var,
+				body.var,
+				rho,
+				resultProtection);
+    LazyConstants::instance()->keep(v);
+    constants->del(formals);
+    constants->del(body);
     return Expression(v, CONST, INVISIBLE, "");
   } else {
     string v = appl3("mkCLOSXP",
@@ -0,0 +1,298 @@
+// -*- Mode: C++ -*-
+//
+// Copyright (c) 2009 Rice University
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation; either version 2 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA 
+
+// File: op_condition.cc
+//
+// Output conditions of if and while, and && and || anywhere, as C
+// truth values.
+//
+// A condition that is a comparison, or a combination of comparisons
+// and other values with &&, || and !, never needs a logical vector.
+// Each comparison of two numeric scalars is done in C on their
+// values, && and || short-circuit in C, and the result is tested
+// directly. Operands known at compile time become C constants and
+// are not checked; the others are checked at run time, and
+// comparisons of anything but numeric scalars fall back to
+// do_relop_dflt. Other operands of && and || are read directly if
+// they are logical and converted with asLogical otherwise. NA is
+// tested for only if an operand may be NA. An && or || outside a
+// condition is boxed only if its value is used.
+//
+// Author: John Garvin (garvin@cs.rice.edu)
+
+#include <string>
+
+#include <codegen/SubexpBuffer/SubexpBuffer.h>
+
+#include <include/R/R_RInternals.h>
+
+#include <analysis/AnalysisResults.h>
+#include <analysis/ConstantInfo.h>
+#include <analysis/ConstantInfoAnnotationMap.h>
+#include <analysis/Settings.h>
+#include <analysis/Utils.h>
+#include <analysis/VarBinding.h>
+
+#include <support/StringUtils.h>
+
+#include <CodeGenUtils.h>
+#include <CompileReport.h>
+#include <ParseInfo.h>
+
+using namespace std;
+using namespace RAnnot;
+
+extern bool is_constant_expr(SEXP s);
+
+static bool is_native_condition(SEXP e);
+static bool is_library_call(SEXP e, const char * name, int n_args);
+static bool is_comparison(SEXP e);
+static bool constant_operand(SEXP cell, double * value);
+static string op_truth(SubexpBuffer * sb, SEXP cell, string rho, bool * may_be_na);
+static string op_comparison(SubexpBuffer * sb, SEXP e, string rho, bool * may_be_na);
+
+/// If the condition in cond_c is a comparison, or a combination of
+/// comparisons and other values with &&, || and !, output code to
+/// compute it and
+/// return the name of a C int that is nonzero if the condition holds.
+/// A condition that is NA raises the same error as my_asLogicalNoNA.
+/// Otherwise output nothing and return the empty string.
+string SubexpBuffer::op_native_condition(SEXP cond_c, string rho) {
+  if (!Settings::instance()->get_native_conditions() ||
+      !is_native_condition(CAR(cond_c)))
+  {
+    return "";
+  }
+  CompileReport::instance()->note_fast_path("native_condition");
+  bool may_be_na;
+  string truth = op_truth(this, cond_c, rho, &may_be_na);
+  if (may_be_na) {
+    append_defs("if (" + truth + " == NA_LOGICAL) rcc_condition_na();\n");
+  }
+  return truth;
+}
+
+/// Output && or || as a logical vector if its value is used, and
+/// only for its effects otherwise.
+Expression SubexpBuffer::op_andor(SEXP cell, string rho,
+				  Protection resultProtection,
+				  ResultStatus resultStatus)
+{
+  CompileReport::instance()->note_fast_path("native_andor");
+  bool may_be_na;
+  string truth = op_truth(this, cell, rho, &may_be_na);
+  if (resultStatus != ResultNeeded) {
+    return Expression::nil_exp;
+  }
+  string out = appl1("ScalarLogical", "", truth, resultProtection);
+  string cleanup;
+  if (resultProtection == Protected) cleanup = unp(out);
+  return Expression(out, DEPENDENT, VISIBLE, cleanup);
+}
+
+static bool is_native_condition(SEXP e) {
+  if (is_paren_exp(e)) {
+    return is_native_condition(CAR(paren_body_c(e)));
+  } else if (is_library_call(e, "!", 1)) {
+    return is_native_condition(CAR(call_args(e)));
+  } else if (SubexpBuffer::is_native_andor(e)) {
+    return true;  // each operand is either native or converted
+  } else {
+    return is_comparison(e);
+  }
+}
+
+bool SubexpBuffer::is_native_andor(SEXP e) {
+  return is_library_call(e, "&&", 2) || is_library_call(e, "||", 2);
+}
+
+/// Whether e calls the library function of the given name, not
+/// redefined, with n_args untagged arguments.
+static bool is_library_call(SEXP e, const char * name, int n_args) {
+  if (!is_call(e) || !is_var(call_lhs(e)) || call_lhs(e) != Rf_install(name) ||
+      Rf_length(call_args(e)) != n_args ||
+      !is_library(call_lhs(e)) || !getProperty(VarBinding, e)->is_internal())
+  {
+    return false;
+  }
+  for (SEXP arg = call_args(e); arg != R_NilValue; arg = CDR(arg)) {
+    if (TAG(arg) != R_NilValue) return false;
+  }
+  return true;
+}
+
+static bool is_comparison(SEXP e) {
+  static const char * const relops[] = { "==", "!=", "<", ">", "<=", ">=", 0 };
+  for (const char * const * op = relops; *op != 0; op++) {
+    if (is_library_call(e, *op, 2)) return true;
+  }
+  return false;
+}
+
+/// If the operand in cell is known at compile time to be a numeric
+/// scalar other than NA, set value to it and return true.
+static bool constant_operand(SEXP cell, double * value) {
+  SEXP x = CAR(cell);
+  if (!is_const(x)) {
+    if (!Settings::instance()->get_constant_folding() ||
+	!ConstantInfoAnnotationMap::instance()->is_valid(cell))
+    {
+      return false;
+    }
+    x = getProperty(ConstantInfo, cell)->get_value();
+  }
+  if (Rf_length(x) != 1 || ATTRIB(x) != R_NilValue) {
+    return false;
+  }
+  switch(TYPEOF(x)) {
+  case LGLSXP:
+  case INTSXP:
+    if (INTEGER(x)[0] == NA_INTEGER) return false;
+    *value = INTEGER(x)[0];
+    return true;
+  case REALSXP:
+    if (ISNAN(REAL(x)[0])) return false;
+    *value = REAL(x)[0];
+    return true;
+  default:
+    return false;
+  }
+}
+
+/// Output the condition in cell as a C int holding TRUE, FALSE or
+/// NA_LOGICAL, and return the int's name. Sets may_be_na if the
+/// result may be NA.
+static string op_truth(SubexpBuffer * sb, SEXP cell, string rho, bool * may_be_na) {
+  SEXP e = CAR(cell);
+  if (is_paren_exp(e)) {
+    return op_truth(sb, paren_body_c(e), rho, may_be_na);
+  }
+  if (is_library_call(e, "!", 1) && is_native_condition(CAR(call_args(e)))) {
+    string x = op_truth(sb, call_args(e), rho, may_be_na);
+    if (*may_be_na) {
+      sb->append_defs(emit_assign(x, "(" + x + " == NA_LOGICAL ? NA_LOGICAL : !" + x + ")"));
+    } else {
+      sb->append_defs(emit_assign(x, "!" + x));
+    }
+    return x;
+  }
+  if (SubexpBuffer::is_native_andor(e)) {
+    bool is_and = (call_lhs(e) == Rf_install("&&"));
+    // the right operand is evaluated only if the left one does not
+    // decide the result
+    string decides = (is_and ? "FALSE" : "TRUE");
+    string other = (is_and ? "TRUE" : "FALSE");
+    bool left_na, right_na;
+    string x = op_truth(sb, call_args(e), rho, &left_na);
+    SubexpBuffer right_se;
+    string y = op_truth(&right_se, CDR(call_args(e)), rho, &right_na);
+    if (left_na || right_na) {
+      right_se.append_defs(emit_assign(x, "(" + y + " == " + decides + " ? " + decides + " : " +
+				       "(" + x + " == NA_LOGICAL || " + y + " == NA_LOGICAL) ? " +
+				       "NA_LOGICAL : " + other + ")"));
+    } else {
+      right_se.append_defs(emit_assign(x, y));
+    }
+    sb->append_defs("if (" + x + " != " + decides + ") {\n");
+    sb->append_defs(indent(right_se.output_decls()));
+    sb->append_defs(indent(right_se.output_defs()));
+    sb->append_defs("}\n");
+    *may_be_na = (left_na || right_na);
+    return x;
+  }
+  if (is_comparison(e)) {
+    return op_comparison(sb, e, rho, may_be_na);
+  }
+
+  // any other value: the first element as a logical, as && does
+  Expression x = sb->op_exp(cell, rho, Unprotected, true);
+  string truth = sb->new_var_unp();
+  sb->append_decls("int " + truth + ";\n");
+  sb->append_defs(emit_assign(truth, emit_call1("RCC_AS_TRUTH", x.var)));
+  sb->del(x);
+  *may_be_na = true;
+  return truth;
+}
+
+/// Output a comparison. If both operands are numeric scalars, compare
+/// their values in C; otherwise call rcc_relop_cond.
+static string op_comparison(SubexpBuffer * sb, SEXP e, string rho, bool * may_be_na) {
+  SEXP args = call_args(e);
+  string c_op = var_name(call_lhs(e));  // R's comparison operators are C's
+  string truth = sb->new_var_unp();
+  sb->append_decls("int " + truth + ";\n");
+
+  double x_value, y_value;
+  bool x_known = constant_operand(args, &x_value);
+  bool y_known = constant_operand(CDR(args), &y_value);
+  if (x_known && y_known) {
+    *may_be_na = false;
+    sb->append_defs(emit_assign(truth, "(" + d_to_s(x_value) + " " + c_op + " " +
+				d_to_s(y_value) + ")"));
+    return truth;
+  }
+
+  Protection xprot = Protected;
+  if (is_constant_expr(CAR(args))) {
+    xprot = Unprotected;
+  }
+  Expression x = sb->op_exp(args, rho, xprot, true);
+  Expression y = sb->op_exp(CDR(args), rho, Unprotected, true);
+
+  // numeric scalars: compare in C, reading the values of the
+  // operands not known at compile time
+  string guard, nan_test, x_num, y_num;
+  if (x_known) {
+    x_num = d_to_s(x_value);
+  } else {
+    x_num = sb->new_var_unp();
+    sb->append_decls("double " + x_num + ";\n");
+    guard = "RCC_IS_SCALAR_NUM(" + x.var + ")";
+    nan_test = "ISNAN(" + x_num + ")";
+  }
+  if (y_known) {
+    y_num = d_to_s(y_value);
+  } else {
+    y_num = sb->new_var_unp();
+    sb->append_decls("double " + y_num + ";\n");
+    guard += (guard.empty() ? "" : " && ");
+    guard += "RCC_IS_SCALAR_NUM(" + y.var + ")";
+    nan_test += (nan_test.empty() ? "" : " || ");
+    nan_test += "ISNAN(" + y_num + ")";
+  }
+  sb->append_defs("if (" + guard + ") {\n");
+  if (!x_known) {
+    sb->append_defs(indent(emit_assign(x_num, "RCC_SCALAR_NUM(" + x.var + ")")));
+  }
+  if (!y_known) {
+    sb->append_defs(indent(emit_assign(y_num, "RCC_SCALAR_NUM(" + y.var + ")")));
+  }
+  sb->append_defs(indent(emit_assign(truth, "(" + nan_test + ") ? NA_LOGICAL : (" +
+				     x_num + " " + c_op + " " + y_num + ")")));
+  sb->append_defs("} else {\n");
+
+  // anything else goes through the general comparison
+  Expression op1 = ParseInfo::global_constants->op_primsxp(library_value(call_lhs(e)), rho);
+  sb->append_defs(indent(emit_assign(truth, emit_call3("rcc_relop_cond", op1.var, x.var, y.var))));
+  sb->append_defs("}\n");
+  sb->del(x);
+  sb->del(y);
+  sb->del(op1);
+  *may_be_na = true;
+  return truth;
+}
@@ -31,6 +31,9 @@
 #include <include/R/R_RInternals.h>
 
 #include <analysis/AnalysisResults.h>
+#include <analysis/ConstantInfo.h>
+#include <analysis/ConstantInfoAnnotationMap.h>
+#include <analysis/Settings.h>
 #include <analysis/Utils.h>
 #include <support/StringUtils.h>
 #include <support/RccError.h>
@@ -55,6 +58,14 @@ Expression SubexpBuffer::op_exp(SEXP cell, string rho, Protection
   assert(is_cons(cell));
   SEXP e = CAR(cell);
 
+  // variable uses and calls that constant propagation folded
+  if (Settings::instance()->get_constant_folding() &&
+      (TYPEOF(e) == SYMSXP || TYPEOF(e) == LANGSXP) &&
+      RAnnot::ConstantInfoAnnotationMap::instance()->is_valid(cell))
+  {
+    return op_literal(getProperty(RAnnot::ConstantInfo, cell)->get_value(), rho);
+  }
+
   Expression out, formals, body, env;
   switch(TYPEOF(e)) {
   case NILSXP:
@@ -20,6 +20,14 @@
 //
 // Output a for loop.
 //
+// The index normally gets a fresh vector for each element of an
+// atomic range. If the body only reads the index (see
+// loop_value_is_reusable), one vector is bound once and overwritten
+// in place, so the loop allocates nothing per element. The switch on
+// the range type stays in the loop, but it tests a loop-invariant
+// local, so the C compiler can unswitch it without rcc emitting the
+// body once per type.
+//
 // Author: John Garvin (garvin@cs.rice.edu)
 
 #include <string>
@@ -30,10 +38,13 @@
 #include <support/StringUtils.h>
 #include <support/RccError.h>
 #include <analysis/AnalysisResults.h>
+#include <analysis/LoopSubscripts.h>
+#include <analysis/Settings.h>
 #include <analysis/Utils.h>
 
 #include <LoopContext.h>
 #include <ParseInfo.h>
+#include <ProfileTable.h>
 #include <Visibility.h>
 #include <CodeGenUtils.h>
 
@@ -73,40 +84,55 @@ Expression SubexpBuffer::op_for(SEXP e, string rho,
     defs += "PROTECT_WITH_INDEX(ans, &api);\n";
   }
   defs += "rangetype = TYPEOF(" + range.var + ");\n";
+  bool reuse = (Settings::instance()->get_loop_box_reuse() && loop_value_is_reusable(e));
+  string symbol = make_symbol(sym);
+  if (reuse) {
+    // v already has the range's type; bind it once
+    defs += "if (n > 0 && v != R_NilValue && !isVectorList(" + range.var + ")) {\n";
+    defs += indent("setVar(" + symbol + ", v, " + rho + ");\n");
+    defs += "}\n";
+  }
+  string profile_entry, profile_start;
+  if (ProfileTable::instance()->sites()) {
+    profile_entry = ProfileTable::instance()->add_loop("for");
+    profile_start = new_var_unp();
+    ProfileTable::instance()->push_timer(profile_entry, profile_start);
+    append_decls(ProfileTable::emit_start_decl(profile_start));
+    defs += ProfileTable::emit_clock(profile_start);
+  }
   defs += "for (i=0; i < n; i++) {\n";
   string in_loop;
+  if (!profile_entry.empty()) {
+    in_loop += ProfileTable::emit_count(profile_entry);
+  }
   in_loop += "switch(rangetype) {\n";
-  in_loop += "case LGLSXP:\n";
-  in_loop += indent("REPROTECT(v = allocVector(LGLSXP, 1), vpi);\n");
-  in_loop += indent("LOGICAL(v)[0] = LOGICAL(" + range.var + ")[i];\n");
-  in_loop += indent("setVar(" + make_symbol(sym) + ", v, " + rho + ");\n");
-  in_loop += indent("break;\n");
-  in_loop += "case INTSXP:\n";
-  in_loop += indent("REPROTECT(v = allocVector(INTSXP, 1), vpi);\n");
-  in_loop += indent("INTEGER(v)[0] = INTEGER(" + range.var + ")[i];\n");
-  in_loop += indent("setVar(" + make_symbol(sym) + ", v, " + rho + ");\n");
-  in_loop += indent("break;\n");
-  in_loop += "case REALSXP:\n";
-  in_loop += indent("REPROTECT(v = allocVector(REALSXP, 1), vpi);\n");
-  in_loop += indent("REAL(v)[0] = REAL(" + range.var + ")[i];\n");
-  in_loop += indent("setVar(" + make_symbol(sym) + ", v, " + rho + ");\n");
-  in_loop += indent("break;\n");
-  in_loop += "case CPLXSXP:\n";
-  in_loop += indent("REPROTECT(v = allocVector(CPLXSXP, 1), vpi);\n");
-  in_loop += indent("COMPLEX(v)[0] = COMPLEX(" + range.var + ")[i];\n");
-  in_loop += indent("setVar(" + make_symbol(sym) + ", v, " + rho + ");\n");
-  in_loop += indent("break;\n");
-  in_loop += "case STRSXP:\n";
-  in_loop += indent("REPROTECT(v = allocVector(STRSXP, 1), vpi);\n");
-  in_loop += indent("SET_STRING_ELT(v, 0, STRING_ELT(" + range.var + ", i));\n");
-  in_loop += indent("setVar(" + make_symbol(sym) + ", v, " + rho + ");\n");
-  in_loop += indent("break;\n");
+  static const struct { const char * type, * access; } atomic[] = {
+    { "LGLSXP", "LOGICAL(v)[0] = LOGICAL(%r)[i]" },
+    { "INTSXP", "INTEGER(v)[0] = INTEGER(%r)[i]" },
+    { "REALSXP", "REAL(v)[0] = REAL(%r)[i]" },
+    { "CPLXSXP", "COMPLEX(v)[0] = COMPLEX(%r)[i]" },
+    { "STRSXP", "SET_STRING_ELT(v, 0, STRING_ELT(%r, i))" },
+    { 0, 0 } };
+  for (int t = 0; atomic[t].type != 0; t++) {
+    string access = atomic[t].access;
+    access.replace(access.find("%r"), 2, range.var);
+    string type = atomic[t].type;
+    in_loop += "case " + type + ":\n";
+    if (!reuse) {
+      in_loop += indent("REPROTECT(v = allocVector(" + type + ", 1), vpi);\n");
+    }
+    in_loop += indent(access + ";\n");
+    if (!reuse) {
+      in_loop += indent("setVar(" + symbol + ", v, " + rho + ");\n");
+    }
+    in_loop += indent("break;\n");
+  }
   in_loop += "case EXPRSXP:\n";
   in_loop += "case VECSXP:\n";
-  in_loop += indent("setVar(" + make_symbol(sym) + ", VECTOR_ELT(" + range.var + ", i), " + rho + ");\n");
+  in_loop += indent("setVar(" + symbol + ", VECTOR_ELT(" + range.var + ", i), " + rho + ");\n");
   in_loop += indent("break;\n");
   in_loop += "case LISTSXP:\n";
-  in_loop += indent("setVar(" + make_symbol(sym) + ", CAR(" + range.var + "), " + rho + ");\n");
+  in_loop += indent("setVar(" + symbol + ", CAR(" + range.var + "), " + rho + ");\n");
   in_loop += indent(range.var + " = CDR(" + range.var + ");\n");
   in_loop += indent("break;\n");
   in_loop += "default: errorcall(R_NilValue, \"Bad for loop sequence\");\n";
@@ -121,6 +147,10 @@ Expression SubexpBuffer::op_for(SEXP e, string rho,
   }
   append_defs("}\n");
   append_defs(thisLoop.breakLabel() + ":\n");
+  if (!profile_entry.empty()) {
+    ProfileTable::instance()->pop_timer();
+    append_defs(ProfileTable::emit_stop(profile_entry, profile_start));
+  }
   if (resultStatus == ResultNeeded) {
     append_defs(emit_unprotect("ans"));
   }
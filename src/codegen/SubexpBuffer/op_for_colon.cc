@@ -47,11 +47,16 @@
 // Author: John Garvin (garvin@cs.rice.edu)
 
 
+#include <map>
 #include <string>
 
+#include <CheckProtect.h>
 #include <CodeGenUtils.h>
 #include <LoopContext.h>
+#include <ProfileTable.h>
 
+#include <analysis/LoopSubscripts.h>
+#include <analysis/Settings.h>
 #include <analysis/Utils.h>
 
 #include <codegen/SubexpBuffer/SubexpBuffer.h>
@@ -60,6 +65,10 @@
 
 using namespace std;
 
+static bool contains_break(SEXP e);
+static string hoist_subscript_guards(SubexpBuffer * sb, SEXP e, string rho,
+				     LoopContext & loop, string & iv, string & range_ok);
+
 Expression SubexpBuffer::op_for_colon(SEXP e, string rho,
 				      ResultStatus resultStatus)
 {
@@ -90,22 +99,129 @@ Expression SubexpBuffer::op_for_colon(SEXP e, string rho,
 			emit_call1("REAL", rev) + "[0]");
   header += emit_assign("count_up", "(begin <= end)");
   header += "step = (count_up ? 1.0 : -1.0);\n";
+  string iv, range_ok;
+  if (Settings::instance()->get_bounds_check_elimination()) {
+    header += hoist_subscript_guards(this, e, rho, this_loop, iv, range_ok);
+  }
+  string profile_entry, profile_start;
+  if (ProfileTable::instance()->sites()) {
+    profile_entry = ProfileTable::instance()->add_loop("for");
+    profile_start = new_var_unp();
+    ProfileTable::instance()->push_timer(profile_entry, profile_start);
+    append_decls(ProfileTable::emit_start_decl(profile_start));
+    header += ProfileTable::emit_clock(profile_start);
+  }
   header += "for (di = begin; (count_up ? (di < end + FLT_EPSILON) : (di > end - FLT_EPSILON)); di += step) {\n";
   append_defs(header);
   SubexpBuffer for_body;
+  if (!profile_entry.empty()) {
+    for_body.append_defs(ProfileTable::emit_count(profile_entry));
+  }
   for_body.append_defs("REAL(v)[0] = di;\n");
   for_body.append_defs(emit_call3("setVar", make_symbol(CAR(sym_c)), "v", rho) + ";\n");
+  if (!iv.empty()) {
+    for_body.append_defs(emit_logical_if_stmt(range_ok, emit_assign(iv, "(int)di")));
+  }
   Expression ans = for_body.op_exp(for_body_c(e), rho, Unprotected, false, resultStatus);
   append_decls(indent(for_body.output_decls()));
   append_defs(indent(for_body.output_defs()));
   append_defs("}\n");
   append_defs(this_loop.breakLabel() + ":;\n");
-  del(range_begin);
-  del(range_end);
-  append_defs(emit_call1("UNPROTECT_PTR", "v") + ";\n");
+  if (!profile_entry.empty()) {
+    ProfileTable::instance()->pop_timer();
+    append_defs(ProfileTable::emit_stop(profile_entry, profile_start));
+  }
+  if (Settings::instance()->get_protect_elision() &&
+      !contains_break(for_body_c(e)))
+  {
+    // Each iteration leaves the protect stack as it found it, so v
+    // is still on top. A break or next can leave the stack unbalanced.
+#ifdef CHECK_PROTECT
+    append_defs("assert(R_PPStack[R_PPStackTop - 1] == v);\n");
+#endif
+    append_defs("UNPROTECT(1);\n");
+    del(range_begin);
+    del(range_end);
+  } else {
+    del(range_begin);
+    del(range_end);
+    append_defs(emit_call1("UNPROTECT_PTR", "v") + ";\n");
+  }
   return Expression(ans.var, DEPENDENT, INVISIBLE, "");
 }
 
+/// Emit the checks that let subscripts of the loop index skip their
+/// bounds and type checks, and register each such subscript with the
+/// loop. The checks run once, before the loop. A subscript whose
+/// array is not assigned in the loop is fully checked here: the array
+/// is fetched from the frame (without forcing a promise) and its
+/// type, attributes and length are tested against the index range.
+/// For an array assigned in the loop only the lower bound can be
+/// checked here; the access checks the rest. Sets iv to a C variable
+/// that will hold the index as an int whenever range_ok holds.
+static string hoist_subscript_guards(SubexpBuffer * sb, SEXP e, string rho,
+				     LoopContext & loop, string & iv, string & range_ok)
+{
+  LoopSubscriptList subscripts;
+  find_loop_subscripts(e, subscripts);
+  if (subscripts.empty()) {
+    return "";
+  }
+  string code;
+  iv = sb->new_var_unp_name("iv");
+  range_ok = sb->new_var_unp();
+  sb->append_decls("int " + iv + ";\n");
+  sb->append_decls("Rboolean " + range_ok + ";\n");
+  code += emit_assign(range_ok,
+		      "!ISNAN(begin) && !ISNAN(end) && begin == floor(begin) && "
+		      "fabs(begin) < INT_MAX && fabs(end) < INT_MAX");
+  string lo = "(count_up ? begin : end)";
+  string hi = "(count_up ? end : begin)";
+
+  map<SEXP, string> arrays;
+  map<pair<SEXP, int>, string> guards;
+  LoopSubscriptList::const_iterator it;
+  for (it = subscripts.begin(); it != subscripts.end(); ++it) {
+    LoopContext::DirectSubscript ds;
+    string c = i_to_s(it->offset);
+    pair<SEXP, int> key = make_pair((it->hoistable ? it->array : R_NilValue), it->offset);
+    if (it->hoistable && arrays.find(it->array) == arrays.end()) {
+      string x = sb->new_sexp_unp();
+      code += emit_assign(x, emit_call2("rcc_plain_vector_in_frame", make_symbol(it->array), rho));
+      arrays[it->array] = x;
+    }
+    if (guards.find(key) == guards.end()) {
+      string guard = sb->new_var_unp();
+      sb->append_decls("Rboolean " + guard + ";\n");
+      string cond = range_ok + " && " + lo + " + " + c + " >= 1";
+      if (it->hoistable) {
+	string x = arrays[it->array];
+	cond += " && " + x + " != R_NilValue && " + hi + " + " + c + " <= LENGTH(" + x + ")";
+      }
+      code += emit_assign(guard, cond);
+      guards[key] = guard;
+    }
+    ds.guard = guards[key];
+    ds.index = "(" + iv + " + " + i_to_s(it->offset - 1) + ")";
+    if (it->hoistable) {
+      ds.array = arrays[it->array];
+    }
+    loop.addDirectSubscript(it->expr, ds);
+  }
+  return code;
+}
+
+/// Whether e contains a break or next anywhere inside it.
+static bool contains_break(SEXP e) {
+  if (is_break(e) || is_next(e)) return true;
+  if (TYPEOF(e) == LANGSXP || TYPEOF(e) == LISTSXP) {
+    for(SEXP x = e; x != R_NilValue; x = CDR(x)) {
+      if (contains_break(CAR(x))) return true;
+    }
+  }
+  return false;
+}
+
 #if 0
 
 [ op_var_def(sym_c, "R_NilValue") -> sym ]
@@ -43,8 +43,13 @@
 #include <support/RccError.h>
 
 #include <CodeGenUtils.h>
+#include <CompileReport.h>
+#include <LazyConstants.h>
 #include <Metrics.h>
 #include <ParseInfo.h>
+#include <ProfileData.h>
+#include <ProfileTable.h>
+#include <ProtectPlanner.h>
 #include <Visibility.h>
 
 using namespace std;
@@ -109,11 +114,16 @@ string make_fundef(SubexpBuffer * this_buf, string func_name, SEXP fndef) {
   SubexpBuffer out_subexps;
   SubexpBuffer env_subexps;
 
-  string strictness = comment("strictness: " + output_strictness(args));  // string of S and N: whether each formal is strict
+  string strictness_str = output_strictness(args);  // string of S and N: whether each formal is strict
+  string strictness = comment("strictness: " + strictness_str);
+  CompileReport::instance()->set_strictness(func_name, strictness_str);
 
   // whether to use escape analysis to stack allocate objects
   bool stack_alloc_obj = Settings::instance()->get_stack_alloc_obj();
 
+  // whether this activation has a region for non-escaping objects
+  bool region_alloc = Settings::instance()->get_region_alloc();
+
   header = "SEXP " + func_name + "(";
   header += "SEXP args, SEXP newenv)";
   ParseInfo::global_fundefs->decls += header + ";\n";
@@ -124,6 +134,18 @@ string make_fundef(SubexpBuffer * this_buf, string func_name, SEXP fndef) {
   f += indent("SEXP out;\n");
 
   FuncInfo * fi = lexicalContext.Top();
+  string r_name = ProfileTable::proc_name(fi);
+  ProfileData::instance()->note_proc(func_name, r_name);
+  ProfileTable * profile = ProfileTable::instance();
+  string profile_entry;
+  if (profile->functions()) {
+    profile_entry = profile->add("function", r_name);
+    f += indent(ProfileTable::emit_start_decl("profile_start"));
+  }
+  if (CompileReport::instance()->enabled() && ParseInfo::analysis_ok()) {
+    bool may_escape = getProperty(CEscapeInfo, fi->get_sexp())->may_escape();
+    CompileReport::instance()->set_closure_may_escape(func_name, may_escape);
+  }
   
   if (fi->requires_context()) {
     f += indent("RCNTXT context;\n");
@@ -131,6 +153,9 @@ string make_fundef(SubexpBuffer * this_buf, string func_name, SEXP fndef) {
   if (stack_alloc_obj) {
     f += indent("SEXP stack;\n");
   }
+  if (region_alloc) {
+    f += indent("rcc_region_mark region;\n");
+  }
 
   string actuals = "args";
   env_subexps.output_ip();
@@ -138,6 +163,21 @@ string make_fundef(SubexpBuffer * this_buf, string func_name, SEXP fndef) {
   f += indent(env_subexps.output_decls());
   f += indent(env_subexps.output_defs());
 
+  // constants owned by this procedure are built on its first entry,
+  // if asked for or if the procedure never ran in the profile
+  string::size_type lazy_init_pos = f.size();
+  bool lazy = (Settings::instance()->get_lazy_constants() ||
+	       ProfileData::instance()->is_cold(r_name));
+  LazyConstants::instance()->enter(func_name, lazy);
+
+  if (region_alloc) {
+    f += indent(emit_call1("rcc_region_enter", "&region") + ";\n");
+  }
+
+  if (!profile_entry.empty()) {
+    f += indent(ProfileTable::emit_start(profile_entry, "profile_start"));
+  }
+
   if (fi->requires_context()) {
     f += indent("if (SETJMP(context.cjmpbuf)) {\n");
     f += indent(indent("PROTECT(out = R_ReturnedValue);\n"));
@@ -172,10 +212,12 @@ now performed in applyClosureOpt
   }
 #endif
 
-  // emit the function body
+  // emit the function body; a return() in it stops the timers too
+  ProfileTable::instance()->enter_proc(profile_entry, "profile_start");
   Expression outblock = out_subexps.op_exp(fundef_body_c(fndef),
 					   "newenv", Unprotected, true, 
 					   ResultNeeded);
+  ProfileTable::instance()->leave_proc();
   f += indent(indent("{\n"));
   f += indent(indent(indent(arg_location_decls)));
   f += indent(indent(indent(arg_location_defs)));
@@ -183,6 +225,7 @@ now performed in applyClosureOpt
 			    Visibility::emit_set(outblock.visibility))));
   f += indent(indent(indent("out = " + outblock.var + ";\n")));
   f += indent(indent("}\n"));
+  f.insert(lazy_init_pos, indent(LazyConstants::instance()->leave()));
 
 #if 0
 now performed in applyClosureOpt
@@ -196,11 +239,26 @@ now performed in applyClosureOpt
     f += indent("endcontext(&context);\n");
   }
 
+  if (region_alloc) {
+    f += indent(emit_call1("rcc_region_leave", "&region") + ";\n");
+  }
+
+  if (!profile_entry.empty()) {
+    f += indent(ProfileTable::emit_stop(profile_entry, "profile_start"));
+  }
+
+  if (Settings::instance()->get_alloc_stats()) {
+    f += indent(emit_call1("rcc_stats_escape", "RCC_ESCAPE_RETURN") + ";\n");
+  }
+
 #ifdef CHECK_PROTECT
   f += indent("assert(topval == R_PPStackTop);\n");
 #endif
   f += indent("return out;\n");
   f += "}\n";
+  if (Settings::instance()->get_protect_elision()) {
+    f = plan_protection(f);
+  }
   return f;
 }
 
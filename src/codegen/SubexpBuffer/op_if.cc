@@ -30,6 +30,9 @@
 #include <include/R/R_RInternals.h>
 
 #include <analysis/AnalysisResults.h>
+#include <analysis/ConstantInfo.h>
+#include <analysis/ConstantInfoAnnotationMap.h>
+#include <analysis/Settings.h>
 #include <analysis/Utils.h>
 #include <support/StringUtils.h>
 #include <support/RccError.h>
@@ -37,9 +40,49 @@
 
 using namespace std;
 
+/// If the condition is known at compile time to be TRUE or FALSE,
+/// return 1 or 0 respectively; otherwise return -1.
+static int constant_condition(SEXP cond_c) {
+  SEXP value = CAR(cond_c);
+  if (!is_const(value)) {
+    if (!RAnnot::ConstantInfoAnnotationMap::instance()->is_valid(cond_c)) {
+      return -1;
+    }
+    value = getProperty(RAnnot::ConstantInfo, cond_c)->get_value();
+  }
+  if (Rf_length(value) != 1 || ATTRIB(value) != R_NilValue) {
+    return -1;
+  }
+  switch(TYPEOF(value)) {
+  case LGLSXP:
+    return (LOGICAL(value)[0] == NA_LOGICAL ? -1 : LOGICAL(value)[0] != 0);
+  case INTSXP:
+    return (INTEGER(value)[0] == NA_INTEGER ? -1 : INTEGER(value)[0] != 0);
+  case REALSXP:
+    return (ISNAN(REAL(value)[0]) ? -1 : REAL(value)[0] != 0.0);
+  default:
+    return -1;
+  }
+}
+
 Expression SubexpBuffer::op_if(SEXP e, string rho, 
 			       ResultStatus resultStatus) 
 {
+  // Prune the branch that can't be taken. The condition is a
+  // constant, so there is nothing to evaluate for its effects.
+  if (Settings::instance()->get_constant_folding() &&
+      (Rf_length(e) == 3 || Rf_length(e) == 4))
+  {
+    int taken = constant_condition(if_cond_c(e));
+    if (taken == 1) {
+      return op_exp(if_truebody_c(e), rho, Unprotected, false, resultStatus);
+    } else if (taken == 0 && Rf_length(e) == 4) {
+      return op_exp(if_falsebody_c(e), rho, Unprotected, false, resultStatus);
+    } else if (taken == 0) {
+      return Expression::nil_exp;
+    }
+  }
+
   if (Rf_length(e) == 4) {                            // both true and false clauses present
 #if 1
     //----------------------------------------------------------
@@ -47,11 +90,19 @@ Expression SubexpBuffer::op_if(SEXP e, string rho,
     //  my_asLogicalNoNA is safe to call with an unprotected argument.
     //  it does not allocate memory.
     //  14 September 2005 - John Mellor-Crummey
+    //
+    //  RCC_CONDITION reads a logical scalar directly and calls
+    //  my_asLogicalNoNA for anything else.
     //----------------------------------------------------------
-    Expression cond = op_exp(if_cond_c(e), rho, Unprotected);
+    Expression cond = Expression::nil_exp;
+    string test = op_native_condition(if_cond_c(e), rho);
+    if (test.empty()) {
+      cond = op_exp(if_cond_c(e), rho, Unprotected);
+      test = "RCC_CONDITION(" + cond.var + ")";
+    }
 
     string out;
-    append_defs("if (my_asLogicalNoNA(" + cond.var + ")) {\n");
+    append_defs("if (" + test + ") {\n");
     del(cond);
 
     //----------------------------------------------------------
@@ -108,10 +159,15 @@ Expression SubexpBuffer::op_if(SEXP e, string rho,
 			    fe.var));
 #endif
   } else if (Rf_length(e) == 3) {         // just the one clause, no else
-    Expression cond = op_exp(if_cond_c(e), rho, Unprotected);
+    Expression cond = Expression::nil_exp;
+    string test = op_native_condition(if_cond_c(e), rho);
+    if (test.empty()) {
+      cond = op_exp(if_cond_c(e), rho, Unprotected);
+      test = "RCC_CONDITION(" + cond.var + ")";
+    }
     string out;
     assert(cond.del_text.empty());
-    append_defs("if (my_asLogicalNoNA(" + cond.var + ")) {\n");
+    append_defs("if (" + test + ") {\n");
     del(cond);
     SubexpBuffer true_se;
     Expression te = true_se.op_exp(if_truebody_c(e), rho, Unprotected, false,
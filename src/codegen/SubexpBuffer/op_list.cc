@@ -31,11 +31,14 @@
 #include <include/R/R_RInternals.h>
 
 #include <analysis/AnalysisResults.h>
+#include <analysis/Settings.h>
 #include <analysis/Utils.h>
 
 #include <support/StringUtils.h>
 
 #include <CodeGenUtils.h>
+#include <ConstantPool.h>
+#include <LazyConstants.h>
 #include <ParseInfo.h>
 #include <Dependence.h>
 #include <Visibility.h>
@@ -77,6 +80,13 @@ Expression SubexpBuffer::op_list(SEXP list, string rho, bool literal,
     return Expression::nil_exp;
   }
 
+  // a literal list can come out of the constant pool in one piece
+  if (literal && Settings::instance()->get_serialized_constants() &&
+      ConstantPool::can_serialize(list))
+  {
+    return Expression(ConstantPool::instance()->add(list), CONST, VISIBLE, "");
+  }
+
   int length = Rf_length(list);
 
   // output and store the car of each cons
@@ -126,7 +136,7 @@ Expression SubexpBuffer::op_list(SEXP list, string rho, bool literal,
   // if result is constant, assemble it in the constant pool
   SubexpBuffer * subexp = (list_dep == DEPENDENT ? 
 			   this :
-			   ParseInfo::global_constants);
+			   LazyConstants::instance()->buffer());
   string var = subexp->new_var_unp();
   if (list_dep == DEPENDENT) {
     subexp->append_decls("SEXP " + var + ";\n");
@@ -141,6 +151,8 @@ Expression SubexpBuffer::op_list(SEXP list, string rho, bool literal,
   subexp->append_defs(emit_assign(var, call));
   if (list_dep == DEPENDENT) {
     delete_text = unp(var);
+  } else {
+    LazyConstants::instance()->keep(var);
   }
   return Expression(var, list_dep, VISIBLE, delete_text);
 }
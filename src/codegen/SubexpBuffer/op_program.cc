@@ -34,24 +34,31 @@
 
 #include <CheckProtect.h>
 #include <CodeGenUtils.h>
-#include <Metrics.h>
+#include <ConstantPool.h>
+#include <LazyConstants.h>
+#include <OutputUnits.h>
 #include <ParseInfo.h>
+#include <ProfileData.h>
+#include <ProfileTable.h>
+#include <ProtectPlanner.h>
 
 #include <codegen/SubexpBuffer/SubexpBuffer.h>
 #include <codegen/SubexpBuffer/SplitSubexpBuffer.h>
 
 using namespace std;
 
+static const string INIT_PREFIX = "R_init_";
+
 static void op_top_level_exp_cleanup(SubexpBuffer & subexps,
 				     const Expression & exp,
 				     int i,
 				     string & exec_decls,
 				     string & exec_defs);
 
-string SubexpBuffer::op_program(SEXP e, string rho, string func_name,
-				bool output_main_program, bool output_default_args)
+void SubexpBuffer::op_program(SEXP e, string rho, string func_name,
+			      bool output_main_program, bool output_default_args,
+			      OutputUnits & units)
 {
-  string program;
   int i;
   string exec_decls, exec_defs;
 
@@ -93,6 +100,7 @@ string SubexpBuffer::op_program(SEXP e, string rho, string func_name,
     rcc_warn(ae.what());
     rcc_warn("analysis encountered difficulties; compiling trivially");
     clearProperties();
+    LazyConstants::instance()->abandon();
     ParseInfo::set_analysis_ok(false);
     e = original_e;
     exec_decls = "";
@@ -116,14 +124,29 @@ string SubexpBuffer::op_program(SEXP e, string rho, string func_name,
 
   string finish_code;
   finish_code += "UNPROTECT(" + i_to_s(ParseInfo::global_constants->get_n_prot()) + "); /* c_ */\n";
+
+  // with -fprofile, hand the counters to the runtime to be written at exit
+  const ProfileTable * profile = ProfileTable::instance();
+  if (!profile->empty()) {
+    string module = func_name;
+    if (module.compare(0, INIT_PREFIX.size(), INIT_PREFIX) == 0) {
+      module.erase(0, INIT_PREFIX.size());
+    }
+    finish_code += profile->output_register(module);
+  }
   
   string rcc_path_prefix = string("#include \"") + RCC_INCLUDE_PATH + "/"; 
 
   // output
-  program += rcc_path_prefix + "rcc_generated_header.h\"\n";
-  program += "\n";
+  string prologue;
+  if (Settings::instance()->get_alloc_stats()) {
+    // count allocations through the wrappers in rcc_stats.h
+    prologue += "#define RCC_ALLOC_STATS\n";
+  }
+  prologue += rcc_path_prefix + "rcc_generated_header.h\"\n";
+  prologue += "\n";
 #ifdef CHECK_PROTECT
-  program += "#include <assert.h>\n";
+  prologue += "#include <assert.h>\n";
 #endif
 
   ParseInfo::global_fundefs->output_ip();
@@ -132,11 +155,33 @@ string SubexpBuffer::op_program(SEXP e, string rho, string func_name,
   ParseInfo::global_constants->output_ip();
   ParseInfo::global_constants->finalize();
 
-  program += ParseInfo::global_fundefs->output_decls();
-  program += ParseInfo::global_constants->output_decls();
+  const ConstantPool * pool = ConstantPool::instance();
+  const LazyConstants * lazy = LazyConstants::instance();
+  string decls;
+  if (!pool->empty()) {
+    decls += pool->output_decls();
+  }
+  decls += ParseInfo::global_fundefs->output_decls();
+  decls += ParseInfo::global_constants->output_decls();
+  decls += lazy->output_decls();
+  if (!profile->empty()) {
+    decls += profile->output_decls();
+  }
 
+  string main_code;
+  if (!pool->empty()) {
+    main_code += pool->output_data();
+  }
+  if (!profile->empty()) {
+    main_code += profile->output_data();
+  }
+  main_code += "static void exec();\n";
+  main_code += "static void finish();\n";
   string header;
   header += "\nvoid " + func_name + "() {\n";
+  if (!pool->empty()) {
+    header += indent(pool->output_init());
+  }
   for(i=0; i<ParseInfo::global_constants->get_n_inits(); i++) {
     header += indent(ParseInfo::global_constants->get_init_str() + i_to_s(i) + "();\n");
   }
@@ -144,12 +189,13 @@ string SubexpBuffer::op_program(SEXP e, string rho, string func_name,
   header += indent("exec();\n");
   header += indent("finish();\n");
   header += "}\n";
-  program += header;
+  main_code += header;
 
-  program += ParseInfo::global_constants->output_defs();
-  program += "static void exec() " + emit_in_braces(exec_decls + exec_defs) + "\n\n";
-  program += "static void finish() " + emit_in_braces(finish_code, false) + "\n\n";
-  program += ParseInfo::global_fundefs->output_defs();
+  if (Settings::instance()->get_protect_elision()) {
+    exec_defs = plan_protection(exec_defs);
+  }
+  main_code += "static void exec() " + emit_in_braces(exec_decls + exec_defs) + "\n\n";
+  main_code += "static void finish() " + emit_in_braces(finish_code, false) + "\n\n";
   if (output_main_program) {
      string arginit = "int myargc;\n";
      string mainargs = "int argc, char **argv";
@@ -173,63 +219,23 @@ string SubexpBuffer::op_program(SEXP e, string rho, string func_name,
        "}\n" +
        "end_Rmainloop();\n" +
        "return 0;\n";
-     program += "\nint main(" + mainargs + ") \n{\n" + indent(body) + "}\n"; 
+     main_code += "\nint main(" + mainargs + ") \n{\n" + indent(body) + "}\n"; 
   }
 
-  // output metrics and settings
-  const Metrics * m = Metrics::instance();
-  string stats;
-  stats += comment("Compile-time metrics:") + "\n";
-  stats += comment("procedures: "                     + i_to_s(m->get_procedures())) + "\n";
-
-  stats += comment("builtin calls: "                  + i_to_s(m->total_builtin_calls())) + "\n";
-  stats += comment(indent("by #args:")) + "\n";
-  for(int i = 0; i <= m->max_key_builtin_calls(); i++) {
-    stats += comment(indent(i_to_s(i) + "\t" + i_to_s(m->get_builtin_calls(i)) + "\t")) + "\n";
-  }
+  string defs;
+  defs += ParseInfo::global_constants->output_defs();
+  defs += lazy->output_defs();
+  defs += ProfileData::instance()->order_definitions(ParseInfo::global_fundefs->output_defs());
 
-  stats += comment("special calls (not compiled): "   + i_to_s(m->total_special_calls())) + "\n";
-  stats += comment(indent("by #args:")) + "\n";
-  for(int i = 0; i <= m->max_key_special_calls(); i++) {
-    stats += comment(indent(i_to_s(i) + "\t" + i_to_s(m->get_special_calls(i)) + "\t")) + "\n";
-  }
-
-  stats += comment("library calls: "                  + i_to_s(m->total_library_calls())) + "\n";
-  stats += comment(indent("by #args:")) + "\n";
-  for(int i = 0; i <= m->max_key_library_calls(); i++) {
-    stats += comment(indent(i_to_s(i) + "\t" + i_to_s(m->get_library_calls(i)) + "\t")) + "\n";
-  }
-
-  stats += comment("calls to symbols in call graph: " + i_to_s(m->total_user_calls())) + "\n";
-  stats += comment(indent("by #args:")) + "\n";
-  for(int i = 0; i <= m->max_key_user_calls(); i++) {
-    stats += comment(indent(i_to_s(i) + "\t" + i_to_s(m->get_user_calls(i)) + "\t")) + "\n";
-  }
-
-  stats += comment("calls to unknown symbols: "       + i_to_s(m->total_unknown_symbol_calls())) + "\n";
-  stats += comment(indent("by #args:")) + "\n";
-  for(int i = 0; i <= m->max_key_unknown_symbol_calls(); i++) {
-    stats += comment(indent(i_to_s(i) + "\t" + i_to_s(m->get_unknown_symbol_calls(i)) + "\t")) + "\n";
-  }
-
-  stats += comment("calls to non-symbols: "           + i_to_s(m->total_non_symbol_calls())) + "\n";
-  stats += comment(indent("by #args:")) + "\n";
-  for(int i = 0; i <= m->max_key_non_symbol_calls(); i++) {
-    stats += comment(indent(i_to_s(i) + "\t" + i_to_s(m->get_non_symbol_calls(i)) + "\t")) + "\n";
-  }
-
-  stats += comment("local assignments (<-, =): "      + i_to_s(m->get_local_assignments())) + "\n";
-  stats += comment("free assignments (<<-): "         + i_to_s(m->get_free_assignments())) + "\n";  
-  stats += comment("eager actual args: "              + i_to_s(m->get_eager_actual_args())) + "\n";
-  stats += comment("lazy actual args: "               + i_to_s(m->get_lazy_actual_args())) + "\n";
-  stats += comment("strict formal args: "             + i_to_s(m->get_strict_formal_args())) + "\n";
-  stats += comment("nonstrict formal args: "          + i_to_s(m->get_nonstrict_formal_args())) + "\n";
-  stats += "\n";
+  // output settings; the metrics go in the compile report
+  string stats;
   stats += comment("RCC settings:") + "\n";
   stats += comment("\n" + Settings::instance()->get_pp_info()) + "\n";
-  program = stats + program;
-  
-  return program;
+
+  units.set_prologue(stats, prologue);
+  units.add_decls(decls);
+  units.add_main(main_code);
+  units.add_definitions(defs);
 }
 
 static void op_top_level_exp_cleanup(SubexpBuffer & subexps,
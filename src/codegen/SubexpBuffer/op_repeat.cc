@@ -35,6 +35,7 @@
 
 #include <CodeGenUtils.h>
 #include <LoopContext.h>
+#include <ProfileTable.h>
 #include <Visibility.h>
 
 using namespace std;
@@ -44,6 +45,16 @@ Expression SubexpBuffer::op_repeat(SEXP e, string rho) {
   SubexpBuffer loop;
   LoopContext loop_context;
 
+  string profile_entry, profile_start;
+  if (ProfileTable::instance()->sites()) {
+    profile_entry = ProfileTable::instance()->add_loop("repeat");
+    profile_start = new_var_unp();
+    ProfileTable::instance()->push_timer(profile_entry, profile_start);
+    append_decls(ProfileTable::emit_start_decl(profile_start));
+    append_defs(ProfileTable::emit_clock(profile_start));
+    loop.append_defs(ProfileTable::emit_count(profile_entry));
+  }
+
   // output code in loop
   Expression body = loop.op_exp(repeat_body_c(e), rho, Unprotected, false, NoResultNeeded);
   in_loop = indent("/* repeat loop */\n" + loop.output_decls() + loop.output_defs());
@@ -51,5 +62,9 @@ Expression SubexpBuffer::op_repeat(SEXP e, string rho) {
   // output loop
   append_defs("while(1) " + emit_in_braces(in_loop));
   append_defs(loop_context.breakLabel() + ":;\n");
+  if (!profile_entry.empty()) {
+    ProfileTable::instance()->pop_timer();
+    append_defs(ProfileTable::emit_stop(profile_entry, profile_start));
+  }
   return Expression::nil_exp;
 }
@@ -40,6 +40,7 @@
 #include <CodeGenUtils.h>
 #include <Dependence.h>
 #include <ParseInfo.h>
+#include <ProfileTable.h>
 #include <Visibility.h>
 
 using namespace std;
@@ -111,6 +112,20 @@ now performed in applyClosureOpt
   }
 #endif
 
+  if (fi && Settings::instance()->get_region_alloc()) {
+    append_defs(emit_call1("rcc_region_leave", "&region") + ";\n");
+  }
+
+  // the timers make_fundef would stop on the way out, and those of
+  // the loops being left
+  if (fi) {
+    append_defs(ProfileTable::instance()->emit_return_stops());
+  }
+
+  if (fi && Settings::instance()->get_alloc_stats()) {
+    append_defs(emit_call1("rcc_stats_escape", "RCC_ESCAPE_RETURN") + ";\n");
+  }
+
 #ifdef CHECK_PROTECT
   append_defs("assert(topval == R_PPStackTop);\n");
 #endif
@@ -89,6 +89,9 @@ Expression SubexpBuffer::op_set(SEXP cell, SEXP op, string rho,
       target_env = rho;
     } else {
       target_env = emit_call1("ENCLOS", rho);
+      if (Settings::instance()->get_alloc_stats()) {
+	append_defs(emit_call1("rcc_stats_escape", "RCC_ESCAPE_ASSIGN") + ";\n");
+      }
     }
 
     retval = op_var_def(assign_lhs_c(e), body.var, target_env);
@@ -113,6 +113,8 @@ Expression SubexpBuffer::op_special(SEXP cell, SEXP op, string rho,
     return op_subscript(e, op, rho, resultProtection);
   } else if (PRIMFUN(op) == (CCODE)do_subset3) {   // field access, e.g.  foo$bar
     return op_struct_field(e, op, rho, resultProtection);
+  } else if (is_native_andor(e) && Settings::instance()->get_native_conditions()) {
+    return op_andor(cell, rho, resultProtection, resultStatus);
   } else {
     // default case for specials: call the (call, op, args, rho) fn
     Metrics::instance()->inc_special_calls(Rf_length(call_args(e)));
@@ -30,7 +30,9 @@
 #include <include/R/R_RInternals.h>
 
 #include <analysis/AnalysisResults.h>
+#include <analysis/Settings.h>
 #include <support/StringUtils.h>
+#include <ConstantPool.h>
 #include <ParseInfo.h>
 #include <Visibility.h>
 
@@ -43,7 +45,14 @@ Expression SubexpBuffer::op_string(SEXP s) {
   for(i=0; i<len; i++) {
     str += string(CHAR(STRING_ELT(s, i)));
   }
-  string out = ParseInfo::global_constants->appl1("mkString", "",
-						  quote(escape(str)));
+  string out;
+  if (Settings::instance()->get_serialized_constants()) {
+    SEXP value = PROTECT(Rf_mkString(str.c_str()));
+    out = ConstantPool::instance()->add(value);
+    UNPROTECT(1);
+  } else {
+    out = ParseInfo::global_constants->appl1("mkString", "",
+					     quote(escape(str)));
+  }
   return Expression(out, CONST, VISIBLE, "");
 }
@@ -20,6 +20,12 @@
 //
 // Output a field access expression, such as "foo$bar".
 //
+// A field given by a name is looked up by rcc_field, which keeps the
+// field's position for each site: repeated accesses to lists with the
+// same names vector cost a pointer comparison and a VECTOR_ELT. The
+// general do_subset3 is called only for objects, non-lists and names
+// that need partial matching.
+//
 // Author: John Garvin (garvin@cs.rice.edu)
 
 #include <cassert>
@@ -40,6 +46,7 @@
 
 #include <CodeGen.h>
 #include <CodeGenUtils.h>
+#include <CompileReport.h>
 #include <GetName.h>
 #include <Metrics.h>
 #include <ParseInfo.h>
@@ -47,30 +54,90 @@
 
 using std::string;
 
+static Expression op_generic_field(SubexpBuffer * sb, SEXP e, SEXP op, string rho,
+				   Protection resultProtection);
+
 Expression SubexpBuffer::op_struct_field(SEXP e, SEXP op, string rho, Protection resultProtection) {
   assert(is_struct_field(e));
-  
+  SEXP field = CAR(struct_field_rhs_c(e));
+  string name;
+  if (is_var(field)) {
+    name = var_name(field);
+  } else if (is_string(field) && Rf_length(field) == 1) {
+    name = CHAR(STRING_ELT(field, 0));
+  }
+  if (name.empty() || !Settings::instance()->get_field_cache()) {
+    return op_generic_field(this, e, op, rho, resultProtection);
+  }
+
+  CompileReport::instance()->note_fast_path("field_cache");
+  string charsxp = ParseInfo::global_constants->appl1("mkChar", "", quote(escape(name)));
+  string cache = ParseInfo::global_constants->new_var_unp_name("field");
+  ParseInfo::global_constants->append_decls("static rcc_field_cache " + cache + " = RCC_FIELD_CACHE_INIT;\n");
+
+  Expression x = op_exp(struct_field_lhs_c(e), rho, Protected, true);
+  string out = new_sexp_unp();
+  append_defs(emit_assign(out, emit_call3("rcc_field", x.var, charsxp, "&" + cache)));
+
+  // not a plain list with that name: the general operator on x's value
+  SubexpBuffer slow_se;
+  Expression op1 = ParseInfo::global_constants->op_primsxp(op, rho);
+  Expression args1 = slow_se.op_list(CDR(e), rho, true, Protected, true);
+  string call_str = slow_se.appl2("lcons", "", op1.var, args1.var);
+  Expression call = Expression(call_str, CONST, VISIBLE, unp(call_str));
+  string slow = slow_se.appl5("rcc_subset3",
+			      "op_struct_field: " + to_string(e),
+			      call.var,
+			      op1.var,
+			      x.var,
+			      charsxp,
+			      rho,
+			      Unprotected);
+  slow_se.append_defs(emit_assign(out, slow));
+  slow_se.del(call);
+  slow_se.del(args1);
+  append_defs("if (" + out + " == NULL) {\n");
+  append_defs(indent(slow_se.output_decls()));
+  append_defs(indent(slow_se.output_defs()));
+  append_defs("}\n");
+  string cleanup;
+  if (resultProtection == Protected) {
+    append_defs(protect_str(out) + ";\n");
+    cleanup = unp(out);
+  }
+  del(op1);
+  del(x);
+  return Expression(out, DEPENDENT,
+		    1 - PRIMPRINT(op) ? VISIBLE : INVISIBLE,
+		    cleanup);
+}
+
+/// Output a field access through do_subset3, which evaluates the
+/// list itself.
+static Expression op_generic_field(SubexpBuffer * sb, SEXP e, SEXP op, string rho,
+				   Protection resultProtection)
+{
 #ifdef USE_OUTPUT_CODEGEN
   Expression op1 = output_to_expression(CodeGen::op_primsxp(op, rho));
   Expression args1 = output_to_expression(CodeGen::op_list(CDR(e), rho, true, true));
 #else
   Expression op1 = ParseInfo::global_constants->op_primsxp(op, rho);
-  Expression args1 = op_list(CDR(e), rho, true, Protected, true);
+  Expression args1 = sb->op_list(CDR(e), rho, true, Protected, true);
 #endif
-  string call_str = appl2("lcons", "", op1.var, args1.var);
+  string call_str = sb->appl2("lcons", "", op1.var, args1.var);
   Expression call = Expression(call_str, CONST, VISIBLE, unp(call_str));
-  string out = appl4(get_name(PRIMOFFSET(op)),
-		     "op_struct_field: " + to_string(e),
-		     call.var,
-		     op1.var,
-		     args1.var,
-		     rho,
-		     resultProtection);
+  string out = sb->appl4(get_name(PRIMOFFSET(op)),
+			 "op_struct_field: " + to_string(e),
+			 call.var,
+			 op1.var,
+			 args1.var,
+			 rho,
+			 resultProtection);
   string cleanup;
   if (resultProtection == Protected) cleanup = unp(out);
-  del(call);
-  del(op1);
-  del(args1);
+  sb->del(call);
+  sb->del(op1);
+  sb->del(args1);
   return Expression(out, DEPENDENT, 
 		    1 - PRIMPRINT(op) ? VISIBLE : INVISIBLE, 
 		    cleanup);
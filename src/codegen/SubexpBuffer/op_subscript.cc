@@ -35,6 +35,8 @@
 #include <support/StringUtils.h>
 
 #include <CodeGenUtils.h>
+#include <CompileReport.h>
+#include <LoopContext.h>
 #include <ParseInfo.h>
 #include <Visibility.h>
 
@@ -42,12 +44,62 @@ using std::string;
 
 #define CAREFUL_OO 1
 
+static Expression op_checked_subscript(SubexpBuffer * sb, SEXP e, SEXP op, string rho,
+				       Protection resultProtection);
+
 Expression SubexpBuffer::op_subscript(SEXP e, SEXP op, string rho, Protection resultProtection) {
   assert(is_subscript(e));
+  const LoopContext::DirectSubscript * ds = LoopContext::findDirectSubscript(e);
+  if (ds == 0) {
+    return op_checked_subscript(this, e, op, rho, resultProtection);
+  }
+
+  // Subscript of a loop index whose range was checked before the
+  // loop: read the element directly if the guard holds, otherwise
+  // fall back to the general case.
+  CompileReport::instance()->note_fast_path("direct_subscript");
+  string out = new_sexp_unp();
+  string ok = new_var_unp();
+  append_decls("Rboolean " + ok + ";\n");
+  SubexpBuffer fast_se;
+  string array = ds->array;
+  string check;
+  if (array.empty()) {
+    // the array may change in the loop; check it at the access
+    Expression a = fast_se.op_exp(subscript_lhs_c(e), rho, Unprotected, true);
+    array = a.var;
+    check = emit_call1("rcc_is_plain_vector", array) + " && " +
+      ds->index + " < " + emit_call1("LENGTH", array);
+  }
+  string elt = emit_assign(out, emit_call2("RCC_VECTOR_ELT", array, ds->index), resultProtection) +
+    emit_assign(ok, "TRUE");
+  fast_se.append_defs(check.empty() ? elt : emit_logical_if_stmt(check, emit_in_braces(elt, false)));
+  append_defs(emit_assign(ok, "FALSE"));
+  append_defs("if (" + ds->guard + ") {\n");
+  append_defs(indent(fast_se.output_decls()));
+  append_defs(indent(fast_se.output_defs()));
+  append_defs("}\n");
 
+  SubexpBuffer checked_se;
+  Expression checked = op_checked_subscript(&checked_se, e, op, rho, resultProtection);
+  checked_se.append_defs(emit_assign(out, checked.var));
+  append_defs("if (!" + ok + ") {\n");
+  append_defs(indent(checked_se.output_decls()));
+  append_defs(indent(checked_se.output_defs()));
+  append_defs("}\n");
+  string cleanup;
+  if (resultProtection == Protected) cleanup = unp(out);
+  return Expression(out, DEPENDENT, checked.visibility, cleanup);
+}
+
+/// Output a subscript through the general subset operator, which
+/// handles objects, attributes and every kind of index.
+static Expression op_checked_subscript(SubexpBuffer * sb, SEXP e, SEXP op, string rho,
+				       Protection resultProtection)
+{
   Expression op1 = ParseInfo::global_constants->op_primsxp(op, rho);
 
-  Expression args1 = op_list(CDR(e), rho, false, Protected, true);
+  Expression args1 = sb->op_list(CDR(e), rho, false, Protected, true);
 
 #if 0
 #if CAREFUL_OO == 1
@@ -57,25 +109,25 @@ Expression SubexpBuffer::op_subscript(SEXP e, SEXP op, string rho, Protection re
 #endif
 #endif
 
-  string call_str = appl2("lcons", "", op1.var, args1.var);
+  string call_str = sb->appl2("lcons", "", op1.var, args1.var);
   Expression call = Expression(call_str, CONST, VISIBLE, unp(call_str));
 #if CAREFUL_OO == 1
   string func = "rcc_subset";
 #else
   string func = "do_subset_dflt";
 #endif
-  string out = appl4(func,
-		     "op_subscript: " + to_string(e),
-		     call.var,
-		     op1.var,
-		     args1.var,
-		     rho,
-		     resultProtection);
+  string out = sb->appl4(func,
+			 "op_subscript: " + to_string(e),
+			 call.var,
+			 op1.var,
+			 args1.var,
+			 rho,
+			 resultProtection);
   string cleanup;
   if (resultProtection == Protected) cleanup = unp(out);
-  del(call);
-  del(op1);
-  del(args1);
+  sb->del(call);
+  sb->del(op1);
+  sb->del(args1);
   return Expression(out, DEPENDENT,
 		    1 - PRIMPRINT(op) ? VISIBLE : INVISIBLE,
 		    cleanup);
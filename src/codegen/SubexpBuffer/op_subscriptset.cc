@@ -25,6 +25,7 @@
 #include <string>
 
 #include <CodeGenUtils.h>
+#include <LoopContext.h>
 
 #include <codegen/SubexpBuffer/SubexpBuffer.h>
 
@@ -93,6 +94,24 @@ Expression SubexpBuffer::op_subscriptset(SEXP cell, string rho,
     subassign = appl2("rcc_subassign_0", to_string(e), a.var, r.var, Unprotected);
     break;
   case 1:
+    if (const LoopContext::DirectSubscript * ds = LoopContext::findDirectSubscript(lhs)) {
+      // Subscript of a loop index whose lower bound was checked
+      // before the loop: store in place when the array allows it,
+      // otherwise fall back to the general case.
+      SubexpBuffer checked_se;
+      subassign = new_sexp_unp();
+      s = checked_se.op_exp(subscript_first_sub_c(lhs), rho);
+      checked_se.append_defs(emit_assign(subassign, emit_call3("rcc_subassign_1", a.var, s.var, r.var)));
+      checked_se.del(s);
+      append_defs("if (" + ds->guard + " && " +
+		  emit_call3("rcc_set_vector_elt", a.var, ds->index, r.var) + ") {\n");
+      append_defs(indent(emit_assign(subassign, a.var)));
+      append_defs("} else {\n");
+      append_defs(indent(checked_se.output_decls()));
+      append_defs(indent(checked_se.output_defs()));
+      append_defs("}\n");
+      break;
+    }
     s = op_exp(subscript_first_sub_c(lhs), rho);
     if (!s.del_text.empty()) unprotcnt++;
     subassign = appl3("rcc_subassign_1", to_string(e), a.var, s.var, r.var, Unprotected);
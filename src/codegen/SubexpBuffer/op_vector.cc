@@ -31,13 +31,24 @@
 #include <include/R/R_RInternals.h>
 
 #include <analysis/AnalysisResults.h>
+#include <analysis/Settings.h>
 #include <support/StringUtils.h>
 #include <support/RccError.h>
+#include <ConstantPool.h>
 #include <ParseInfo.h>
 #include <Visibility.h>
 
 using namespace std;
 
+/// Output a scalar constant, either taken from the constant pool or
+/// built in the constant initialization code by calling maker.
+static string scalar_constant(SEXP vec, string maker, string value) {
+  if (Settings::instance()->get_serialized_constants() && ConstantPool::can_serialize(vec)) {
+    return ConstantPool::instance()->add(vec);
+  }
+  return ParseInfo::global_constants->appl1(maker, "", value);
+}
+
 Expression SubexpBuffer::op_vector(SEXP vec) {
   int len = Rf_length(vec);
   switch(TYPEOF(vec)) {
@@ -45,8 +56,7 @@ Expression SubexpBuffer::op_vector(SEXP vec) {
     if (len == 1) {
       int value = INTEGER(vec)[0];
       if ( ! ParseInfo::logical_constant_exists(value)) {
-	string var = ParseInfo::global_constants->appl1("ScalarLogical", "",
-							i_to_s(value));
+	string var = scalar_constant(vec, "ScalarLogical", i_to_s(value));
 	ParseInfo::insert_logical_constant(value, var);
 	return Expression(var, CONST, VISIBLE, "");
       } else {
@@ -62,8 +72,7 @@ Expression SubexpBuffer::op_vector(SEXP vec) {
     if (len == 1) {
       int value = INTEGER(vec)[0];
       if (!ParseInfo::integer_constant_exists(value)) {
-	string var = ParseInfo::global_constants->appl1("ScalarInteger", "",
-							i_to_s(value));
+	string var = scalar_constant(vec, "ScalarInteger", i_to_s(value));
 	ParseInfo::insert_integer_constant(value, var);
 	return Expression(var, CONST, VISIBLE, "");
       } else {
@@ -79,8 +88,7 @@ Expression SubexpBuffer::op_vector(SEXP vec) {
     if (len == 1) {
       double value = REAL(vec)[0];
       if (!ParseInfo::real_constant_exists(value)) {  // not found
-	string var = ParseInfo::global_constants->appl1("ScalarReal", "",
-							d_to_s(value));
+	string var = scalar_constant(vec, "ScalarReal", d_to_s(value));
 	ParseInfo::insert_real_constant(value, var);
 	return Expression(var, CONST, VISIBLE, "");
       } else {
@@ -95,8 +103,7 @@ Expression SubexpBuffer::op_vector(SEXP vec) {
   case CPLXSXP:
     if (len == 1) {
       Rcomplex value = COMPLEX(vec)[0];
-      string var = ParseInfo::global_constants->appl1("ScalarComplex", "",
-						      c_to_s(value));
+      string var = scalar_constant(vec, "ScalarComplex", c_to_s(value));
       return Expression(var, CONST, VISIBLE, "");
     } else {
       ParseInfo::flag_problem();
@@ -35,6 +35,7 @@
 
 #include <CodeGenUtils.h>
 #include <LoopContext.h>
+#include <ProfileTable.h>
 #include <Visibility.h>
 
 using namespace std;
@@ -51,9 +52,23 @@ Expression SubexpBuffer::op_while(SEXP e, string rho, ResultStatus resultStatus)
     append_defs("PROTECT_WITH_INDEX(ans, &api);\n");
   }
 
+  string profile_entry, profile_start;
+  if (ProfileTable::instance()->sites()) {
+    profile_entry = ProfileTable::instance()->add_loop("while");
+    profile_start = new_var_unp();
+    ProfileTable::instance()->push_timer(profile_entry, profile_start);
+    append_decls(ProfileTable::emit_start_decl(profile_start));
+    append_defs(ProfileTable::emit_clock(profile_start));
+    loop.append_defs(ProfileTable::emit_count(profile_entry));
+  }
+
   // output code in loop
-  Expression condition = loop.op_exp(while_cond_c(e), rho, Unprotected, false);
-  loop.append_defs("if (!my_asLogicalNoNA(" + condition.var + ")) break;\n");
+  string truth = loop.op_native_condition(while_cond_c(e), rho);
+  if (truth.empty()) {
+    Expression condition = loop.op_exp(while_cond_c(e), rho, Unprotected, false);
+    truth = "RCC_CONDITION(" + condition.var + ")";
+  }
+  loop.append_defs("if (!" + truth + ") break;\n");
   Expression body = loop.op_exp(while_body_c(e), rho, Unprotected, false, resultStatus);
   if (resultStatus == ResultNeeded) {
     loop.append_defs("REPROTECT(ans = " + body.var + ", api);\n");
@@ -63,6 +78,10 @@ Expression SubexpBuffer::op_while(SEXP e, string rho, ResultStatus resultStatus)
   // output loop
   append_defs("while(1) " + emit_in_braces(in_loop));
   append_defs(loop_context.breakLabel() + ":\n");
+  if (!profile_entry.empty()) {
+    ProfileTable::instance()->pop_timer();
+    append_defs(ProfileTable::emit_stop(profile_entry, profile_start));
+  }
   if (resultStatus == ResultNeeded) {
     append_defs(emit_unprotect("ans"));
   }
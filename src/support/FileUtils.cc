@@ -0,0 +1,59 @@
+// -*- Mode: C++ -*-
+//
+// Copyright (c) 2009 Rice University
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation; either version 2 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA 
+
+
+// File: FileUtils.cc
+//
+// Reading and writing whole files.
+//
+// Author: John Garvin (garvin@cs.rice.edu)
+
+#include <fstream>
+#include <sstream>
+
+#include <support/RccError.h>
+
+#include "FileUtils.h"
+
+using namespace std;
+
+bool read_file(const string & filename, string & text) {
+  ifstream in(filename.c_str());
+  if (!in) {
+    return false;
+  }
+  ostringstream contents;
+  contents << in.rdbuf();
+  text = contents.str();
+  return !in.bad();
+}
+
+void write_file_if_changed(const string & filename, const string & text) {
+  string old_text;
+  if (read_file(filename, old_text) && old_text == text) {
+    return;
+  }
+  ofstream out(filename.c_str());
+  if (!out) {
+    rcc_error("Couldn't open file " + filename + " for output");
+  }
+  out << text;
+  if (!out) {
+    rcc_error("Couldn't write to file " + filename);
+  }
+}
@@ -0,0 +1,39 @@
+// -*- Mode: C++ -*-
+//
+// Copyright (c) 2009 Rice University
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation; either version 2 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA 
+
+
+// File: FileUtils.h
+//
+// Reading and writing whole files.
+//
+// Author: John Garvin (garvin@cs.rice.edu)
+
+#ifndef FILE_UTILS_H
+#define FILE_UTILS_H
+
+#include <string>
+
+/// Read the file into text; return false if it can't be read
+bool read_file(const std::string & filename, std::string & text);
+
+/// Write text to the file unless it already holds exactly that text,
+/// so that an unchanged output keeps its timestamp and make doesn't
+/// rebuild what depends on it
+void write_file_if_changed(const std::string & filename, const std::string & text);
+
+#endif // FILE_UTILS_H
@@ -22,19 +22,56 @@
 //
 // Author: John Garvin (garvin@cs.rice.edu)
 
+#include <fcntl.h>
+#include <limits.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <map>
 #include <string>
 
 #include <include/R/R_Parse.h>
+#include <support/FileUtils.h>
 #include <support/RccError.h>
 
 #include <support/Parser.h>
+#include <support/RCall.h>
+
+// Top-level expressions of a sourced file, as the parser returned
+// them, before source() and library() calls are handled
+struct ParsedFile {
+  std::string text;  // contents of the file when it was parsed
+  SEXP exps;         // pairlist, preserved
+};
+
+// Sourced files already parsed, keyed by canonical path. An entry is
+// used only if the file's contents are still the same, so the cache
+// is kept across the compilations of a compile server.
+static std::map<std::string, ParsedFile> s_parsed_files;
+
+// arguments and results of R_Parse1File under rcc_call_R
+struct ParseCall {
+  FILE * in_file;
+  ParseStatus status;
+  SEXP value;
+};
 
 // forward declaration of internal functions
 
+static SEXP read_exps(FILE * in_file);
+static void parse1_at_toplevel(void * data);
+static void expand_exps(SEXP raw, bool copy, SEXP & tail);
+static SEXP sourced_exps(const std::string & name);
+static void prefetch_sourced_files(SEXP raw);
 static bool is_simple_source_call(SEXP e);
 static bool is_simple_library_call(SEXP e);
 
+/// Start the embedded R. Only the first call does anything, so the
+/// compile server can start R once for all its compilations.
 void init_R() {
+  static bool initialized = false;
+  if (initialized) return;
+  initialized = true;
   char *myargs[5];
   myargs[0] = "";
   myargs[1] = "--gui=none";
@@ -49,58 +86,50 @@ void init_R() {
 /// expressions. The caller must free p_exps.
 ///
 /// If the parser encounters a call to 'source' at top level with one
-/// non-named argument, it parses the named file at compile time.
+/// non-named argument, it parses the named file at compile time. Each
+/// sourced file is parsed once; sourcing it again gets a copy of the
+/// same expressions.
 ///
 /// If the parser encounters a call to 'library' at top level, it
 /// evaluates the call in the compiler so that RCC will recognize the
 /// added names.
 void parse_R(FILE *in_file, SEXP *p_exps[]) {
+  SEXP raw = Rf_protect(read_exps(in_file));
+  SEXP head = Rf_protect(Rf_cons(R_NilValue, R_NilValue));
+  SEXP tail = head;
+  expand_exps(raw, false, tail);
+
+  SEXP *exps = (SEXP *)malloc((Rf_length(CDR(head)) + 1) * sizeof(SEXP));
   int n = 0;
+  for (SEXP e = CDR(head); e != R_NilValue; e = CDR(e)) {
+    exps[n++] = CAR(e);
+  }
+  exps[n] = NULL;
+  Rf_unprotect(2);
+
+  *p_exps = exps;
+}
+
+/// Parses every expression in 'in_file' and returns them as a
+/// pairlist. The result is unprotected.
+static SEXP read_exps(FILE * in_file) {
   SEXP e;
   ParseStatus status;
-  SEXP *exps;
-
-  exps = (SEXP *)malloc(sizeof(SEXP));
+  SEXP head = Rf_protect(Rf_cons(R_NilValue, R_NilValue));
+  SEXP tail = head;
 
   do {
     // parse each expression
-    Rf_protect(e = R_Parse1File(in_file, 1, &status));
+    ParseCall parse = {in_file, PARSE_NULL, R_NilValue};
+    rcc_call_R(parse1_at_toplevel, &parse, "the parser");
+    status = parse.status;
+    Rf_protect(e = parse.value);
     switch(status) {
     case PARSE_NULL:
       break;
     case PARSE_OK:
-
-      // special handling for source()
-      if (is_simple_source_call(e)) {
-	SEXP interp_arg = Rf_eval(CADR(e), R_GlobalEnv);
-	if (TYPEOF(interp_arg) != STRSXP) {
-	  rcc_error("Problem interpreting argument to 'source'");
-	}
-	char * name_c = CHAR(STRING_ELT(interp_arg, 0));
-	FILE * new_file = fopen(name_c, "r");
-	if (new_file == NULL) {
-	  rcc_error("Couldn't open sourced file " + std::string(name_c));
-	}
-	SEXP * new_exps;
-	parse_R(new_file, &new_exps);
-	// append new exps to end
-	for( ; *new_exps != NULL; new_exps++) {
-	  n++;
-	  exps = (SEXP *)realloc((void *)exps, (n+1)*sizeof(SEXP));
-	  exps[n-1] = *new_exps;
-	}
-
-	// special handling for library()
-      } else if (is_simple_library_call(e)) {
-	Rf_eval(e, R_GlobalEnv);  // add to compiler's environment
-	n++;
-	exps = (SEXP *)realloc((void *)exps, (n+1)*sizeof(SEXP));
-	exps[n-1] = e;
-      } else {
-	n++;
-	exps = (SEXP *)realloc((void *)exps, (n+1)*sizeof(SEXP));
-	exps[n-1] = e;
-      }
+      SETCDR(tail, Rf_cons(e, R_NilValue));
+      tail = CDR(tail);
       break;
     case PARSE_INCOMPLETE:
       break;
@@ -112,9 +141,103 @@ void parse_R(FILE *in_file, SEXP *p_exps[]) {
     }
     Rf_unprotect(1);
   } while (status != PARSE_EOF && status != PARSE_INCOMPLETE);
-  exps[n] = NULL;
 
-  *p_exps = exps;
+  Rf_unprotect(1);
+  return CDR(head);
+}
+
+static void parse1_at_toplevel(void * data) {
+  ParseCall * c = static_cast<ParseCall *>(data);
+  c->value = R_Parse1File(c->in_file, 1, &c->status);
+}
+
+/// Appends the expressions in 'raw' after 'tail', replacing each
+/// source() call by the expressions of the sourced file and
+/// evaluating each library() call. If 'copy' is set, the expressions
+/// are duplicated, so that a file sourced twice yields distinct trees.
+static void expand_exps(SEXP raw, bool copy, SEXP & tail) {
+  prefetch_sourced_files(raw);
+  for (SEXP r = raw; r != R_NilValue; r = CDR(r)) {
+    SEXP e = CAR(r);
+
+    // special handling for source()
+    if (is_simple_source_call(e)) {
+      SEXP interp_arg = rcc_eval(CADR(e), R_GlobalEnv, "the argument to source()");
+      if (TYPEOF(interp_arg) != STRSXP) {
+	rcc_error("Problem interpreting argument to 'source'");
+      }
+      expand_exps(sourced_exps(CHAR(STRING_ELT(interp_arg, 0))), true, tail);
+      continue;
+    }
+
+    // special handling for library()
+    if (is_simple_library_call(e)) {
+      rcc_eval(e, R_GlobalEnv, "a call to library()");  // add to compiler's environment
+    }
+    if (copy) {
+      e = Rf_duplicate(e);
+    }
+    Rf_protect(e);
+    SETCDR(tail, Rf_cons(e, R_NilValue));
+    tail = CDR(tail);
+    Rf_unprotect(1);
+  }
+}
+
+/// Returns the top-level expressions of the named file, parsing it
+/// only if it has not been parsed with the same contents before.
+static SEXP sourced_exps(const std::string & name) {
+  char path_c[PATH_MAX];
+  std::string text;
+  if (realpath(name.c_str(), path_c) == NULL || !read_file(path_c, text)) {
+    rcc_error("Couldn't open sourced file " + name);
+  }
+  std::string path(path_c);
+
+  std::map<std::string, ParsedFile>::iterator it = s_parsed_files.find(path);
+  if (it != s_parsed_files.end()) {
+    if (it->second.text == text) {
+      return it->second.exps;
+    }
+    R_ReleaseObject(it->second.exps);
+    s_parsed_files.erase(it);
+  }
+
+  // parse the text already in memory instead of reading the file again
+  SEXP exps = R_NilValue;
+  if (!text.empty()) {
+    FILE * in_file = fmemopen(const_cast<char *>(text.data()), text.size(), "r");
+    if (in_file == NULL) {
+      rcc_error("Couldn't open sourced file " + name);
+    }
+    exps = read_exps(in_file);
+    fclose(in_file);
+  }
+  R_PreserveObject(exps);
+  ParsedFile parsed = {text, exps};
+  s_parsed_files[path] = parsed;
+  return exps;
+}
+
+/// Asks the kernel to start reading every file sourced by a string
+/// literal in 'raw', so that the reads overlap with parsing the
+/// files sourced before them. The R parser is not reentrant, so the
+/// parsing itself stays sequential.
+static void prefetch_sourced_files(SEXP raw) {
+  for (SEXP r = raw; r != R_NilValue; r = CDR(r)) {
+    SEXP e = CAR(r);
+    if (!is_simple_source_call(e) ||
+	TYPEOF(CADR(e)) != STRSXP ||
+	Rf_length(CADR(e)) < 1)
+    {
+      continue;
+    }
+    int fd = open(CHAR(STRING_ELT(CADR(e), 0)), O_RDONLY);
+    if (fd >= 0) {
+      posix_fadvise(fd, 0, 0, POSIX_FADV_WILLNEED);
+      close(fd);
+    }
+  }
 }
 
 ///  Parse R code into a sequence of R AST expressions, then makes and
@@ -150,6 +273,7 @@ SEXP parse_R_as_function(FILE *in_file) {
       stmts = Rf_cons(*e, stmts);
     } while (e != exps);
   }
+  free(exps);
   Rf_protect(stmts);
   SEXP lbrace = Rf_install("{");
   SEXP body = Rf_protect(Rf_lcons(lbrace, stmts));
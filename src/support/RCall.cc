@@ -0,0 +1,55 @@
+// -*- Mode: C++ -*-
+//
+// Copyright (c) 2006 Rice University
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation; either version 2 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA 
+
+// File: RCall.cc
+//
+// Calls from the compiler into R that cannot longjmp over C++
+// frames.
+//
+// Author: John Garvin (garvin@cs.rice.edu)
+
+#include <support/RccError.h>
+
+#include "RCall.h"
+
+// arguments and result of an evaluation under R_ToplevelExec
+struct EvalCall {
+  SEXP e;
+  SEXP rho;
+  SEXP value;
+};
+
+static void eval_at_toplevel(void * data) {
+  EvalCall * c = static_cast<EvalCall *>(data);
+  c->value = Rf_eval(c->e, c->rho);
+}
+
+void rcc_call_R(void (*fun)(void *), void * data, const std::string & what) {
+  if (!R_ToplevelExec(fun, data)) {
+    rcc_error("R error in " + what);
+  }
+}
+
+SEXP rcc_eval(SEXP e, SEXP rho, const std::string & what) {
+  EvalCall c;
+  c.e = e;
+  c.rho = rho;
+  c.value = R_NilValue;
+  rcc_call_R(eval_at_toplevel, &c, what);
+  return c.value;
+}
@@ -0,0 +1,44 @@
+// -*- Mode: C++ -*-
+//
+// Copyright (c) 2006 Rice University
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation; either version 2 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA 
+
+// File: RCall.h
+//
+// Calls from the compiler into R that cannot longjmp over C++
+// frames. An R error in the call is caught where it is made and
+// turned into an rcc_error.
+//
+// Author: John Garvin (garvin@cs.rice.edu)
+
+#ifndef R_CALL_H
+#define R_CALL_H
+
+#include <string>
+
+#include <include/R/R_RInternals.h>
+
+/// Run fun(data) under R_ToplevelExec. If it signals an R error,
+/// R prints the message and the compilation ends with rcc_error,
+/// naming 'what'. fun must not own anything with a destructor or
+/// throw; the error jumps out of it.
+void rcc_call_R(void (*fun)(void *), void * data, const std::string & what);
+
+/// Evaluate e in rho. An R error ends the compilation as above.
+/// The result is unprotected.
+SEXP rcc_eval(SEXP e, SEXP rho, const std::string & what);
+
+#endif
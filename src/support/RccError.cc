@@ -27,11 +27,24 @@
 #include <iostream>
 #include <cstdlib>
 
+static bool exit_throws = false;
+
 void rcc_error(std::string message) {
   std::cerr << "Error: " << message << std::endl;
-  exit(1);
+  rcc_exit(1);
 }
 
 void rcc_warn(std::string message) {
   std::cerr << "Warning: " << message << std::endl;
 }
+
+void rcc_exit(int status) {
+  if (exit_throws) {
+    throw RccExit(status);
+  }
+  exit(status);
+}
+
+void set_rcc_exit_throws(bool x) {
+  exit_throws = x;
+}
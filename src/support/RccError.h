@@ -30,4 +30,18 @@
 void rcc_error(std::string message);
 void rcc_warn(std::string message);
 
+/// End the compilation with the given exit status. Normally exits
+/// the process; in the compile server, where one process runs many
+/// compilations, throws RccExit back to the server loop instead.
+void rcc_exit(int status);
+void set_rcc_exit_throws(bool x);
+
+class RccExit {
+public:
+  explicit RccExit(int status) : m_status(status) {}
+  int status() const { return m_status; }
+private:
+  int m_status;
+};
+
 #endif // RCC_ERROR_H
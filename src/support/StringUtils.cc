@@ -150,8 +150,11 @@ string i_to_s(const int i) {
 string d_to_s(double d) {
   if (d == HUGE_VAL) {
     return "HUGE_VAL";         // special R value
+  } else if (d == -HUGE_VAL) {
+    return "(-HUGE_VAL)";
   } else {
     ostringstream ss;
+    ss.precision(17);          // enough digits to round-trip a double
     ss << d;
     return ss.str();
   }
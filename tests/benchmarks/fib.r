@@ -0,0 +1,10 @@
+source(file.path(Sys.getenv("RCC_R_INCLUDE_PATH"), "well_behaved.r"))
+
+# Doubly recursive Fibonacci: closure call overhead.
+
+fib <- function(n) {
+  if (n < 2) return(1)
+  else return(fib(n - 1) + fib(n - 2))
+}
+
+fib(22)
@@ -0,0 +1,27 @@
+source(file.path(Sys.getenv("RCC_R_INCLUDE_PATH"), "well_behaved.r"))
+
+# Points of a grid inside the Mandelbrot set: while loops with
+# scalar arithmetic.
+
+mandelbrot <- function(n, max_iter) {
+  inside <- 0
+  for (py in 1:n) {
+    ci <- 2 * py / n - 1
+    for (px in 1:n) {
+      cr <- 2 * px / n - 1.5
+      zr <- 0
+      zi <- 0
+      k <- 0
+      while (k < max_iter && zr * zr + zi * zi <= 4) {
+        t <- zr * zr - zi * zi + cr
+        zi <- 2 * zr * zi + ci
+        zr <- t
+        k <- k + 1
+      }
+      if (k == max_iter) inside <- inside + 1
+    }
+  }
+  inside
+}
+
+mandelbrot(80, 50)
@@ -0,0 +1,41 @@
+source(file.path(Sys.getenv("RCC_R_INCLUDE_PATH"), "well_behaved.r"))
+
+# N-body simulation of five bodies: scalar arithmetic and vector
+# subscripts in nested loops.
+
+advance <- function(x, y, z, vx, vy, vz, mass, dt, steps) {
+  n <- length(mass)
+  for (s in 1:steps) {
+    for (i in 1:(n - 1)) {
+      for (j in (i + 1):n) {
+        dx <- x[i] - x[j]
+        dy <- y[i] - y[j]
+        dz <- z[i] - z[j]
+        d2 <- dx * dx + dy * dy + dz * dz
+        mag <- dt / (d2 * sqrt(d2))
+        vx[i] <- vx[i] - dx * mass[j] * mag
+        vy[i] <- vy[i] - dy * mass[j] * mag
+        vz[i] <- vz[i] - dz * mass[j] * mag
+        vx[j] <- vx[j] + dx * mass[i] * mag
+        vy[j] <- vy[j] + dy * mass[i] * mag
+        vz[j] <- vz[j] + dz * mass[i] * mag
+      }
+    }
+    for (i in 1:n) {
+      x[i] <- x[i] + dt * vx[i]
+      y[i] <- y[i] + dt * vy[i]
+      z[i] <- z[i] + dt * vz[i]
+    }
+  }
+  list(x = x, y = y, z = z)
+}
+
+mass <- c(39.47, 0.037, 0.011, 0.0017, 0.0020)
+x <- c(0, 4.84, 8.34, 12.89, 15.38)
+y <- c(0, -1.16, 4.12, -15.11, -25.92)
+z <- c(0, -0.10, -0.40, -0.22, 0.18)
+vx <- c(0, 0.61, -1.01, 1.08, 0.98)
+vy <- c(0, 2.81, 1.82, 0.87, 0.59)
+vz <- c(0, -0.02, 0.01, -0.01, -0.03)
+p <- advance(x, y, z, vx, vy, vz, mass, 0.01, 2000)
+print(round(p$x, 6))
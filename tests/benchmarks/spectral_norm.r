@@ -0,0 +1,30 @@
+source(file.path(Sys.getenv("RCC_R_INCLUDE_PATH"), "well_behaved.r"))
+
+# Spectral norm of an infinite matrix by power iteration: function
+# calls in the innermost loop.
+
+a <- function(i, j) 1 / ((i + j) * (i + j + 1) / 2 + i + 1)
+
+times_a <- function(u, n, transpose) {
+  v <- numeric(n)
+  for (i in 1:n) {
+    s <- 0
+    for (j in 1:n) {
+      if (transpose) s <- s + a(j - 1, i - 1) * u[j]
+      else s <- s + a(i - 1, j - 1) * u[j]
+    }
+    v[i] <- s
+  }
+  v
+}
+
+spectral_norm <- function(n) {
+  u <- rep(1, n)
+  for (k in 1:10) {
+    v <- times_a(times_a(u, n, FALSE), n, TRUE)
+    u <- times_a(times_a(v, n, FALSE), n, TRUE)
+  }
+  sqrt(sum(u * v) / sum(v * v))
+}
+
+print(round(spectral_norm(60), 9))
@@ -0,0 +1,41 @@
+source(file.path(Sys.getenv("RCC_R_INCLUDE_PATH"), "well_behaved.r"))
+
+# && and || as values, for their effects, and on operands that are
+# not logical scalars
+
+calls <- 0
+noisy <- function(x) {
+  calls <<- calls + 1
+  x
+}
+
+both <- function(a, b) a && noisy(b)
+either <- function(a, b) a || noisy(b)
+
+print(both(TRUE, FALSE))
+print(both(FALSE, TRUE))
+print(both(NA, FALSE))
+print(both(NA, TRUE))
+print(either(TRUE, FALSE))
+print(either(FALSE, NA))
+print(either(NA, TRUE))
+print(either(1, 0))
+print(both(c(TRUE, FALSE), 2 > 1))
+print(calls)
+
+f <- function(x) {
+  is.numeric(x) || noisy(FALSE)
+  if (!is.null(x) && length(x) > 1 && x[2] > 0) "positive second" else "other"
+}
+print(f(c(1, 2)))
+print(f(3))
+print(f(NULL))
+print(f("a"))
+print(calls)
+
+# a local && is an ordinary function
+mine <- function(a, b) {
+  "&&" <- function(x, y) "mine"
+  if (identical(a && b, "mine")) "local &&" else "base &&"
+}
+print(mine(TRUE, FALSE))
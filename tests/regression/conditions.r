@@ -0,0 +1,41 @@
+source(file.path(Sys.getenv("RCC_R_INCLUDE_PATH"), "well_behaved.r"))
+
+# conditions made of comparisons, &&, || and ! on scalars and on
+# other values
+
+count_down <- function(n) {
+  steps <- 0
+  while (n > 0.5 && !(n == 7)) {
+    n <- n - 1
+    steps <- steps + 1
+  }
+  steps
+}
+
+classify <- function(x, y) {
+  if (x < y || x == as.integer(10)) {
+    "small"
+  } else if ((x >= 2 * y) && !(y != 3)) {
+    "large"
+  } else {
+    "middle"
+  }
+}
+
+print(count_down(5))
+print(count_down(10))
+print(count_down(2.5))
+print(classify(1, 2))
+print(classify(as.integer(10), 2))
+print(classify(6, 3))
+print(classify(4, 3))
+print(classify(TRUE, 2))
+print(classify("b", "a"))
+print(if (NA > 1 || 2 > 1) "or" else "no")
+print(if (NA > 1 && 1 > 2) "and" else "no")
+i <- 0
+repeat {
+  i <- i + as.integer(1)
+  if (i >= 4 || i * 2 == 100) break
+}
+print(i)
@@ -0,0 +1,37 @@
+source(file.path(Sys.getenv("RCC_R_INCLUDE_PATH"), "well_behaved.r"))
+
+area <- function(r) {
+  circumference <- 2*pi*r
+  third <- 1/3
+  k <- c(1,2,3)[2]
+  n <- k + 1
+  if (n > 2) {
+    m <- n * 10
+  } else {
+    m <- 0
+  }
+  print(third)
+  print(m)
+  circumference * third * m
+}
+
+area(2)
+
+f <- function(flag) {
+  x <- 5
+  if (flag) x <- 7
+  x * 2
+}
+
+f(TRUE)
+f(FALSE)
+
+g <- function() {
+  i <- as.integer(1)
+  for (j in 1:3) {
+    i <- i + as.integer(1)
+  }
+  i
+}
+
+g()
@@ -0,0 +1,15 @@
+source(file.path(Sys.getenv("RCC_R_INCLUDE_PATH"), "well_behaved.r"))
+# rcc-flags: -fserialized-constants
+
+# Exercises the kinds of constants the pool holds: literal code,
+# tagged argument lists with missing defaults, strings with escapes,
+# NA, and scalars of each type.
+f <- function(x, y = as.integer(2), z) {
+  s <- "tab\there \"quoted\""
+  cat(s, "\n")
+  list(x + y, NA, TRUE, 1.5e-300, 2+3i, quote(a$b[[1]](c = d)))
+}
+
+f(1)
+body(f)
+formals(f)
@@ -0,0 +1,42 @@
+source(file.path(Sys.getenv("RCC_R_INCLUDE_PATH"), "well_behaved.r"))
+
+f <- function(a) {
+  unused <- 2 * 3
+  t <- a + 1
+  t <- a * 2
+  y <- c(1, 2, 3)
+  y[2] <- 10
+  if (FALSE) {
+    print("never")
+  }
+  if (TRUE) z <- t else z <- 0
+  y[2] + z
+}
+
+f(4)
+
+g <- function(a) {
+  w <- a
+  w <- 0
+  if (a > 1) w <- a
+  w
+}
+
+g(5)
+g(0)
+
+# dead stores whose right sides can fail are kept
+unbound <- function(k) {
+  y <- no_such_variable
+  k
+}
+element <- function(lst, k) {
+  z <- lst[[k]]
+  k
+}
+
+r <- try(unbound(1), silent = TRUE)
+print(inherits(r, "try-error"))
+print(element(list(1, 2), 2))
+r <- try(element(list(1, 2), 5), silent = TRUE)
+print(inherits(r, "try-error"))
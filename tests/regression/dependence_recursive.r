@@ -0,0 +1,27 @@
+source(file.path(Sys.getenv("RCC_R_INCLUDE_PATH"), "well_behaved.r"))
+
+# the assignment to the global happens in a mutually recursive pair
+# called from the callee's pre-debut code, so the argument still
+# depends on it
+
+count <- 0
+
+bump <- function(n) {
+  if (n > 0) {
+    count <<- count + 1
+    bump_again(n - 1)
+  }
+  n
+}
+
+bump_again <- function(n) {
+  bump(n)
+}
+
+foo <- function(a, n) {
+  bump(n)
+  print(a)
+}
+
+foo(count, 3)
+print(count)
@@ -0,0 +1,56 @@
+source(file.path(Sys.getenv("RCC_R_INCLUDE_PATH"), "well_behaved.r"))
+
+# index only read: one box is reused
+sum_sq <- function(v) {
+  s <- 0
+  for (x in v) {
+    if (x > 0) s <- s + x * x
+  }
+  s
+}
+sum_sq(c(1.5, -2, 3))
+sum_sq(1:10)
+sum_sq(numeric(0))
+
+# index kept: every element needs its own box
+keep <- function(v) {
+  l <- list()
+  k <- 1
+  for (x in v) {
+    l[[k]] <- x
+    y <- x
+    k <- k + 1
+  }
+  list(l, y)
+}
+keep(as.integer(c(4, 5, 6)))
+keep(c("a", "b"))
+
+# unary + gives back the index itself
+first_plus <- function(v) {
+  for (x in v) {
+    if (x == v[1]) y <- +x
+  }
+  y
+}
+first_plus(c(1, 2, 3))
+
+# index passed to a closure as a promise
+later <- function(v) {
+  f <- function(a) a
+  out <- numeric(0)
+  for (x in v) {
+    out <- c(out, f(x))
+  }
+  out
+}
+later(c(7, 8, 9))
+
+# the last value stays bound after the loop
+last <- function(v) {
+  for (x in v) {
+    n <- x + 1
+  }
+  x
+}
+last(c(TRUE, FALSE))
@@ -0,0 +1,22 @@
+source(file.path(Sys.getenv("RCC_R_INCLUDE_PATH"), "well_behaved.r"))
+# rcc-flags: -flazy-constants
+
+# Constants owned by procedures: quoted code, and the formals and
+# body of a closure defined inside another. Each procedure is called
+# twice so that its constants are used both when built and after.
+make_adder <- function(n) {
+  function(x, by = n) x + by
+}
+
+expr <- function() quote(a * (b + 1))
+
+never_called <- function() quote(unused(code))
+
+add2 <- make_adder(2)
+add2(1)
+add2(5)
+make_adder(3)(1)
+expr()
+expr()
+formals(add2)
+body(add2)
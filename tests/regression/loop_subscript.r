@@ -0,0 +1,46 @@
+source(file.path(Sys.getenv("RCC_R_INCLUDE_PATH"), "well_behaved.r"))
+
+f <- function(x, y) {
+  s <- 0
+  for (i in 1:length(x)) {
+    s <- s + x[i] * y[i]
+  }
+  s
+}
+
+f(c(1, 2, 3), c(4, 5, 6))
+f(1:4, 4:1)
+f(c(TRUE, FALSE), c(2, 3))
+f(c(a=1, b=2), c(3, 4))
+
+g <- function(n) {
+  v <- numeric(n)
+  v[1] <- 1
+  for (i in 2:n) {
+    v[i] <- v[i - 1] * 2
+  }
+  v
+}
+
+g(10)
+
+h <- function(x) {
+  for (i in length(x):1) {
+    x[i] <- x[i] + as.integer(1)
+  }
+  x
+}
+
+h(1:5)
+h(c(1.5, 2.5))
+
+k <- function(x) {
+  out <- 0
+  for (i in 0:3) {
+    out <- out + x[i + 1]
+  }
+  out
+}
+
+k(c(10, 20, 30, 40))
+k(c(10, 20))
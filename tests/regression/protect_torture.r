@@ -0,0 +1,37 @@
+source(file.path(Sys.getenv("RCC_R_INCLUDE_PATH"), "well_behaved.r"))
+# rcc-flags: -fprotect-elision
+
+# Runs code whose protections the planner rewrites with a collection
+# at every allocation, so a handle left unprotected is reclaimed
+# before it is used.
+
+gctorture(TRUE)
+
+pair <- function(a, b) list(first = a, second = b)
+swap <- function(p) pair(p$second, p$first)
+p <- swap(pair(c(1, 2, 3), "x"))
+print(p)
+
+acc <- NULL
+grow <- function(v, n) {
+  for (i in 1:n) v <- c(v, i * 2)
+  v
+}
+acc <- grow(acc, 10)
+print(acc)
+
+total <- 0
+bump <- function(k) {
+  total <<- total + k
+  total
+}
+for (k in 1:5) bump(k)
+print(total)
+
+nest <- function(x) if (x > 0) list(x, nest(x - 1)) else NULL
+print(nest(3))
+
+s <- paste("a", 1:3, sep = "")
+print(s)
+
+gctorture(FALSE)
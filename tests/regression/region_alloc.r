@@ -0,0 +1,29 @@
+source(file.path(Sys.getenv("RCC_R_INCLUDE_PATH"), "well_behaved.r"))
+# rcc-flags: -fregion-alloc
+
+# argument lists of calls to non-escaping procedures live in the
+# region allocator; they must survive collections while the call is
+# running and be released by returns and by errors
+
+add <- function(a, b) a + b
+sumto <- function(n) {
+  s <- 0
+  for (i in 1:n) s <- add(s, i)
+  s
+}
+print(sumto(5000))
+
+fact <- function(n) if (n <= 1) 1 else n * fact(n - 1)
+print(fact(20))
+
+collect <- function(x, y) {
+  gc()
+  x + y
+}
+print(collect(1, 2))
+
+fails <- function(x) if (x > 2) stop("too big") else x
+r <- try(fails(3), silent = TRUE)
+print(inherits(r, "try-error"))
+print(add(fails(1), fact(5)))
+print(sumto(100))
@@ -0,0 +1,49 @@
+source(file.path(Sys.getenv("RCC_R_INCLUDE_PATH"), "well_behaved.r"))
+
+# constant only if the dead branch is ignored
+dead_branch <- function() {
+  x <- 1
+  if (x > 2) {
+    x <- 10
+  }
+  y <- x + 1
+  print(y)
+  y * 2
+}
+
+dead_branch()
+
+# constant around the loop: the update is never executed
+loop_invariant <- function(n) {
+  a <- 3
+  for (i in 1:n) {
+    if (a != 3) a <- a + 1
+  }
+  a * 2
+}
+
+loop_invariant(4)
+
+# the same value on both paths
+both_paths <- function(flag) {
+  if (flag) {
+    k <- 4
+  } else {
+    k <- 2 * 2
+  }
+  k + 1
+}
+
+both_paths(TRUE)
+both_paths(FALSE)
+
+# not constant: changes in the loop
+counter <- function(n) {
+  s <- 0
+  while (s < n) {
+    s <- s + 1
+  }
+  s
+}
+
+counter(5)
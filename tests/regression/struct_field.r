@@ -0,0 +1,23 @@
+source(file.path(Sys.getenv("RCC_R_INCLUDE_PATH"), "well_behaved.r"))
+
+total <- function(items) {
+  s <- 0
+  for (i in 1:length(items)) {
+    s <- s + items[[i]]$price * items[[i]]$n
+  }
+  s
+}
+item <- function(price, n) list(name = "x", price = price, n = n)
+total(list(item(2, 3), item(1.5, 4), list(n = 2, price = 10)))
+
+cfg <- list(alpha = 1, beta = "b", gamma = NULL)
+cfg$alpha
+cfg$"beta"
+cfg$gam        # partial match
+cfg$delta      # no such field
+names(cfg)[1] <- "gamma"
+cfg$gamma
+
+"$.rec" <- function(x, name) paste("field", name)
+r <- structure(list(a = 1), class = "rec")
+r$a
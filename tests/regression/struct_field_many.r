@@ -0,0 +1,24 @@
+source(file.path(Sys.getenv("RCC_R_INCLUDE_PATH"), "well_behaved.r"))
+
+# Field cache misses, hits and invalidation, with more $ sites run
+# than the field cache table starts with (16), so the table grows
+# while the first site's cache is still in use.
+
+getp <- function(x) x$p
+a <- list(q = 1, p = 2)
+print(getp(a))             # miss
+print(getp(a))             # hit
+print(getp(list(p = 3)))   # another names vector
+
+# twenty more sites
+fill <- function(r) {
+  s <- r$a + r$a + r$a + r$a + r$a + r$a + r$a + r$a + r$a + r$a
+  s + r$a + r$a + r$a + r$a + r$a + r$a + r$a + r$a + r$a + r$a
+}
+print(fill(list(a = 1)))
+
+y <- list(p = "right", z = "wrong")
+print(y$z)
+print(getp(y))
+names(y) <- c("z", "p")    # same names, new order
+print(getp(y))
@@ -3,6 +3,8 @@
 # Gather allocation stats from memory debugging output. Set the
 # R_DUMP_STATS environment variable to produce debugging output on
 # stderr. Works for R-2.1.1rcc interpretation and RCC-compiled code.
+# Code compiled with -falloc-stats counts its own allocations on a
+# stock interpreter instead; see lib/rcc_stats.h.
 #
 # Option -s: print summary only, no call graph
 #